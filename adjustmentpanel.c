@@ -0,0 +1,173 @@
+/*******************************************************************************/
+/**
+@file adjustmentpanel.c
+*
+@brief Builds the adjustment panel without loading testadjustmentpanel.uir
+*
+The layout is compiled into the DLL. The controls are created in the order
+of their IDs in testadjustmentpanel.h, so the constants of the header stay
+valid for all other functions of the library.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <userint.h>
+
+#include "definitions.h"
+#include "testadjustmentpanel.h"
+
+/* LOCAL DEFINES **************************************************************/
+#define PANEL_TITLE     "CP-ITS - Adjustment Panel"
+#define PANEL_HEIGHT    230
+#define PANEL_WIDTH     420
+
+/* LOCAL TYPE DEFINITIONS *****************************************************/
+
+typedef struct
+{
+   int iCtrlId;        /* expected ID from testadjustmentpanel.h */
+   int iStyle;         /* CTRL_xxx                               */
+   int iTop;
+   int iLeft;
+   int iHeight;
+   int iWidth;
+   int iPointSize;     /* text size, 0 -> default                */
+} PANEL_CTRL_LAYOUT;
+
+/* LOCAL CONSTANT DEFINITIONS *************************************************/
+
+/* Sorted by control ID, see testadjustmentpanel.h */
+static const PANEL_CTRL_LAYOUT gPanelLayout[] =
+{
+   { ADJUSTMENT_INDICATOR,  CTRL_NUMERIC_FLAT_HSLIDE,     80,  20,  70, 380,  0 },
+   { ADJUSTMENT_OK,         CTRL_SQUARE_COMMAND_BUTTON,  185, 160,  30, 100,  0 },
+   { ADJUSTMENT_UNIT,       CTRL_TEXT_MSG,               155, 180,  20,  60, 14 },
+   { ADJUSTMENT_LL,         CTRL_TEXT_MSG,               155,  20,  20, 150,  0 },
+   { ADJUSTMENT_UL,         CTRL_TEXT_MSG,               155, 250,  20, 150,  0 },
+   { ADJUSTMENT_BACKGROUND, CTRL_TEXT_MSG,                 0,   0, PANEL_HEIGHT,
+                                                                  PANEL_WIDTH, 0 },
+   { ADJUSTMENT_TEXT,       CTRL_TEXT_MSG,                15,  20,  40, 380, 16 },
+   { ADJUSTMENT_TREND,      CTRL_TEXT_MSG,                57,  20,  20, 380,  0 }
+};
+
+#define PANEL_CTRL_COUNT   (sizeof(gPanelLayout) / sizeof(gPanelLayout[0]))
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+CreateAdjustmentPanel:  creates the adjustment panel in the calling thread
+ *
+@precondition       must be called by the thread running the user interface
+@postcondition      panel is created but not displayed
+ *
+@return             panel handle, or a negative value if a control could not
+                    be created or did not get the expected ID
+ *******************************************************************************/
+int CreateAdjustmentPanel(void)
+{
+   const PANEL_CTRL_LAYOUT *pLayout;
+   int iPanel;
+   int iCtrl;
+   unsigned int idx;
+
+   iPanel = NewPanel(0, PANEL_TITLE, VAL_AUTO_CENTER, VAL_AUTO_CENTER,
+      PANEL_HEIGHT, PANEL_WIDTH);
+   if (iPanel < 0)
+   {
+      return iPanel;
+   }
+
+   for (idx = 0; idx < PANEL_CTRL_COUNT; idx++)
+   {
+      pLayout = &gPanelLayout[idx];
+      iCtrl = NewCtrl(iPanel, pLayout->iStyle, "", pLayout->iTop,
+         pLayout->iLeft);
+      if (iCtrl != pLayout->iCtrlId)
+      {
+         DiscardPanel(iPanel);
+         return (iCtrl < 0) ? iCtrl : -1;
+      }
+      SetCtrlAttribute(iPanel, iCtrl, ATTR_HEIGHT, pLayout->iHeight);
+      SetCtrlAttribute(iPanel, iCtrl, ATTR_WIDTH, pLayout->iWidth);
+      if (pLayout->iPointSize > 0)
+      {
+         SetCtrlAttribute(iPanel, iCtrl, ATTR_TEXT_POINT_SIZE,
+            pLayout->iPointSize);
+      }
+      if (pLayout->iStyle == CTRL_TEXT_MSG)
+      {
+         SetCtrlAttribute(iPanel, iCtrl, ATTR_SIZE_TO_TEXT, 0);
+         SetCtrlAttribute(iPanel, iCtrl, ATTR_TEXT_JUSTIFY,
+            VAL_CENTER_JUSTIFIED);
+      }
+   }
+
+   /* the background is created after the other controls, move it behind */
+   SetCtrlAttribute(iPanel, ADJUSTMENT_BACKGROUND, ATTR_ZPLANE_POSITION,
+      PANEL_CTRL_COUNT - 1);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_BACKGROUND, ATTR_TEXT_BGCOLOR,
+      VAL_PANEL_GRAY);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_CTRL_MODE,
+      VAL_INDICATOR);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_SHOW_DIG_DISP, 1);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_OK, ATTR_LABEL_TEXT, "OK");
+   SetCtrlAttribute(iPanel, ADJUSTMENT_OK, ATTR_CALLBACK_FUNCTION_POINTER,
+      AdjustmentCallback);
+
+   return iPanel;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ConfigureAdjustmentPanel:  sets texts, limits and format of a new adjustment
+ *
+Used by the panel thread of the library and by the panel server, so both
+show the same panel for the same message.
+ *
+@precondition       must be called by the thread running the user interface
+ *******************************************************************************/
+void ConfigureAdjustmentPanel(int iPanel, const PANELIPC_DISPLAY_MESSAGE
+   *pMessage)
+{
+   const PANELIPC_COMMAND *pCommand = &pMessage->command;
+   const PANELIPC_DISPLAY_TEXT *pText = &pMessage->text;
+
+   SetCtrlVal(iPanel, ADJUSTMENT_TEXT, pText->cStepName);
+   SetCtrlVal(iPanel, ADJUSTMENT_LL, pText->cLowerLimit);
+   SetCtrlVal(iPanel, ADJUSTMENT_UL, pText->cUpperLimit);
+   SetCtrlVal(iPanel, ADJUSTMENT_UNIT, pText->cUnit);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_UL, ATTR_TEXT_BGCOLOR,
+      VAL_TRANSPARENT);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_LL, ATTR_TEXT_BGCOLOR,
+      VAL_TRANSPARENT);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_TEXT, ATTR_TEXT_BGCOLOR,
+      VAL_TRANSPARENT);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_UNIT, ATTR_TEXT_BGCOLOR,
+      VAL_TRANSPARENT);
+
+   SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_MIN_VALUE,
+      pCommand->dLowerLimit);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_MAX_VALUE,
+      pCommand->dUpperLimit);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_FILL_COLOR, VAL_BLACK);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_FILL_HOUSING_COLOR,
+      VAL_WHITE);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_FORMAT,
+      pCommand->lFormat);
+   if (pCommand->lPrecision >= 0)
+   {
+      SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_PRECISION,
+         pCommand->lPrecision);
+   }
+   SetCtrlAttribute(iPanel, ADJUSTMENT_OK, ATTR_LABEL_TEXT, pText->cButton);
+
+   if (pCommand->lFlags & PANELIPC_FLAG_DEMO)
+   {
+      SetCtrlVal(iPanel, ADJUSTMENT_TEXT, "Adjustment panel in demo mode");
+      SetCtrlAttribute(iPanel, ADJUSTMENT_OK, ATTR_LABEL_TEXT, "DEMO");
+   }
+}
@@ -0,0 +1,259 @@
+/*******************************************************************************/
+/**
+@file barrier.c
+*
+@brief Named groups of benches that wait for the buttons of all members
+*
+All fields of the groups are protected by gBarrierLock, the waiting is done
+by the caller on BARRIER.hDone.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <ansi_c.h>
+
+#include "barrier.h"
+
+/* LOCAL VARIABLES ************************************************************/
+static CRITICAL_SECTION gBarrierLock;
+static BARRIER gBarriers[BARRIER_MAX_GROUPS];
+static int giBarrierCount = 0;
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static void CheckCompleted(BARRIER *pBarrier);
+static int FindMember(const BARRIER *pBarrier, const void *pMember);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Barrier_Initialize:  called once by the first exported function
+ *******************************************************************************/
+void Barrier_Initialize(void)
+{
+   InitializeCriticalSection(&gBarrierLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Barrier_Close:  called when the DLL is unloaded
+ *******************************************************************************/
+void Barrier_Close(void)
+{
+   int idx;
+
+   for (idx = 0; idx < giBarrierCount; idx++)
+   {
+      CloseHandle(gBarriers[idx].hDone);
+   }
+   giBarrierCount = 0;
+   DeleteCriticalSection(&gBarrierLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Barrier_Find:  group of a name, created on first use
+ *
+@return             NULL if all groups are taken
+ *******************************************************************************/
+BARRIER *Barrier_Find(const char *pName)
+{
+   BARRIER *pBarrier = NULL;
+   int idx;
+
+   EnterCriticalSection(&gBarrierLock);
+   for (idx = 0; idx < giBarrierCount; idx++)
+   {
+      if (strncmp(gBarriers[idx].cName, pName, BARRIER_NAME_LENGTH - 1) == 0)
+      {
+         pBarrier = &gBarriers[idx];
+         break;
+      }
+   }
+   if ((pBarrier == NULL) && (giBarrierCount < BARRIER_MAX_GROUPS))
+   {
+      pBarrier = &gBarriers[giBarrierCount];
+      memset(pBarrier, 0, sizeof(BARRIER));
+      pBarrier->hDone = CreateEvent(NULL, TRUE, FALSE, NULL);
+      if (pBarrier->hDone == NULL)
+      {
+         pBarrier = NULL;
+      }
+      else
+      {
+         strncpy(pBarrier->cName, pName, BARRIER_NAME_LENGTH - 1);
+         giBarrierCount++;
+      }
+   }
+   LeaveCriticalSection(&gBarrierLock);
+   return pBarrier;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Barrier_Join:  adds the panel of a Display to the current round, starts the
+               next round if the current one is completed
+ *
+@param pMember:     bench of the panel
+@param lExpected:   members of the round, 1 .. BARRIER_MAX_MEMBERS; the first
+                    member of a round sets it
+@param plRound:     receives the round of the panel, for Barrier_Confirm and
+                    Barrier_Done
+ *
+@return             FALSE if the bench is already a member of the open round
+                    or the round has all its members
+ *******************************************************************************/
+int Barrier_Join(BARRIER *pBarrier, const void *pMember, long lExpected,
+   long *plRound)
+{
+   int iJoined = FALSE;
+
+   EnterCriticalSection(&gBarrierLock);
+   if (pBarrier->lCompleted == pBarrier->lRound)
+   {
+      pBarrier->lRound++;
+      pBarrier->lJoined = 0;
+      pBarrier->lConfirmed = 0;
+      /* waiters of the completed round check their round, not the event */
+      ResetEvent(pBarrier->hDone);
+   }
+   if (pBarrier->lJoined == 0)
+   {
+      pBarrier->lExpected = lExpected;
+   }
+   if ((FindMember(pBarrier, pMember) < 0)
+      && (pBarrier->lJoined < pBarrier->lExpected))
+   {
+      pBarrier->pMembers[pBarrier->lJoined++] = pMember;
+      *plRound = pBarrier->lRound;
+      iJoined = TRUE;
+   }
+   LeaveCriticalSection(&gBarrierLock);
+   return iJoined;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Barrier_Leave:  takes the panel of a failed Display out of its round again
+ *
+The bench can join the round with its next Display. A panel whose button has
+been counted stays a member.
+ *
+@param plConfirmed:   flag of the panel, set here so a late button is not
+                      counted
+ *******************************************************************************/
+void Barrier_Leave(BARRIER *pBarrier, long lRound, const void *pMember,
+   volatile LONG *plConfirmed)
+{
+   int idx;
+
+   if ((pBarrier == NULL) || InterlockedExchange((LONG *) plConfirmed, TRUE))
+   {
+      return ;
+   }
+   EnterCriticalSection(&gBarrierLock);
+   idx = FindMember(pBarrier, pMember);
+   if ((lRound == pBarrier->lRound) && (pBarrier->lCompleted != lRound)
+      && (idx >= 0))
+   {
+      pBarrier->lJoined--;
+      pBarrier->pMembers[idx] = pBarrier->pMembers[pBarrier->lJoined];
+   }
+   LeaveCriticalSection(&gBarrierLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Barrier_Confirm:  counts the button of a member once per panel
+ *
+@param pBarrier:      NULL -> no group
+@param plConfirmed:   flag of the panel, set by the first call
+ *******************************************************************************/
+void Barrier_Confirm(BARRIER *pBarrier, long lRound,
+   volatile LONG *plConfirmed)
+{
+   if ((pBarrier == NULL) || InterlockedExchange((LONG *) plConfirmed, TRUE))
+   {
+      return ;
+   }
+   EnterCriticalSection(&gBarrierLock);
+   if (lRound == pBarrier->lRound)
+   {
+      pBarrier->lConfirmed++;
+      CheckCompleted(pBarrier);
+   }
+   LeaveCriticalSection(&gBarrierLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Barrier_Done:  state of a round
+ *
+@param plConfirmed:  receives the buttons of the round
+@param plMembers:    receives the members of the round
+ *
+@return             TRUE if all members of the round have confirmed
+ *******************************************************************************/
+int Barrier_Done(BARRIER *pBarrier, long lRound, long *plConfirmed,
+   long *plMembers)
+{
+   int iDone;
+
+   EnterCriticalSection(&gBarrierLock);
+   iDone = (pBarrier->lCompleted >= lRound);
+   if (lRound == pBarrier->lRound)
+   {
+      *plMembers = pBarrier->lExpected;
+      *plConfirmed = pBarrier->lConfirmed;
+   }
+   else
+   {
+      /* a later round has taken the counters, the old one was complete */
+      *plMembers = pBarrier->lCompletedMembers;
+      *plConfirmed = pBarrier->lCompletedMembers;
+   }
+   LeaveCriticalSection(&gBarrierLock);
+   return iDone;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+CheckCompleted:  ends the current round with its last confirmation
+ *
+@precondition       gBarrierLock is held
+ *******************************************************************************/
+static void CheckCompleted(BARRIER *pBarrier)
+{
+   if ((pBarrier->lJoined > 0) && (pBarrier->lConfirmed >= pBarrier->lExpected))
+   {
+      pBarrier->lCompleted = pBarrier->lRound;
+      pBarrier->lCompletedMembers = pBarrier->lExpected;
+      SetEvent(pBarrier->hDone);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+FindMember:  index of a bench in the current round
+ *
+@return             -1 if the bench has not joined it
+@precondition       gBarrierLock is held
+ *******************************************************************************/
+static int FindMember(const BARRIER *pBarrier, const void *pMember)
+{
+   int idx;
+
+   for (idx = 0; idx < pBarrier->lJoined; idx++)
+   {
+      if (pBarrier->pMembers[idx] == pMember)
+      {
+         return idx;
+      }
+   }
+   return -1;
+}
@@ -0,0 +1,65 @@
+/*******************************************************************************/
+/**
+@file barrier.h
+*
+@brief Named groups of benches that wait for the buttons of all members
+*
+In the batch process model the sockets of one fixture set the same group
+name and the number of sockets with tsadj_SetAdjustmentGroup. Every Display
+joins the current round of the group, the button of the panel confirms it in
+AdjustmentCallback, and tsadj_WaitForAdjustmentGroup returns when all members
+of the round have confirmed. A round ends with its last confirmation, the
+next Display starts the next one. A bench is a member of a round once: its
+Display before the round is completed fails, so a socket cannot confirm for
+the others; WaitForAdjustmentGroup goes between its button and its next
+Display. The groups are kept for the lifetime of the process.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef BARRIER_H
+#define BARRIER_H
+
+/* INCLUDE FILES ***************************************************************/
+#include <windows.h>
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define BARRIER_MAX_GROUPS     16    /* group names per process             */
+#define BARRIER_NAME_LENGTH    64
+#define BARRIER_MAX_MEMBERS    32    /* members of a round                  */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+typedef struct
+{
+   char cName[BARRIER_NAME_LENGTH];
+   long lRound;          /* current round, 0 -> none yet                 */
+   long lCompleted;      /* last round all members have confirmed        */
+   long lExpected;       /* members of the current round, set by the first */
+   long lJoined;         /* members joined to the current round          */
+   const void *pMembers[BARRIER_MAX_MEMBERS]; /* benches of the round    */
+   long lConfirmed;      /* buttons of the current round                 */
+   long lCompletedMembers; /* members of round lCompleted                */
+   HANDLE hDone;         /* set when the current round is completed      */
+} BARRIER;
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+void Barrier_Initialize(void);
+void Barrier_Close(void);
+BARRIER *Barrier_Find(const char *pName);
+int  Barrier_Join(BARRIER *pBarrier, const void *pMember, long lExpected,
+        long *plRound);
+void Barrier_Leave(BARRIER *pBarrier, long lRound, const void *pMember,
+        volatile LONG *plConfirmed);
+void Barrier_Confirm(BARRIER *pBarrier, long lRound,
+        volatile LONG *plConfirmed);
+int  Barrier_Done(BARRIER *pBarrier, long lRound, long *plConfirmed,
+        long *plMembers);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
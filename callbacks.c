@@ -1,31 +1,47 @@
-#include "tsapicvi.h"
-#include <analysis.h>
-#include <ansi_c.h>
-#include "definitions.h"
-#include <userint.h>
-#include "testadjustmentpanel.h"
-#include "hrestim.h"
-
-typedef struct threadDataRec
-{
-   CAObjHandle execution;
-   CAObjHandle ThisContext;
-} ThreadData;
-
-//-------------------------------------------------------------------------
-
-int CVICALLBACK AdjustmentCallback (int panel, int control, int event,
-		void *callbackData, int eventData1, int eventData2)
-{
-   
-   ThreadData *threadData;
-   ERRORINFO pTSErrorInfo;
-   threadData = (ThreadData*)callbackData;
-   if (event == EVENT_COMMIT)
-   {
-	   TS_PropertySetValBoolean(threadData->ThisContext, &pTSErrorInfo,
-	      "Locals.AdjustmentPanelButtonHit", TS_PropOption_InsertIfMissing, VTRUE);
-   }
-   return 0;
-   
-}
+#include "tsapicvi.h"
+#include <analysis.h>
+#include <ansi_c.h>
+#include "definitions.h"
+#include <userint.h>
+#include "testadjustmentpanel.h"
+#include "hrestim.h"
+#include "metrics.h"
+
+//-------------------------------------------------------------------------
+
+int CVICALLBACK AdjustmentCallback (int panel, int control, int event,
+		void *callbackData, int eventData1, int eventData2)
+{
+   
+   ThreadData *threadData;
+   ERRORINFO pTSErrorInfo;
+   threadData = (ThreadData*)callbackData;
+   if (event == EVENT_COMMIT)
+   {
+	   threadData->dButtonTime = Metrics_TimeStamp();
+	   /* the waiting sockets go on without polling */
+	   Barrier_Confirm(threadData->pBarrier, threadData->lBarrierRound,
+	      &threadData->lBarrierConfirmed);
+	   /* the button message was fetched by this thread, GetTickCount units */
+	   if (eventData1 != ADJUSTMENT_SIMULATED_PRESS)
+	   {
+	      Metrics_ClickLatency((LONG)(GetTickCount() - (DWORD)GetMessageTime())
+	         / 1000.0);
+	   }
+	   /* no sequence context for a plain C caller */
+	   if (threadData->ThisContext)
+	   {
+	      TS_PropertySetValBoolean(threadData->ThisContext, &pTSErrorInfo,
+	         "Locals.AdjustmentPanelButtonHit", TS_PropOption_InsertIfMissing,
+	         VTRUE);
+	   }
+	   if (threadData->pButtonCallback != NULL)
+	   {
+	      threadData->pButtonCallback(threadData->lResourceId,
+	         threadData->pUserData);
+	   }
+	   Metrics_CallbackLatency(Metrics_TimeStamp() - threadData->dButtonTime);
+   }
+   return 0;
+   
+}
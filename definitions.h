@@ -1,13 +1,47 @@
-#ifndef TSADJ_DEF_H
-#define TSADJ_DEF_H
-
-
-
-#define WAITTMO 2000
-
-
-double gdStartTimeStamp;
-double gdStopTimeStamp;
-
-void FormatValues (char cValue[1024], char *cFormat, double dValue);
-#endif 
+#ifndef TSADJ_DEF_H
+#define TSADJ_DEF_H
+
+#include <windows.h>
+#include <cviauto.h>
+
+#include "panelipc.h"
+#include "panelqueue.h"
+#include "panelview.h"
+#include "barrier.h"
+#include "tsadjc.h"
+#include "metrics.h"
+
+#define WAITTMO 2000
+
+/* eventData1 of the button callback for a press of the simulated operator */
+#define ADJUSTMENT_SIMULATED_PRESS  1
+
+/* Panel thread of one resource, passed to the thread and the callback */
+typedef struct threadDataRec
+{
+   CAObjHandle ThisContext;    /* of a TestStand Display, 0 -> none    */
+   HANDLE hReady;              /* set when the panel is shown          */
+   int iPanel;                 /* panel handle, 0 -> no panel          */
+   volatile double dButtonTime; /* time stamp of the button, 0.0 -> none */
+   PANEL_QUEUE queue;          /* commands to the panel thread         */
+   TSADJC_BUTTON_CALLBACK pButtonCallback; /* NULL -> none              */
+   void *pUserData;            /* passed to pButtonCallback            */
+   long lResourceId;           /* passed to pButtonCallback            */
+   METRICS_LATENCY *pQueueDelay; /* in the counters of the bench       */
+   volatile LONG lPending;     /* PENDING_xxx                          */
+   int iPendingCount;          /* commands of the latest value before  */
+   PANEL_COMMAND pending[PANELVIEW_MAX_COMMANDS]; /* the panel is shown */
+   volatile double dShownTime; /* time stamp of the SHOW, 0.0 -> none  */
+   BARRIER *pBarrier;          /* group of the panel, NULL -> none     */
+   long lBarrierRound;         /* round of the panel in the group      */
+   volatile LONG lBarrierConfirmed; /* the button has been counted     */
+   volatile double dRedrawCost; /* s of the loop per shown value, mean */
+   volatile double dRedrawInterval; /* s between shown values, mean     */
+   volatile double dQueueLag;  /* s a command waits in the queue, mean */
+   volatile double dLastRedraw; /* time stamp of the last shown value  */
+} ThreadData;
+
+int CreateAdjustmentPanel(void);
+void ConfigureAdjustmentPanel(int iPanel, const PANELIPC_DISPLAY_MESSAGE
+   *pMessage);
+#endif 
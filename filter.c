@@ -0,0 +1,268 @@
+/*******************************************************************************/
+/**
+@file filter.c
+*
+@brief Smoothing of the values passed to tsadj_SetValueAdjustmentPanel
+*
+All filters work incrementally on the new value. EMA and MEAN need constant
+time per value; the sum of the MEAN filter is recalculated once per window
+so rounding errors cannot accumulate. MEDIAN keeps the window sorted and
+moves at most FILTER_MAX_WINDOW values per update.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <string.h>
+
+#include "filter.h"
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static double ApplyMean(FILTER *pFilter, double dValue);
+static double ApplyMedian(FILTER *pFilter, double dValue);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Filter_Configure:  sets type and window and empties the filter
+ *
+@param iType:      FILTER_xxx
+@param iWindow:    1 .. FILTER_MAX_WINDOW, EMA: alpha = 2 / (window + 1)
+ *
+@return            0, or -1 if type or window are not supported
+ *******************************************************************************/
+int Filter_Configure(FILTER *pFilter, int iType, int iWindow)
+{
+   if ((iType < FILTER_NONE) || (iType > FILTER_MEDIAN) || (iWindow < 1)
+      || (iWindow > FILTER_MAX_WINDOW))
+   {
+      return -1;
+   }
+   pFilter->iType = iType;
+   pFilter->iWindow = iWindow;
+   pFilter->dAlpha = 2.0 / (iWindow + 1);
+   Filter_Reset(pFilter);
+   return 0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Filter_Reset:  forgets all values, called for every displayed panel
+ *******************************************************************************/
+void Filter_Reset(FILTER *pFilter)
+{
+   pFilter->iCount = 0;
+   pFilter->iNext = 0;
+   pFilter->dState = 0.0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Filter_Apply:  adds one value
+ *
+@return        filtered value
+ *******************************************************************************/
+double Filter_Apply(FILTER *pFilter, double dValue)
+{
+   switch (pFilter->iType)
+   {
+      case FILTER_EMA:
+         if (pFilter->iCount == 0)
+         {
+            pFilter->iCount = 1;
+            pFilter->dState = dValue;
+         }
+         else
+         {
+            pFilter->dState += pFilter->dAlpha * (dValue - pFilter->dState);
+         }
+         return pFilter->dState;
+
+      case FILTER_MEAN:
+         return ApplyMean(pFilter, dValue);
+
+      case FILTER_MEDIAN:
+         return ApplyMedian(pFilter, dValue);
+
+      default:
+         return dValue;
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Filter_ApplyBurst:  adds several values in arrival order
+ *
+@param dValues:    values, the oldest first
+@param iCount:     number of values, at least 1
+ *
+@return            filtered value after the last one
+ *******************************************************************************/
+double Filter_ApplyBurst(FILTER *pFilter, const double dValues[], int iCount)
+{
+   double dState;
+   double dAlpha;
+   int idx;
+
+   if (pFilter->iType == FILTER_NONE)
+   {
+      return dValues[iCount - 1];
+   }
+   if (pFilter->iType != FILTER_EMA)
+   {
+      for (idx = 0; idx < iCount - 1; idx++)
+      {
+         Filter_Apply(pFilter, dValues[idx]);
+      }
+      return Filter_Apply(pFilter, dValues[iCount - 1]);
+   }
+
+   /* EMA: keep the state in locals for the whole burst */
+   idx = 0;
+   if (pFilter->iCount == 0)
+   {
+      pFilter->iCount = 1;
+      pFilter->dState = dValues[idx++];
+   }
+   dState = pFilter->dState;
+   dAlpha = pFilter->dAlpha;
+   for (; idx < iCount; idx++)
+   {
+      dState += dAlpha * (dValues[idx] - dState);
+   }
+   pFilter->dState = dState;
+   return dState;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Filter_ApplyReadings:  transforms and filters the readings of one SetValue
+                       call
+ *
+Called by PanelView_SetValue, also for tools/tsadjreplay.c.
+ *
+@return                value to check and to show
+ *******************************************************************************/
+double Filter_ApplyReadings(FILTER *pFilter, const TRANSFORM *pTransform,
+   const double dValues[], long lCount)
+{
+   double dChunk[FILTER_TRANSFORM_CHUNK];
+   double dValue = 0.0;
+   long lDone;
+   int iChunk;
+   int idx;
+
+   if (lCount == 1)
+   {
+      return Filter_Apply(pFilter, Transform_Apply(pTransform, dValues[0]));
+   }
+   if (pTransform->iSteps == 0)
+   {
+      return Filter_ApplyBurst(pFilter, dValues, (int)lCount);
+   }
+   for (lDone = 0; lDone < lCount; lDone += iChunk)
+   {
+      iChunk = (lCount - lDone > FILTER_TRANSFORM_CHUNK)
+         ? FILTER_TRANSFORM_CHUNK : (int)(lCount - lDone);
+      for (idx = 0; idx < iChunk; idx++)
+      {
+         dChunk[idx] = Transform_Apply(pTransform, dValues[lDone + idx]);
+      }
+      dValue = Filter_ApplyBurst(pFilter, dChunk, iChunk);
+   }
+   return dValue;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+ApplyMean:  running sum over the ring
+ *******************************************************************************/
+static double ApplyMean(FILTER *pFilter, double dValue)
+{
+   int idx;
+
+   if (pFilter->iCount == pFilter->iWindow)
+   {
+      pFilter->dState -= pFilter->dRing[pFilter->iNext];
+   }
+   else
+   {
+      pFilter->iCount++;
+   }
+   pFilter->dRing[pFilter->iNext] = dValue;
+   pFilter->dState += dValue;
+   if (++pFilter->iNext == pFilter->iWindow)
+   {
+      pFilter->iNext = 0;
+      /* once per window: drop the rounding errors of the running sum */
+      pFilter->dState = 0.0;
+      for (idx = 0; idx < pFilter->iCount; idx++)
+      {
+         pFilter->dState += pFilter->dRing[idx];
+      }
+   }
+   return pFilter->dState / pFilter->iCount;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ApplyMedian:  replaces the oldest value in the sorted window
+ *******************************************************************************/
+static double ApplyMedian(FILTER *pFilter, double dValue)
+{
+   double *pSorted = pFilter->dSorted;
+   int iLow;
+   int iHigh;
+   int iMiddle;
+   int idx;
+
+   if (pFilter->iCount == pFilter->iWindow)
+   {
+      /* remove the oldest value */
+      for (idx = 0; (idx < pFilter->iCount - 1)
+         && (pSorted[idx] != pFilter->dRing[pFilter->iNext]); idx++)
+      {
+      }
+      memmove(&pSorted[idx], &pSorted[idx + 1], (pFilter->iCount - idx - 1)
+         * sizeof(double));
+      pFilter->iCount--;
+   }
+
+   /* insert behind all values <= dValue */
+   iLow = 0;
+   iHigh = pFilter->iCount;
+   while (iLow < iHigh)
+   {
+      iMiddle = (iLow + iHigh) / 2;
+      if (pSorted[iMiddle] <= dValue)
+      {
+         iLow = iMiddle + 1;
+      }
+      else
+      {
+         iHigh = iMiddle;
+      }
+   }
+   memmove(&pSorted[iLow + 1], &pSorted[iLow], (pFilter->iCount - iLow)
+      * sizeof(double));
+   pSorted[iLow] = dValue;
+   pFilter->iCount++;
+
+   pFilter->dRing[pFilter->iNext] = dValue;
+   if (++pFilter->iNext == pFilter->iWindow)
+   {
+      pFilter->iNext = 0;
+   }
+
+   if (pFilter->iCount & 1)
+   {
+      return pSorted[pFilter->iCount / 2];
+   }
+   return 0.5 * (pSorted[pFilter->iCount / 2 - 1]
+      + pSorted[pFilter->iCount / 2]);
+}
@@ -0,0 +1,56 @@
+/*******************************************************************************/
+/**
+@file filter.h
+*
+@brief Smoothing of the values passed to tsadj_SetValueAdjustmentPanel
+*
+A FILTER is part of the memory block of a resource, it never allocates.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef FILTER_H
+#define FILTER_H
+
+/* INCLUDE FILES ***************************************************************/
+#include "transform.h"
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define FILTER_MAX_WINDOW     64
+#define FILTER_TRANSFORM_CHUNK 64 /* burst values transformed at once     */
+
+/* Filter types */
+#define FILTER_NONE           0   /* values are passed unchanged          */
+#define FILTER_EMA            1   /* exponential moving average           */
+#define FILTER_MEAN           2   /* mean of the last window values       */
+#define FILTER_MEDIAN         3   /* median of the last window values     */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+typedef struct
+{
+   int iType;                          /* FILTER_xxx                     */
+   int iWindow;                        /* values taken into account      */
+   int iCount;                         /* values in the window           */
+   int iNext;                          /* ring position of the next value */
+   double dAlpha;                      /* EMA: 2 / (window + 1)          */
+   double dState;                      /* EMA: last output, MEAN: sum    */
+   double dRing[FILTER_MAX_WINDOW];    /* values in arrival order        */
+   double dSorted[FILTER_MAX_WINDOW];  /* MEDIAN: window values sorted   */
+} FILTER;
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+int  Filter_Configure(FILTER *pFilter, int iType, int iWindow);
+void Filter_Reset(FILTER *pFilter);
+double Filter_Apply(FILTER *pFilter, double dValue);
+double Filter_ApplyBurst(FILTER *pFilter, const double dValues[], int iCount);
+double Filter_ApplyReadings(FILTER *pFilter, const TRANSFORM *pTransform,
+   const double dValues[], long lCount);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
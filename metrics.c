@@ -0,0 +1,385 @@
+/*******************************************************************************/
+/**
+@file metrics.c
+*
+@brief Adjustment phase durations aggregated per step name
+*
+Durations are measured with the performance counter and collected in
+logarithmic histograms, one set of phases per step name. The table is
+shared by all resources of the process.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <windows.h>
+#include <ansi_c.h>
+#include <tsapicvi.h>
+#include <resmgr.h>
+
+#include "metrics.h"
+
+/* LOCAL TYPE DEFINITIONS *****************************************************/
+
+typedef struct
+{
+   char cStepName[METRICS_STEPNAME_LENGTH];
+   METRICS_PHASE phases[METRICS_PHASES];
+} METRICS_STEP;
+
+/* GLOBAL VARIABLES DEFINITION ************************************************/
+static CRITICAL_SECTION gMetricsLock;
+static METRICS_STEP gSteps[METRICS_MAX_STEPS];
+static int giStepCount = 0;
+static double gdTicksPerSecond = 0.0;
+static METRICS_GLOBAL_COUNTERS gGlobalCounters;
+
+static const char *gPhaseNames[METRICS_PHASES] =
+{
+   "Display", "Visible", "InLimit", "Confirm", "Hide"
+};
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static METRICS_STEP *FindStep(const char *pStepName, int iCreate);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_Initialize:  called once by the first exported function
+ *******************************************************************************/
+void Metrics_Initialize(void)
+{
+   LARGE_INTEGER liFrequency;
+
+   InitializeCriticalSection(&gMetricsLock);
+   QueryPerformanceFrequency(&liFrequency);
+   gdTicksPerSecond = (double)liFrequency.QuadPart;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_Close:  called when the DLL is unloaded, no panel thread is left
+ *******************************************************************************/
+void Metrics_Close(void)
+{
+   DeleteCriticalSection(&gMetricsLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_TimeStamp:  high resolution time stamp
+ *
+@return             seconds since system start
+ *******************************************************************************/
+double Metrics_TimeStamp(void)
+{
+   LARGE_INTEGER liCount;
+
+   QueryPerformanceCounter(&liCount);
+   return (double)liCount.QuadPart / gdTicksPerSecond;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_Add:  adds the duration of one phase to the histogram of a step
+ *
+@param pStepName:  name of the step
+@param iPhase:     METRICS_PHASE_xxx
+@param dSeconds:   duration, negative values are ignored
+ *******************************************************************************/
+void Metrics_Add(const char *pStepName, int iPhase, double dSeconds)
+{
+   METRICS_STEP *pStep;
+   METRICS_PHASE *pPhase;
+   double dLimit;
+   int iBucket;
+
+   if ((iPhase < 0) || (iPhase >= METRICS_PHASES) || (dSeconds < 0.0))
+   {
+      return;
+   }
+
+   /* bucket n: below 2^n ms */
+   dLimit = 0.001;
+   for (iBucket = 0; iBucket < METRICS_BUCKETS - 1; iBucket++)
+   {
+      if (dSeconds < dLimit)
+      {
+         break;
+      }
+      dLimit *= 2.0;
+   }
+
+   EnterCriticalSection(&gMetricsLock);
+   pStep = FindStep(pStepName, TRUE);
+   if (pStep != NULL)
+   {
+      pPhase = &pStep->phases[iPhase];
+      if ((pPhase->lCount == 0) || (dSeconds < pPhase->dMin))
+      {
+         pPhase->dMin = dSeconds;
+      }
+      if ((pPhase->lCount == 0) || (dSeconds > pPhase->dMax))
+      {
+         pPhase->dMax = dSeconds;
+      }
+      pPhase->lCount++;
+      pPhase->dSum += dSeconds;
+      pPhase->lBuckets[iBucket]++;
+   }
+   LeaveCriticalSection(&gMetricsLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_Get:  copies the phases of a step
+ *
+@param pStepName:  name of the step
+@param phases:     receives the phases, all zero if the step is unknown
+ *
+@return            1 if the step is known, 0 otherwise
+ *******************************************************************************/
+int Metrics_Get(const char *pStepName, METRICS_PHASE phases[METRICS_PHASES])
+{
+   METRICS_STEP *pStep;
+
+   EnterCriticalSection(&gMetricsLock);
+   pStep = FindStep(pStepName, FALSE);
+   if (pStep != NULL)
+   {
+      memcpy(phases, pStep->phases, sizeof(pStep->phases));
+   }
+   else
+   {
+      memset(phases, 0, METRICS_PHASES * sizeof(METRICS_PHASE));
+   }
+   LeaveCriticalSection(&gMetricsLock);
+
+   return pStep != NULL;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_PhaseName:  name of a phase as used in the statistics container
+ *******************************************************************************/
+const char *Metrics_PhaseName(int iPhase)
+{
+   return gPhaseNames[iPhase];
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_Trace:  writes count, mean, min and max of all steps and phases
+into the resource manager trace
+ *******************************************************************************/
+void Metrics_Trace(void)
+{
+   char cTraceBuffer[1024];
+   METRICS_PHASE *pPhase;
+   int idx;
+   int iPhase;
+
+   EnterCriticalSection(&gMetricsLock);
+   for (idx = 0; idx < giStepCount; idx++)
+   {
+      sprintf(cTraceBuffer, "Adjustment statistics of step \"%s\"",
+         gSteps[idx].cStepName);
+      RESMGR_Trace(cTraceBuffer);
+      for (iPhase = 0; iPhase < METRICS_PHASES; iPhase++)
+      {
+         pPhase = &gSteps[idx].phases[iPhase];
+         if (pPhase->lCount > 0)
+         {
+            sprintf(cTraceBuffer,
+               "  %-8s n=%ld mean=%.3f ms min=%.3f ms max=%.3f ms",
+               gPhaseNames[iPhase], pPhase->lCount,
+               1000.0 * pPhase->dSum / pPhase->lCount, 1000.0 * pPhase->dMin,
+               1000.0 * pPhase->dMax);
+            RESMGR_Trace(cTraceBuffer);
+         }
+      }
+   }
+   LeaveCriticalSection(&gMetricsLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_Latency:  adds one call duration to an accumulator
+ *
+Only the count is updated atomically. Sum, min and max are written by the
+single thread owning the accumulator, a snapshot may be one call behind.
+ *******************************************************************************/
+void Metrics_Latency(METRICS_LATENCY *pLatency, double dSeconds)
+{
+   if ((pLatency->lCount == 0) || (dSeconds < pLatency->dMin))
+   {
+      pLatency->dMin = dSeconds;
+   }
+   if ((pLatency->lCount == 0) || (dSeconds > pLatency->dMax))
+   {
+      pLatency->dMax = dSeconds;
+   }
+   pLatency->dSum += dSeconds;
+   InterlockedIncrement(&pLatency->lCount);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_SharedLatency:  adds one duration to an accumulator written by
+several threads or reset by another thread than its writer
+ *******************************************************************************/
+void Metrics_SharedLatency(METRICS_LATENCY *pLatency, double dSeconds)
+{
+   EnterCriticalSection(&gMetricsLock);
+   Metrics_Latency(pLatency, dSeconds);
+   LeaveCriticalSection(&gMetricsLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_GetCounters:  snapshot of the counters of a resource
+ *
+The queue delay is written by the panel thread with Metrics_SharedLatency,
+the lock keeps it consistent; all other counters belong to the calling
+execution.
+ *
+@param pCopy:    receives the counters
+@param iReset:   TRUE -> clear the counters after the snapshot
+ *******************************************************************************/
+void Metrics_GetCounters(METRICS_COUNTERS *pCounters, METRICS_COUNTERS *pCopy,
+   int iReset)
+{
+   EnterCriticalSection(&gMetricsLock);
+   memcpy(pCopy, pCounters, sizeof(METRICS_COUNTERS));
+   if (iReset)
+   {
+      memset(pCounters, 0, sizeof(METRICS_COUNTERS));
+   }
+   LeaveCriticalSection(&gMetricsLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_SetValueCall:  accounts one SetValue call of a resource
+ *******************************************************************************/
+void Metrics_SetValueCall(METRICS_COUNTERS *pCounters, double dStart,
+   double dEnd)
+{
+   if (pCounters->setValue.lCount == 0)
+   {
+      pCounters->dFirstSetValue = dStart;
+   }
+   pCounters->dLastSetValue = dStart;
+   Metrics_Latency(&pCounters->setValue, dEnd - dStart);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_CallRate:  mean SetValue calls per second between the first and
+the last call
+ *******************************************************************************/
+double Metrics_CallRate(const METRICS_COUNTERS *pCounters)
+{
+   double dSpan = pCounters->dLastSetValue - pCounters->dFirstSetValue;
+
+   if ((pCounters->setValue.lCount < 2) || (dSpan <= 0.0))
+   {
+      return 0.0;
+   }
+   return (pCounters->setValue.lCount - 1) / dSpan;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_CallbackLatency:  accounts one button callback, called by all
+panel threads
+ *******************************************************************************/
+void Metrics_CallbackLatency(double dSeconds)
+{
+   Metrics_SharedLatency(&gGlobalCounters.callback, dSeconds);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_ClickLatency:  accounts the delay of one button message until its
+callback, called by all panel threads
+ *******************************************************************************/
+void Metrics_ClickLatency(double dSeconds)
+{
+   Metrics_SharedLatency(&gGlobalCounters.click, dSeconds);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_ThreadCreated / Metrics_ThreadJoined:  panel thread life cycle
+ *******************************************************************************/
+void Metrics_ThreadCreated(void)
+{
+   /* locked, the reset of Metrics_GetGlobalCounters would lose a count */
+   EnterCriticalSection(&gMetricsLock);
+   gGlobalCounters.lThreadsCreated++;
+   LeaveCriticalSection(&gMetricsLock);
+}
+
+void Metrics_ThreadJoined(void)
+{
+   EnterCriticalSection(&gMetricsLock);
+   gGlobalCounters.lThreadsJoined++;
+   LeaveCriticalSection(&gMetricsLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Metrics_GetGlobalCounters:  snapshot of the process wide counters
+ *
+@param pGlobal:  receives the counters
+@param iReset:   TRUE -> clear the counters after the snapshot
+ *******************************************************************************/
+void Metrics_GetGlobalCounters(METRICS_GLOBAL_COUNTERS *pGlobal, int iReset)
+{
+   EnterCriticalSection(&gMetricsLock);
+   memcpy(pGlobal, &gGlobalCounters, sizeof(METRICS_GLOBAL_COUNTERS));
+   if (iReset)
+   {
+      memset(&gGlobalCounters, 0, sizeof(METRICS_GLOBAL_COUNTERS));
+   }
+   LeaveCriticalSection(&gMetricsLock);
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+FindStep:  looks up a step, lock must be held
+ *
+@param pStepName:  name of the step
+@param iCreate:    TRUE -> add the step if it is unknown
+ *
+@return            entry or NULL if unknown or the table is full
+ *******************************************************************************/
+static METRICS_STEP *FindStep(const char *pStepName, int iCreate)
+{
+   METRICS_STEP *pStep;
+   int idx;
+
+   for (idx = 0; idx < giStepCount; idx++)
+   {
+      if (strncmp(gSteps[idx].cStepName, pStepName,
+         METRICS_STEPNAME_LENGTH - 1) == 0)
+      {
+         return &gSteps[idx];
+      }
+   }
+   if (!iCreate || (giStepCount == METRICS_MAX_STEPS))
+   {
+      return NULL;
+   }
+
+   pStep = &gSteps[giStepCount++];
+   memset(pStep, 0, sizeof(METRICS_STEP));
+   strncpy(pStep->cStepName, pStepName, METRICS_STEPNAME_LENGTH - 1);
+   return pStep;
+}
@@ -0,0 +1,105 @@
+/*******************************************************************************/
+/**
+@file metrics.h
+*
+@brief Adjustment phase durations aggregated per step name
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef METRICS_H
+#define METRICS_H
+
+/* INCLUDE FILES ***************************************************************/
+#include <windows.h>
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define METRICS_MAX_STEPS        64    /* step names kept per process        */
+#define METRICS_STEPNAME_LENGTH  128
+#define METRICS_BUCKETS          20    /* bucket n counts durations below
+                                          2^n ms, the last one all others   */
+
+/* Phases of one adjustment */
+#define METRICS_PHASE_DISPLAY    0     /* tsadj_DisplayAdjustmentPanel call  */
+#define METRICS_PHASE_VISIBLE    1     /* Display call -> panel thread ready */
+#define METRICS_PHASE_IN_LIMIT   2     /* Display end -> first value in limit */
+#define METRICS_PHASE_CONFIRM    3     /* Display end -> button pressed      */
+#define METRICS_PHASE_HIDE       4     /* tsadj_HideAdjustmentPanel call     */
+#define METRICS_PHASES           5
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+typedef struct
+{
+   long lCount;
+   double dSum;                        /* seconds */
+   double dMin;
+   double dMax;
+   long lBuckets[METRICS_BUCKETS];
+} METRICS_PHASE;
+
+/* Call latency accumulator, written by Metrics_Latency from one thread or by
+   Metrics_SharedLatency from any thread */
+typedef struct
+{
+   volatile LONG lCount;
+   double dSum;                        /* seconds */
+   double dMin;
+   double dMax;
+} METRICS_LATENCY;
+
+/* Instrumentation counters of one resource */
+typedef struct
+{
+   METRICS_LATENCY display;            /* tsadj_DisplayAdjustmentPanel  */
+   METRICS_LATENCY setValue;           /* tsadj_SetValueAdjustmentPanel */
+   METRICS_LATENCY hide;               /* tsadj_HideAdjustmentPanel     */
+   METRICS_LATENCY lockWait;           /* EnterCriticalSection          */
+   METRICS_LATENCY queueDelay;         /* panel command queued -> executed,
+                                          shared with the panel thread   */
+   volatile LONG lUiCallsIssued;       /* CVI UI calls from SetValue,   */
+   volatile LONG lUiCallsSkipped;      /* UI updates left out,
+                                          both updated interlocked       */
+   double dFirstSetValue;              /* time stamps for the call rate */
+   double dLastSetValue;
+} METRICS_COUNTERS;
+
+/* Process wide instrumentation counters */
+typedef struct
+{
+   METRICS_LATENCY callback;           /* AdjustmentCallback            */
+   METRICS_LATENCY click;              /* button released -> callback   */
+   LONG lThreadsCreated;
+   LONG lThreadsJoined;
+} METRICS_GLOBAL_COUNTERS;
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+void Metrics_Initialize(void);
+void Metrics_Close(void);
+
+double Metrics_TimeStamp(void);
+void Metrics_Add(const char *pStepName, int iPhase, double dSeconds);
+int  Metrics_Get(const char *pStepName, METRICS_PHASE phases[METRICS_PHASES]);
+const char *Metrics_PhaseName(int iPhase);
+void Metrics_Trace(void);
+
+void Metrics_Latency(METRICS_LATENCY *pLatency, double dSeconds);
+void Metrics_SharedLatency(METRICS_LATENCY *pLatency, double dSeconds);
+void Metrics_GetCounters(METRICS_COUNTERS *pCounters, METRICS_COUNTERS *pCopy,
+   int iReset);
+void Metrics_SetValueCall(METRICS_COUNTERS *pCounters, double dStart,
+   double dEnd);
+double Metrics_CallRate(const METRICS_COUNTERS *pCounters);
+void Metrics_CallbackLatency(double dSeconds);
+void Metrics_ClickLatency(double dSeconds);
+void Metrics_ThreadCreated(void);
+void Metrics_ThreadJoined(void);
+void Metrics_GetGlobalCounters(METRICS_GLOBAL_COUNTERS *pGlobal, int iReset);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
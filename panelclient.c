@@ -0,0 +1,288 @@
+/*******************************************************************************/
+/**
+@file panelclient.c
+*
+@brief Library side of the connection to the adjustment panel server
+*
+Every resource with the "PanelServer" key enabled has its own pipe
+connection, so the server keeps one panel per connection. All operations
+are overlapped and limited to PANELIPC_TIMEOUT. A server that does not
+answer in time is treated as lost: the connection is closed and every
+following call fails without waiting again.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <windows.h>
+#include <ansi_c.h>
+
+#include "panelclient.h"
+
+/* LOCAL TYPE DEFINITIONS *****************************************************/
+
+struct panelClientRec
+{
+   HANDLE hPipe;       /* INVALID_HANDLE_VALUE after a failure */
+   HANDLE hEvent;      /* overlapped completion                */
+};
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static int Transact(PANEL_CLIENT *pClient, const void *pCommand,
+   DWORD dwCommandSize, PANELIPC_REPLY *pReply);
+static int WaitForIo(PANEL_CLIENT *pClient, OVERLAPPED *pOverlapped,
+   BOOL bStarted, DWORD *pdwTransferred);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+PanelClient_Connect:  opens a connection to the panel server
+ *
+@return               connection, NULL if the server is not running or speaks
+                      another protocol version
+ *******************************************************************************/
+PANEL_CLIENT *PanelClient_Connect(void)
+{
+   PANEL_CLIENT *pClient;
+   PANELIPC_COMMAND command;
+   PANELIPC_REPLY reply;
+   DWORD dwMode = PIPE_READMODE_MESSAGE;
+
+   if (!WaitNamedPipe(PANELIPC_PIPE_NAME, PANELIPC_TIMEOUT))
+   {
+      return NULL;
+   }
+
+   pClient = (PANEL_CLIENT *)calloc(1, sizeof(PANEL_CLIENT));
+   if (pClient == NULL)
+   {
+      return NULL;
+   }
+   pClient->hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+   pClient->hPipe = CreateFile(PANELIPC_PIPE_NAME, GENERIC_READ |
+      GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
+   if ((pClient->hEvent == NULL) || (pClient->hPipe == INVALID_HANDLE_VALUE)
+      || !SetNamedPipeHandleState(pClient->hPipe, &dwMode, NULL, NULL))
+   {
+      PanelClient_Disconnect(pClient);
+      return NULL;
+   }
+
+   memset(&command, 0, sizeof(command));
+   command.lCommand = PANELIPC_CMD_HELLO;
+   command.dValue = PANELIPC_VERSION;
+   if (!Transact(pClient, &command, sizeof(command), &reply)
+      || (reply.lStatus != PANELIPC_STATUS_OK))
+   {
+      PanelClient_Disconnect(pClient);
+      return NULL;
+   }
+
+   return pClient;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelClient_Disconnect:  closes the connection, the server discards the panel
+ *******************************************************************************/
+void PanelClient_Disconnect(PANEL_CLIENT *pClient)
+{
+   if (pClient == NULL)
+   {
+      return;
+   }
+   if (pClient->hPipe != INVALID_HANDLE_VALUE)
+   {
+      CloseHandle(pClient->hPipe);
+   }
+   if (pClient->hEvent != NULL)
+   {
+      CloseHandle(pClient->hEvent);
+   }
+   free(pClient);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelClient_Display:  shows the panel of a new adjustment
+ *
+@return               TRUE if the server shows the panel
+ *******************************************************************************/
+int PanelClient_Display(PANEL_CLIENT *pClient, const PANELIPC_DISPLAY_TEXT
+   *pText, double dLowerLimit, double dUpperLimit, int iFormat,
+   int iPrecision, int iDemoMode)
+{
+   PANELIPC_DISPLAY_MESSAGE message;
+   PANELIPC_REPLY reply;
+
+   memset(&message.command, 0, sizeof(message.command));
+   message.command.lCommand = PANELIPC_CMD_DISPLAY;
+   message.command.lFlags = iDemoMode ? PANELIPC_FLAG_DEMO : 0;
+   message.command.dLowerLimit = dLowerLimit;
+   message.command.dUpperLimit = dUpperLimit;
+   message.command.lFormat = iFormat;
+   message.command.lPrecision = iPrecision;
+   memcpy(&message.text, pText, sizeof(message.text));
+
+   return Transact(pClient, &message, sizeof(message), &reply)
+      && (reply.lStatus == PANELIPC_STATUS_OK);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelClient_SetValue:  shows a value
+ *
+The value is sent even without commands, the reply reports the button.
+ *
+@param pCommands:     commands of PanelView_Update, iCount of them
+@param piButtonHit:   receives 1 if the button has been pressed
+ *
+@return               TRUE if the server answered
+ *******************************************************************************/
+int PanelClient_SetValue(PANEL_CLIENT *pClient, double dValue,
+   const PANEL_COMMAND *pCommands, int iCount, int *piButtonHit)
+{
+   PANELIPC_SETVALUE_MESSAGE message;
+   PANELIPC_VIEW_COMMAND *pView;
+   PANELIPC_REPLY reply;
+   int idx;
+
+   memset(&message, 0, sizeof(message));
+   message.command.lCommand = PANELIPC_CMD_SETVALUE;
+   message.command.dValue = dValue;
+   if (iCount > PANELIPC_VIEW_COMMANDS)
+   {
+      iCount = PANELIPC_VIEW_COMMANDS;
+   }
+   for (idx = 0; idx < iCount; idx++)
+   {
+      pView = &message.view[idx];
+      pView->lCommand = pCommands[idx].iCommand;
+      pView->lCtrl = pCommands[idx].iCtrl;
+      pView->lAttribute = pCommands[idx].iAttribute;
+      pView->lValue = pCommands[idx].iValue;
+      pView->dValue = pCommands[idx].dValue;
+      pView->dMaximum = pCommands[idx].dMaximum;
+      if (pCommands[idx].iCommand == PANELQUEUE_CMD_TEXT)
+      {
+         strncpy(pView->cText, pCommands[idx].data.cText,
+            PANELIPC_TEXT_LENGTH - 1);
+      }
+   }
+   message.lCount = iCount;
+
+   *piButtonHit = FALSE;
+   if (!Transact(pClient, &message, sizeof(message), &reply))
+   {
+      return FALSE;
+   }
+   *piButtonHit = reply.lButtonHit;
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelClient_Hide:  removes the panel
+ *
+@param piButtonHit:   receives 1 if the button has been pressed
+ *
+@return               TRUE if the server answered
+ *******************************************************************************/
+int PanelClient_Hide(PANEL_CLIENT *pClient, int *piButtonHit)
+{
+   PANELIPC_COMMAND command;
+   PANELIPC_REPLY reply;
+
+   memset(&command, 0, sizeof(command));
+   command.lCommand = PANELIPC_CMD_HIDE;
+
+   *piButtonHit = FALSE;
+   if (!Transact(pClient, &command, sizeof(command), &reply))
+   {
+      return FALSE;
+   }
+   *piButtonHit = reply.lButtonHit;
+   return TRUE;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Transact:  sends one command and reads the reply
+ *
+@return    TRUE on success, FALSE closes the connection
+ *******************************************************************************/
+static int Transact(PANEL_CLIENT *pClient, const void *pCommand,
+   DWORD dwCommandSize, PANELIPC_REPLY *pReply)
+{
+   OVERLAPPED overlapped;
+   DWORD dwTransferred = 0;
+   BOOL bStarted;
+
+   if ((pClient == NULL) || (pClient->hPipe == INVALID_HANDLE_VALUE))
+   {
+      return FALSE;
+   }
+
+   memset(&overlapped, 0, sizeof(overlapped));
+   overlapped.hEvent = pClient->hEvent;
+   ResetEvent(pClient->hEvent);
+   bStarted = WriteFile(pClient->hPipe, pCommand, dwCommandSize, NULL,
+      &overlapped);
+   if (!WaitForIo(pClient, &overlapped, bStarted, &dwTransferred)
+      || (dwTransferred != dwCommandSize))
+   {
+      return FALSE;
+   }
+
+   memset(&overlapped, 0, sizeof(overlapped));
+   overlapped.hEvent = pClient->hEvent;
+   ResetEvent(pClient->hEvent);
+   bStarted = ReadFile(pClient->hPipe, pReply, sizeof(PANELIPC_REPLY), NULL,
+      &overlapped);
+   if (!WaitForIo(pClient, &overlapped, bStarted, &dwTransferred)
+      || (dwTransferred != sizeof(PANELIPC_REPLY)))
+   {
+      return FALSE;
+   }
+
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+WaitForIo:  completes an overlapped operation within PANELIPC_TIMEOUT
+ *
+@return     TRUE on success, on failure the pipe is closed
+ *******************************************************************************/
+static int WaitForIo(PANEL_CLIENT *pClient, OVERLAPPED *pOverlapped,
+   BOOL bStarted, DWORD *pdwTransferred)
+{
+   if (!bStarted && (GetLastError() != ERROR_IO_PENDING))
+   {
+      CloseHandle(pClient->hPipe);
+      pClient->hPipe = INVALID_HANDLE_VALUE;
+      return FALSE;
+   }
+   if (WaitForSingleObject(pOverlapped->hEvent, PANELIPC_TIMEOUT)
+      != WAIT_OBJECT_0)
+   {
+      CancelIo(pClient->hPipe);
+      GetOverlappedResult(pClient->hPipe, pOverlapped, pdwTransferred, TRUE);
+      CloseHandle(pClient->hPipe);
+      pClient->hPipe = INVALID_HANDLE_VALUE;
+      return FALSE;
+   }
+   if (!GetOverlappedResult(pClient->hPipe, pOverlapped, pdwTransferred,
+      FALSE))
+   {
+      CloseHandle(pClient->hPipe);
+      pClient->hPipe = INVALID_HANDLE_VALUE;
+      return FALSE;
+   }
+   return TRUE;
+}
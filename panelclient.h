@@ -0,0 +1,38 @@
+/*******************************************************************************/
+/**
+@file panelclient.h
+*
+@brief Library side of the connection to the adjustment panel server
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef PANELCLIENT_H
+#define PANELCLIENT_H
+
+/* INCLUDE FILES ***************************************************************/
+#include <windows.h>
+
+#include "panelipc.h"
+#include "panelqueue.h"
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+typedef struct panelClientRec PANEL_CLIENT;
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+PANEL_CLIENT *PanelClient_Connect(void);
+void PanelClient_Disconnect(PANEL_CLIENT *pClient);
+int  PanelClient_Display(PANEL_CLIENT *pClient, const PANELIPC_DISPLAY_TEXT
+   *pText, double dLowerLimit, double dUpperLimit, int iFormat,
+   int iPrecision, int iDemoMode);
+int  PanelClient_SetValue(PANEL_CLIENT *pClient, double dValue,
+   const PANEL_COMMAND *pCommands, int iCount, int *piButtonHit);
+int  PanelClient_Hide(PANEL_CLIENT *pClient, int *piButtonHit);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
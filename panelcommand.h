@@ -0,0 +1,58 @@
+/*******************************************************************************/
+/**
+@file panelcommand.h
+*
+@brief One command to the adjustment panel
+*
+A PANEL_VIEW decides the commands of a value, the library puts them into the
+PANEL_QUEUE of a local panel or sends them to the panel server. The header
+needs neither the CVI nor the Windows headers, so tools/tsadjreplay.c prints
+the commands without a panel.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef PANELCOMMAND_H
+#define PANELCOMMAND_H
+
+/* INCLUDE FILES ***************************************************************/
+#include "panelipc.h"
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define PANELQUEUE_TEXT_LENGTH  64
+
+/* Commands */
+#define PANELQUEUE_CMD_CONFIGURE  1   /* texts, limits and format            */
+#define PANELQUEUE_CMD_SHOW       2   /* display the panel                   */
+#define PANELQUEUE_CMD_HIDE       3   /* hide the panel                      */
+#define PANELQUEUE_CMD_VALUE      4   /* numeric value of a control          */
+#define PANELQUEUE_CMD_TEXT       5   /* text of a control                   */
+#define PANELQUEUE_CMD_ATTRIBUTE  6   /* integer attribute of a control      */
+#define PANELQUEUE_CMD_SCALE      7   /* range of the indicator              */
+#define PANELQUEUE_CMD_QUIT       8   /* leave the message loop              */
+#define PANELQUEUE_CMD_PRESS      9   /* simulated operator presses the button */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+typedef struct
+{
+   int iCommand;                       /* PANELQUEUE_CMD_xxx             */
+   int iCtrl;                          /* VALUE, TEXT, ATTRIBUTE         */
+   int iAttribute;                     /* ATTRIBUTE: ATTR_xxx            */
+   int iValue;                         /* ATTRIBUTE                      */
+   double dValue;                      /* VALUE, SCALE: minimum          */
+   double dMaximum;                    /* SCALE                          */
+   double dQueued;                     /* set by the push, Metrics_TimeStamp */
+   union
+   {
+      char cText[PANELQUEUE_TEXT_LENGTH];  /* TEXT                       */
+      PANELIPC_DISPLAY_MESSAGE display;    /* CONFIGURE, as for the server */
+   } data;
+} PANEL_COMMAND;
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
@@ -0,0 +1,120 @@
+/*******************************************************************************/
+/**
+@file panelipc.h
+*
+@brief Messages between the adjustment library and the panel server
+*
+A resource with the "PanelServer" key enabled does not create the adjustment
+panel in the TestStand process. It opens a connection to the named pipe of
+tools/tsadjpanelsrv.c instead and sends one PANELIPC_COMMAND per call of the
+library, the server answers each command with one PANELIPC_REPLY. The pipe
+works in message mode, a DISPLAY command carries PANELIPC_DISPLAY_TEXT behind
+the command in the same message, a SETVALUE command the panel commands of the
+PANEL_VIEW of the resource. All texts, ranges and colours are decided by the
+library, so hysteresis, auto zoom and trend look the same as with a panel in
+the TestStand process; the server only sets them.
+The integer fields are long, 32 bits on Windows like LONG, so the header
+also builds without the Windows headers.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef PANELIPC_H
+#define PANELIPC_H
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define PANELIPC_PIPE_NAME       "\\\\.\\pipe\\tsadj_panel"
+#define PANELIPC_VERSION         2
+#define PANELIPC_TIMEOUT         2000  /* ms per command, server hang -> error */
+
+/* Commands */
+#define PANELIPC_CMD_HELLO       1     /* check the protocol version         */
+#define PANELIPC_CMD_DISPLAY     2     /* create and show the panel          */
+#define PANELIPC_CMD_SETVALUE    3     /* show a value, with view commands   */
+#define PANELIPC_CMD_HIDE        4     /* discard the panel                  */
+
+/* Command flags */
+#define PANELIPC_FLAG_DEMO       0x1   /* bench runs in demo mode            */
+
+/* Reply status */
+#define PANELIPC_STATUS_OK       0
+#define PANELIPC_STATUS_FAILED   1     /* panel could not be created         */
+#define PANELIPC_STATUS_VERSION  2     /* unsupported protocol version       */
+
+#define PANELIPC_STEPNAME_LENGTH 128
+#define PANELIPC_LIMIT_LENGTH    64
+#define PANELIPC_UNIT_LENGTH     32
+#define PANELIPC_BUTTON_LENGTH   16
+#define PANELIPC_TEXT_LENGTH     64
+#define PANELIPC_VIEW_COMMANDS   4     /* PANELVIEW_MAX_COMMANDS             */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+/* 40 bytes, sent for every command */
+typedef struct
+{
+   long lCommand;      /* PANELIPC_CMD_xxx                       */
+   long lFlags;        /* PANELIPC_FLAG_xxx                      */
+   double dValue;      /* SETVALUE: value, HELLO: version        */
+   double dLowerLimit; /* DISPLAY only                           */
+   double dUpperLimit;
+   long lFormat;       /* DISPLAY: VAL_xxx_FORMAT of the slider  */
+   long lPrecision;    /* DISPLAY: digits, -1 -> keep default    */
+} PANELIPC_COMMAND;
+
+/* Texts of the panel, behind a DISPLAY command */
+typedef struct
+{
+   char cStepName[PANELIPC_STEPNAME_LENGTH];
+   char cLowerLimit[PANELIPC_LIMIT_LENGTH];   /* "LL: <value> <unit>" */
+   char cUpperLimit[PANELIPC_LIMIT_LENGTH];   /* "UL: <value> <unit>" */
+   char cUnit[PANELIPC_UNIT_LENGTH];
+   char cButton[PANELIPC_BUTTON_LENGTH];
+} PANELIPC_DISPLAY_TEXT;
+
+typedef struct
+{
+   PANELIPC_COMMAND command;
+   PANELIPC_DISPLAY_TEXT text;
+} PANELIPC_DISPLAY_MESSAGE;
+
+/* One command of the panel view, the fields of a PANEL_COMMAND */
+typedef struct
+{
+   long lCommand;      /* PANELQUEUE_CMD_VALUE .. _SCALE          */
+   long lCtrl;
+   long lAttribute;
+   long lValue;
+   double dValue;
+   double dMaximum;
+   char cText[PANELIPC_TEXT_LENGTH];
+} PANELIPC_VIEW_COMMAND;
+
+typedef struct
+{
+   PANELIPC_COMMAND command;
+   long lCount;        /* view commands, 0 -> the panel is up to date */
+   long lReserved;
+   PANELIPC_VIEW_COMMAND view[PANELIPC_VIEW_COMMANDS];
+} PANELIPC_SETVALUE_MESSAGE;
+
+/* Receive buffer of the server, large enough for every command */
+typedef union
+{
+   PANELIPC_COMMAND command;
+   PANELIPC_DISPLAY_MESSAGE display;
+   PANELIPC_SETVALUE_MESSAGE setValue;
+} PANELIPC_MESSAGE;
+
+typedef struct
+{
+   long lStatus;       /* PANELIPC_STATUS_xxx                    */
+   long lButtonHit;    /* 1 -> button pressed since DISPLAY      */
+} PANELIPC_REPLY;
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
@@ -0,0 +1,253 @@
+/*******************************************************************************/
+/**
+@file panelqueue.c
+*
+@brief Commands of the library threads to the thread of a local panel
+*
+Bounded ring with one sequence number per cell: a producer reserves a
+position with one compare-exchange and publishes the command by advancing
+the sequence of its cell, the panel thread is the only consumer. A full
+queue is reported to the producer instead of blocking it.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <ansi_c.h>
+
+#include "panelqueue.h"
+#include "metrics.h"
+
+/* LOCAL DEFINES **************************************************************/
+#define PANELQUEUE_MASK   (PANELQUEUE_SIZE - 1)
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static LONG Distance(LONG lSequence, LONG lPosition);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_Initialize:  creates the wake event and empties the queue
+ *
+@return                 TRUE on success
+ *******************************************************************************/
+int PanelQueue_Initialize(PANEL_QUEUE *pQueue)
+{
+   pQueue->hWake = CreateEvent(NULL, FALSE, FALSE, NULL);
+   PanelQueue_Reset(pQueue);
+   return pQueue->hWake != NULL;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_Reset:  drops all commands
+ *
+@precondition       no panel thread is running
+ *******************************************************************************/
+void PanelQueue_Reset(PANEL_QUEUE *pQueue)
+{
+   int idx;
+
+   for (idx = 0; idx < PANELQUEUE_SIZE; idx++)
+   {
+      pQueue->cells[idx].lSequence = idx;
+   }
+   pQueue->lEnqueue = 0;
+   pQueue->lDequeue = 0;
+   if (pQueue->hWake != NULL)
+   {
+      ResetEvent(pQueue->hWake);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_Close:  closes the wake event
+ *******************************************************************************/
+void PanelQueue_Close(PANEL_QUEUE *pQueue)
+{
+   if (pQueue->hWake != NULL)
+   {
+      CloseHandle(pQueue->hWake);
+      pQueue->hWake = NULL;
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_Push:  puts a command behind all others and wakes the panel thread
+ *
+@return           FALSE if the queue is full
+ *******************************************************************************/
+int PanelQueue_Push(PANEL_QUEUE *pQueue, const PANEL_COMMAND *pCommand)
+{
+   PANEL_CELL *pCell;
+   LONG lPosition;
+   LONG lDistance;
+
+   for (;;)
+   {
+      lPosition = pQueue->lEnqueue;
+      pCell = &pQueue->cells[lPosition & PANELQUEUE_MASK];
+      lDistance = Distance(pCell->lSequence, lPosition);
+      if (lDistance < 0)
+      {
+         /* the consumer has not executed the command of the last round */
+         return FALSE;
+      }
+      if ((lDistance == 0) && (InterlockedCompareExchange(&pQueue->lEnqueue,
+         lPosition + 1, lPosition) == lPosition))
+      {
+         break;
+      }
+      /* another producer got the position, try the next one */
+   }
+
+   memcpy(&pCell->command, pCommand, sizeof(PANEL_COMMAND));
+   pCell->command.dQueued = Metrics_TimeStamp();
+   InterlockedExchange(&pCell->lSequence, lPosition + 1);
+   SetEvent(pQueue->hWake);
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_PushWait:  PanelQueue_Push for commands that must not get lost
+ *
+@param dwTimeout:     ms to wait for a free cell
+@param hAbort:        ends the wait when set, NULL -> none
+ *
+@return               FALSE if the queue stayed full or hAbort was set
+ *******************************************************************************/
+int PanelQueue_PushWait(PANEL_QUEUE *pQueue, const PANEL_COMMAND *pCommand,
+   DWORD dwTimeout, HANDLE hAbort)
+{
+   DWORD dwStart = GetTickCount();
+
+   while (!PanelQueue_Push(pQueue, pCommand))
+   {
+      if (GetTickCount() - dwStart >= dwTimeout)
+      {
+         return FALSE;
+      }
+      if (hAbort == NULL)
+      {
+         Sleep(1);
+      }
+      else if (WaitForSingleObject(hAbort, 1) != WAIT_TIMEOUT)
+      {
+         return FALSE;
+      }
+   }
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_Pop:  takes the oldest command, panel thread only
+ *
+@return          FALSE if the queue is empty
+ *******************************************************************************/
+int PanelQueue_Pop(PANEL_QUEUE *pQueue, PANEL_COMMAND *pCommand)
+{
+   PANEL_CELL *pCell = &pQueue->cells[pQueue->lDequeue & PANELQUEUE_MASK];
+
+   if (Distance(pCell->lSequence, pQueue->lDequeue + 1) < 0)
+   {
+      return FALSE;
+   }
+   memcpy(pCommand, &pCell->command, sizeof(PANEL_COMMAND));
+   /* free for the producer of the next round */
+   InterlockedExchange(&pCell->lSequence, pQueue->lDequeue + PANELQUEUE_SIZE);
+   pQueue->lDequeue++;
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_Command:  command without arguments, SHOW, HIDE or QUIT
+ *
+These commands change the state of the panel, they wait up to
+PANELQUEUE_WAIT for a free cell or until hAbort is set.
+ *******************************************************************************/
+int PanelQueue_Command(PANEL_QUEUE *pQueue, int iCommand, HANDLE hAbort)
+{
+   PANEL_COMMAND command;
+
+   command.iCommand = iCommand;
+   return PanelQueue_PushWait(pQueue, &command, PANELQUEUE_WAIT, hAbort);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_SetValue:  SetCtrlVal of a numeric control
+ *******************************************************************************/
+int PanelQueue_SetValue(PANEL_QUEUE *pQueue, int iCtrl, double dValue)
+{
+   PANEL_COMMAND command;
+
+   command.iCommand = PANELQUEUE_CMD_VALUE;
+   command.iCtrl = iCtrl;
+   command.dValue = dValue;
+   return PanelQueue_Push(pQueue, &command);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_SetText:  SetCtrlVal of a text control, longer texts are cut
+ *******************************************************************************/
+int PanelQueue_SetText(PANEL_QUEUE *pQueue, int iCtrl, const char *pText)
+{
+   PANEL_COMMAND command;
+
+   command.iCommand = PANELQUEUE_CMD_TEXT;
+   command.iCtrl = iCtrl;
+   strncpy(command.data.cText, pText, PANELQUEUE_TEXT_LENGTH - 1);
+   command.data.cText[PANELQUEUE_TEXT_LENGTH - 1] = '\0';
+   return PanelQueue_Push(pQueue, &command);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_SetAttribute:  SetCtrlAttribute with an integer value
+ *******************************************************************************/
+int PanelQueue_SetAttribute(PANEL_QUEUE *pQueue, int iCtrl, int iAttribute,
+   int iValue)
+{
+   PANEL_COMMAND command;
+
+   command.iCommand = PANELQUEUE_CMD_ATTRIBUTE;
+   command.iCtrl = iCtrl;
+   command.iAttribute = iAttribute;
+   command.iValue = iValue;
+   return PanelQueue_Push(pQueue, &command);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelQueue_SetScale:  range of the indicator
+ *******************************************************************************/
+int PanelQueue_SetScale(PANEL_QUEUE *pQueue, double dMinimum,
+   double dMaximum)
+{
+   PANEL_COMMAND command;
+
+   command.iCommand = PANELQUEUE_CMD_SCALE;
+   command.dValue = dMinimum;
+   command.dMaximum = dMaximum;
+   return PanelQueue_Push(pQueue, &command);
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Distance:  lSequence - lPosition, valid across the wrap of the counters
+ *******************************************************************************/
+static LONG Distance(LONG lSequence, LONG lPosition)
+{
+   return (LONG)((unsigned long)lSequence - (unsigned long)lPosition);
+}
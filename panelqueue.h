@@ -0,0 +1,70 @@
+/*******************************************************************************/
+/**
+@file panelqueue.h
+*
+@brief Commands of the library threads to the thread of a local panel
+*
+The CVI functions of a panel are only called by the thread that created it.
+Display, SetValue and Hide put commands into the queue of the bench, the
+panel thread executes them between its user interface events. The queue is
+part of the memory block of a resource and never allocates, any number of
+threads may put commands into it.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef PANELQUEUE_H
+#define PANELQUEUE_H
+
+/* INCLUDE FILES ***************************************************************/
+#include <windows.h>
+
+#include "panelcommand.h"
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define PANELQUEUE_SIZE         32    /* commands, a power of 2              */
+#define PANELQUEUE_WAIT         2000  /* ms for a free cell, state commands */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+/* A cell is free for the producer of position n when lSequence == n and
+   filled for the consumer when lSequence == n + 1 */
+typedef struct
+{
+   volatile LONG lSequence;
+   PANEL_COMMAND command;
+} PANEL_CELL;
+
+typedef struct
+{
+   volatile LONG lEnqueue;             /* next position to fill          */
+   LONG lDequeue;                      /* next position to execute       */
+   HANDLE hWake;                       /* set for every new command      */
+   PANEL_CELL cells[PANELQUEUE_SIZE];
+} PANEL_QUEUE;
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+int  PanelQueue_Initialize(PANEL_QUEUE *pQueue);
+void PanelQueue_Reset(PANEL_QUEUE *pQueue);
+void PanelQueue_Close(PANEL_QUEUE *pQueue);
+
+int  PanelQueue_Push(PANEL_QUEUE *pQueue, const PANEL_COMMAND *pCommand);
+int  PanelQueue_PushWait(PANEL_QUEUE *pQueue, const PANEL_COMMAND *pCommand,
+        DWORD dwTimeout, HANDLE hAbort);
+int  PanelQueue_Pop(PANEL_QUEUE *pQueue, PANEL_COMMAND *pCommand);
+
+int  PanelQueue_Command(PANEL_QUEUE *pQueue, int iCommand, HANDLE hAbort);
+int  PanelQueue_SetValue(PANEL_QUEUE *pQueue, int iCtrl, double dValue);
+int  PanelQueue_SetText(PANEL_QUEUE *pQueue, int iCtrl, const char *pText);
+int  PanelQueue_SetAttribute(PANEL_QUEUE *pQueue, int iCtrl, int iAttribute,
+        int iValue);
+int  PanelQueue_SetScale(PANEL_QUEUE *pQueue, double dMinimum,
+        double dMaximum);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
@@ -0,0 +1,594 @@
+/*******************************************************************************/
+/**
+@file panelview.c
+*
+@brief What the adjustment panel shows for the values of one Display call
+*
+Only what the operator can see is redrawn: the indicator when the value
+changes at the resolution of the format, the trend text when it changes and
+the background when the colour changes. PanelView_Invalidate makes the next
+value redraw all of them, e.g. after a command has been lost.
+tools/tsadjreplay.c builds the module with PANELVIEW_HEADLESS defined, it
+then takes the few CVI names from tools/headless.h and needs neither CVI nor
+Windows.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#ifdef PANELVIEW_HEADLESS
+#include "tools/headless.h"
+#else
+#include <windows.h>
+#include <userint.h>
+#include "testadjustmentpanel.h"
+#endif
+#include "panelview.h"
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static double QuantizeValue(double dValue, int iFormat, int iPrecision);
+static int PassedWithHysteresis(const PANEL_VIEW *pView, double dValue);
+static int ZoomScale(PANEL_VIEW *pView, double dValue, double dTime,
+   PANEL_COMMAND *pCommand);
+static void SetScale(PANEL_VIEW *pView, double dHalf, double dTime,
+   PANEL_COMMAND *pCommand);
+static void FormatTrend(PANEL_VIEW *pView, double dValue,
+   char cTrend[PANELVIEW_TREND_LENGTH]);
+static void GetButtonLabel(char cLabel[PANELIPC_BUTTON_LENGTH],
+   const char *pButtonText);
+static char *AppendText(char *pDest, const char *pEnd, const char *pText);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+PanelView_Begin:  starts the view of a new panel
+ *
+Hysteresis and auto zoom are kept, they belong to the bench.
+ *
+@param pFormat:     printf format of the values
+@param pCommand:    receives the fine scale with auto zoom, may be NULL
+ *
+@return             number of commands in pCommand, 0 or 1
+ *******************************************************************************/
+int PanelView_Begin(PANEL_VIEW *pView, double dLowerLimit, double dUpperLimit,
+   const char *pFormat, PANEL_COMMAND *pCommand)
+{
+   PANEL_COMMAND command;
+
+   pView->dLowerLimit = dLowerLimit;
+   pView->dUpperLimit = dUpperLimit;
+   PanelView_ParseFormat(pFormat, &pView->iFormat, &pView->iPrecision);
+   pView->iRedraw = TRUE;
+   pView->dShownValue = 0.0;
+   pView->iShownPassed = -1;
+   pView->cShownTrend[0] = '\0';
+   pView->dScaleHalf = 0.0;
+   pView->dZoomTime = 0.0;
+   Trend_Reset(&pView->trend);
+
+   if (!pView->iAutoZoom || (dUpperLimit <= dLowerLimit))
+   {
+      return 0;
+   }
+   /* start with the fine scale */
+   SetScale(pView, 0.5 * PANELVIEW_ZOOM_MARGIN * (dUpperLimit - dLowerLimit),
+      0.0, (pCommand != NULL) ? pCommand : &command);
+   return 1;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelView_Update:  commands to show one value
+ *
+The commands are returned in the order scale, indicator, trend, background.
+If one of them cannot be executed, call PanelView_Invalidate.
+ *
+@param dTime:       time stamp of the value, s
+@param piSkipped:   receives the number of redraws that were not needed
+ *
+@return             number of commands
+ *******************************************************************************/
+int PanelView_Update(PANEL_VIEW *pView, double dValue, double dTime,
+   PANEL_COMMAND commands[PANELVIEW_MAX_COMMANDS], int *piSkipped)
+{
+   char cTrend[PANELVIEW_TREND_LENGTH];
+   double dShown;
+   int iPassed;
+   int iRescaled;
+   int iCount = 0;
+
+   *piSkipped = 0;
+   dShown = QuantizeValue(dValue, pView->iFormat, pView->iPrecision);
+   iPassed = PassedWithHysteresis(pView, dValue);
+   iRescaled = pView->iAutoZoom && ZoomScale(pView, dValue, dTime,
+      &commands[iCount]);
+   if (iRescaled)
+   {
+      iCount++;
+   }
+
+   /* a new range moves the indicator, the value is set again */
+   if (iRescaled || pView->iRedraw || (dShown != pView->dShownValue))
+   {
+      commands[iCount].iCommand = PANELQUEUE_CMD_VALUE;
+      commands[iCount].iCtrl = ADJUSTMENT_INDICATOR;
+      commands[iCount].dValue = dShown;
+      iCount++;
+      pView->dShownValue = dShown;
+   }
+   else
+   {
+      (*piSkipped)++;
+   }
+
+   Trend_Add(&pView->trend, dTime, dValue);
+   FormatTrend(pView, dValue, cTrend);
+   if (strcmp(cTrend, pView->cShownTrend) != 0)
+   {
+      commands[iCount].iCommand = PANELQUEUE_CMD_TEXT;
+      commands[iCount].iCtrl = ADJUSTMENT_TREND;
+      strcpy(commands[iCount].data.cText, cTrend);
+      iCount++;
+      strcpy(pView->cShownTrend, cTrend);
+   }
+   else
+   {
+      (*piSkipped)++;
+   }
+
+   if (pView->iRedraw || (iPassed != pView->iShownPassed))
+   {
+      commands[iCount].iCommand = PANELQUEUE_CMD_ATTRIBUTE;
+      commands[iCount].iCtrl = ADJUSTMENT_BACKGROUND;
+      commands[iCount].iAttribute = ATTR_TEXT_BGCOLOR;
+      commands[iCount].iValue = iPassed ? VAL_GREEN : VAL_RED;
+      iCount++;
+   }
+   else
+   {
+      (*piSkipped)++;
+   }
+   pView->iShownPassed = iPassed;
+   pView->iRedraw = FALSE;
+   return iCount;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelView_Invalidate:  the panel does not show the state of the view
+ *
+The next value sets range, indicator, trend and colour again.
+ *******************************************************************************/
+void PanelView_Invalidate(PANEL_VIEW *pView)
+{
+   pView->iRedraw = TRUE;
+   pView->iShownPassed = -1;
+   pView->dScaleHalf = 0.0;
+   /* no trend text is "?", the next one is set in any case */
+   strcpy(pView->cShownTrend, "?");
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelView_KeepUntilShown:  keeps the commands of a value until the panel is
+                           shown
+ *
+Only the last value before the panel is shown is drawn, the commands of the
+previous one are replaced. The panel thread closes the pending commands at
+PANELQUEUE_CMD_SHOW with PanelView_ClosePending, from then on the values are
+queued.
+ *
+@param plPending:       PENDING_xxx, shared with the panel thread
+@param pending:         receives the commands, *piPendingCount of them
+ *
+@return                 FALSE -> panel shown, queue the commands
+ *******************************************************************************/
+int PanelView_KeepUntilShown(PANEL_VIEW *pView, volatile long *plPending,
+   PANEL_COMMAND pending[PANELVIEW_MAX_COMMANDS], int *piPendingCount,
+   double dValue, double dTime)
+{
+   int iSkipped;
+
+   if ((*plPending == PENDING_CLOSED)
+      || (InterlockedCompareExchange(plPending, PENDING_WRITING,
+      PENDING_OPEN) != PENDING_OPEN))
+   {
+      return FALSE;
+   }
+   /* all the controls, nothing of the replaced value has been drawn */
+   PanelView_Invalidate(pView);
+   *piPendingCount = PanelView_Update(pView, dValue, dTime, pending,
+      &iSkipped);
+   InterlockedExchange(plPending, PENDING_OPEN);
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelView_ClosePending:  the panel is shown, the pending commands are final
+ *
+Called by the thread that shows the panel before it draws the pending
+commands.
+ *******************************************************************************/
+void PanelView_ClosePending(volatile long *plPending)
+{
+   /* SetValue is replacing the commands, it takes a few instructions */
+   while (InterlockedCompareExchange(plPending, PENDING_CLOSED, PENDING_OPEN)
+      != PENDING_OPEN)
+   {
+      Sleep(0);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelView_SetValue:  one SetValue call, from the readings to the commands
+ *
+The readings are transformed and filtered, the limit decision is passed to
+pResultCallback, then the commands are kept until the panel is shown or
+returned in pReading to be queued or sent.
+ *
+@param pTransform:       NULL -> the readings are not transformed, e.g. the
+                         value of the simulated DUT
+@param values:           readings, the oldest first, lCount >= 1
+@param plPending:        see PanelView_KeepUntilShown; NULL -> the panel is
+                         shown, e.g. by the panel server
+@param pResultCallback:  called with pContext, may be NULL
+@param pReading:         receives the value and the commands
+ *******************************************************************************/
+void PanelView_SetValue(PANEL_VIEW *pView, FILTER *pFilter,
+   const TRANSFORM *pTransform, const double values[], long lCount,
+   double dTime, volatile long *plPending,
+   PANEL_COMMAND pending[PANELVIEW_MAX_COMMANDS], int *piPendingCount,
+   PANELVIEW_RESULT_CALLBACK pResultCallback, void *pContext,
+   PANELVIEW_READING *pReading)
+{
+   /* limit check and display use the transformed and filtered value */
+   pReading->dRawValue = values[lCount - 1];
+   pReading->dValue = (pTransform != NULL) ? Filter_ApplyReadings(pFilter,
+      pTransform, values, lCount) : Filter_ApplyBurst(pFilter, values,
+      (int) lCount);
+   pReading->iPassed = (pReading->dValue >= pView->dLowerLimit)
+      && (pReading->dValue <= pView->dUpperLimit);
+   pReading->iCommands = 0;
+   pReading->iSkipped = 0;
+   if (pResultCallback != NULL)
+   {
+      pResultCallback(pContext, pReading, dTime);
+   }
+
+   /* only what the operator can see is redrawn */
+   pReading->iKept = (plPending != NULL) && PanelView_KeepUntilShown(pView,
+      plPending, pending, piPendingCount, pReading->dValue, dTime);
+   if (!pReading->iKept)
+   {
+      pReading->iCommands = PanelView_Update(pView, pReading->dValue, dTime,
+         pReading->commands, &pReading->iSkipped);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelView_ParseFormat:  format and precision of the slider from a printf
+format
+ *
+@param pFormat:      printf format of the values, e.g. "%.3f"
+@param piFormat:     receives VAL_DECIMAL_FORMAT, VAL_FLOATING_PT_FORMAT or
+                     VAL_SCIENTIFIC_FORMAT
+@param piPrecision:  receives the digits behind the point, -1 if not given
+ *******************************************************************************/
+void PanelView_ParseFormat(const char *pFormat, int *piFormat,
+   int *piPrecision)
+{
+   const char *pPoint;
+
+   *piFormat = VAL_DECIMAL_FORMAT;
+   *piPrecision = -1;
+   if (strpbrk(pFormat, "fF") != NULL)
+   {
+      *piFormat = VAL_FLOATING_PT_FORMAT;
+   }
+   else if (strpbrk(pFormat, "eE") != NULL)
+   {
+      *piFormat = VAL_SCIENTIFIC_FORMAT;
+   }
+   else
+   {
+      return;
+   }
+
+   pPoint = strpbrk(pFormat, ".,");
+   if (pPoint == NULL)
+   {
+      return;
+   }
+   while (isdigit((unsigned char)*++pPoint))
+   {
+      *piPrecision = ((*piPrecision < 0) ? 0 : 10 * *piPrecision)
+         + (*pPoint - '0');
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelView_FormatText:  texts of a new panel, for the panel thread and the
+server
+ *******************************************************************************/
+void PanelView_FormatText(PANELIPC_DISPLAY_TEXT *pText, char nameOfStep[],
+   char buttonText[], char unit[], char format[], double lowerLimit,
+   double upperLimit)
+{
+   char cValue[1024];
+   char cTempBuffer[1024];
+
+   memset(pText, 0, sizeof(PANELIPC_DISPLAY_TEXT));
+   AppendText(pText->cStepName, pText->cStepName + sizeof(pText->cStepName)
+      - 1, nameOfStep);
+   FormatValues(cValue, format, lowerLimit);
+   sprintf(cTempBuffer, "LL: %s %s", cValue, unit);
+   AppendText(pText->cLowerLimit, pText->cLowerLimit
+      + sizeof(pText->cLowerLimit) - 1, cTempBuffer);
+   FormatValues(cValue, format, upperLimit);
+   sprintf(cTempBuffer, "UL: %s %s", cValue, unit);
+   AppendText(pText->cUpperLimit, pText->cUpperLimit
+      + sizeof(pText->cUpperLimit) - 1, cTempBuffer);
+   AppendText(pText->cUnit, pText->cUnit + sizeof(pText->cUnit) - 1, unit);
+   GetButtonLabel(pText->cButton, buttonText);
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+QuantizeValue:  rounds a value to the resolution of the indicator
+ *
+@param iFormat:     format of the indicator, see PanelView_ParseFormat
+@param iPrecision:  digits behind the point, -1 -> value is not changed
+ *
+@return             value as the operator sees it
+ *******************************************************************************/
+static double QuantizeValue(double dValue, int iFormat, int iPrecision)
+{
+   double dQuantum;
+
+   if (iFormat == VAL_DECIMAL_FORMAT)
+   {
+      return floor(dValue + 0.5);
+   }
+   if (iPrecision < 0)
+   {
+      return dValue;
+   }
+   dQuantum = pow(10.0, -iPrecision);
+   if ((iFormat == VAL_SCIENTIFIC_FORMAT) && (dValue != 0.0))
+   {
+      /* the precision applies to the mantissa */
+      dQuantum *= pow(10.0, floor(log10(fabs(dValue))));
+   }
+   return floor(dValue / dQuantum + 0.5) * dQuantum;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PassedWithHysteresis:  colour state of the background
+ *
+A green background turns red only when the value leaves the limits by more
+than the hysteresis, a red one turns green only when the value is inside the
+limits by more than the hysteresis. Noise near a limit does not flip it.
+ *
+@return             TRUE -> green
+ *******************************************************************************/
+static int PassedWithHysteresis(const PANEL_VIEW *pView, double dValue)
+{
+   double dMargin;
+
+   if (pView->iShownPassed < 0)
+   {
+      dMargin = 0.0;
+   }
+   else if (pView->iShownPassed)
+   {
+      dMargin = -pView->dHysteresis;
+   }
+   else
+   {
+      dMargin = pView->dHysteresis;
+   }
+   if ((pView->dLowerLimit + dMargin) > (pView->dUpperLimit - dMargin))
+   {
+      /* window smaller than the hysteresis, plain comparison */
+      dMargin = 0.0;
+   }
+   return (dValue >= pView->dLowerLimit + dMargin) && (dValue
+      <= pView->dUpperLimit - dMargin);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ZoomScale:  adapts the slider range to the distance of the value
+ *
+The levels of the scale are centred on the limits, the finest one shows the
+tolerance window with a margin, every further level is PANELVIEW_ZOOM_STEP
+times wider. A value beyond the scale widens it at once, so it is never pinned
+at the end. Narrowing goes one level at a time and waits
+PANELVIEW_ZOOM_INTERVAL after every change of the range, so a value near a
+level boundary cannot make the scale thrash.
+ *
+@param pCommand:    receives the new range
+ *
+@return             TRUE if the range has been changed
+ *******************************************************************************/
+static int ZoomScale(PANEL_VIEW *pView, double dValue, double dTime,
+   PANEL_COMMAND *pCommand)
+{
+   double dFine = 0.5 * PANELVIEW_ZOOM_MARGIN * (pView->dUpperLimit
+      - pView->dLowerLimit);
+   double dNeed;
+   double dHalf;
+   int iLevel;
+
+   if (dFine <= 0.0)
+   {
+      return FALSE;
+   }
+
+   /* smallest level that shows the value, not at the very end */
+   dNeed = 1.1 * fabs(dValue - 0.5 * (pView->dLowerLimit
+      + pView->dUpperLimit));
+   dHalf = dFine;
+   for (iLevel = 0; (iLevel < PANELVIEW_ZOOM_LEVELS) && (dHalf < dNeed);
+      iLevel++)
+   {
+      dHalf *= PANELVIEW_ZOOM_STEP;
+   }
+
+   if (dHalf > pView->dScaleHalf)
+   {
+      SetScale(pView, dHalf, dTime, pCommand);
+      return TRUE;
+   }
+   if ((dHalf < pView->dScaleHalf) && (dTime - pView->dZoomTime
+      >= PANELVIEW_ZOOM_INTERVAL))
+   {
+      SetScale(pView, pView->dScaleHalf / PANELVIEW_ZOOM_STEP, dTime,
+         pCommand);
+      return TRUE;
+   }
+   return FALSE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+SetScale:  sets the slider range around the limits
+ *
+@param dHalf:       half span of the range
+@param dTime:       time stamp of the change, see ZoomScale
+ *******************************************************************************/
+static void SetScale(PANEL_VIEW *pView, double dHalf, double dTime,
+   PANEL_COMMAND *pCommand)
+{
+   double dCentre = 0.5 * (pView->dLowerLimit + pView->dUpperLimit);
+
+   pCommand->iCommand = PANELQUEUE_CMD_SCALE;
+   pCommand->dValue = dCentre - dHalf;
+   pCommand->dMaximum = dCentre + dHalf;
+   pView->dScaleHalf = dHalf;
+   pView->dZoomTime = dTime;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+FormatTrend:  direction to the limits for the trend control
+ *
+The arrow points the way the value moves on the slider. The time is rounded
+to 0.1 s below 10 s and to 1 s above, so the text does not change with every
+value.
+ *******************************************************************************/
+static void FormatTrend(PANEL_VIEW *pView, double dValue,
+   char cTrend[PANELVIEW_TREND_LENGTH])
+{
+   double dTimeToWindow;
+   const char *pArrow;
+
+   /* below the limits the value has to rise */
+   pArrow = (dValue < pView->dLowerLimit) ? "-->" : "<--";
+   switch (Trend_Guidance(&pView->trend, dValue, pView->dLowerLimit,
+      pView->dUpperLimit, &dTimeToWindow))
+   {
+      case TREND_APPROACHING:
+         sprintf(cTrend, (dTimeToWindow < 10.0) ? "%s  approaching, %.1f s"
+            : "%s  approaching, %.0f s", pArrow, dTimeToWindow);
+         break;
+
+      case TREND_MOVING_AWAY:
+         /* the other direction */
+         pArrow = (dValue < pView->dLowerLimit) ? "<--" : "-->";
+         sprintf(cTrend, "%s  moving away", pArrow);
+         break;
+
+      case TREND_STEADY:
+         sprintf(cTrend, "%s  adjust", pArrow);
+         break;
+
+      default:
+         cTrend[0] = '\0';
+         break;
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+GetButtonLabel:  label of the OK button, texts longer than 8 characters are
+cut after 9 characters and get "..."
+ *******************************************************************************/
+static void GetButtonLabel(char cLabel[PANELIPC_BUTTON_LENGTH],
+   const char *pButtonText)
+{
+   char *pDest;
+
+   if (strlen(pButtonText) > 8)
+   {
+      pDest = AppendText(cLabel, cLabel + 9, pButtonText);
+      pDest = AppendText(pDest, cLabel + PANELIPC_BUTTON_LENGTH - 1, "...");
+   }
+   else
+   {
+      pDest = AppendText(cLabel, cLabel + PANELIPC_BUTTON_LENGTH - 1,
+         pButtonText);
+   }
+   *pDest = '\0';
+}
+
+/* FUNCTION *******************************************************************/
+/**
+AppendText:  copies a string without the terminating zero
+ *
+@param pDest:  write position
+@param pEnd:   first position which must not be written
+@param pText:  string to copy
+ *
+@return        new write position
+ *******************************************************************************/
+static char *AppendText(char *pDest, const char *pEnd, const char *pText)
+{
+   while ((pDest < pEnd) && (*pText != '\0'))
+   {
+      *pDest++ = *pText++;
+   }
+   return pDest;
+}
+
+
+/* FUNCTION *******************************************************************/
+/**
+FormatValues:  formats a value with the format of the step
+ *
+Integer, unsigned, hex and octal formats get the value converted to an int.
+ *
+@param cValue:      receives the text
+@param cFormat:     printf format of the values
+ *******************************************************************************/
+void FormatValues (char cValue[1024], char *cFormat, double dValue)
+{
+   if (!strcmp(cFormat, "%i") || !strcmp(cFormat, "%#x")
+      || !strcmp(cFormat, "%#X") || !strcmp(cFormat, "%#o"))
+   {
+      sprintf(cValue, cFormat, (int) dValue);
+   }
+   else if (!strcmp(cFormat, "%u"))
+   {
+      sprintf(cValue, cFormat, (unsigned int) dValue);
+   }
+   else
+   {
+      sprintf(cValue, cFormat, dValue);
+   }
+}
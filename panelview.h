@@ -0,0 +1,108 @@
+/*******************************************************************************/
+/**
+@file panelview.h
+*
+@brief What the adjustment panel shows for the values of one Display call
+*
+A PANEL_VIEW decides the texts, the colour and the range of the panel and
+returns them as PANEL_COMMANDs, it never calls the user interface. The library
+puts the commands into the queue of the panel thread or sends them to the
+panel server, tools/tsadjreplay.c prints them, so a recorded sequence of
+values can be checked without a panel. PanelView_SetValue is the way of
+every reading of SetValue, the library and tools/tsadjreplay.c both call it.
+A PANEL_VIEW is part of the memory block of a resource and never allocates.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef PANELVIEW_H
+#define PANELVIEW_H
+
+/* INCLUDE FILES ***************************************************************/
+#include "panelcommand.h"
+#include "filter.h"
+#include "trend.h"
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define PANELVIEW_MAX_COMMANDS  4     /* commands of one value               */
+#define PANELVIEW_TREND_LENGTH  48    /* text of the trend control           */
+#define PANELVIEW_ZOOM_MARGIN   1.5   /* fine scale / tolerance window       */
+#define PANELVIEW_ZOOM_STEP     4.0   /* span ratio of two zoom levels       */
+#define PANELVIEW_ZOOM_LEVELS   6     /* coarsest level, 4^6 x fine          */
+#define PANELVIEW_ZOOM_INTERVAL 1.0   /* s before the next zoom-in           */
+
+/* Created by CreateAdjustmentPanel behind the controls of the UIR */
+#define ADJUSTMENT_TREND  9   /* direction and time to reach the limits */
+
+/* States of the pending commands before the panel is shown */
+#define PENDING_OPEN     0   /* panel not shown, SetValue keeps the latest   */
+#define PENDING_WRITING  1   /* SetValue replaces the pending commands       */
+#define PENDING_CLOSED   2   /* panel shown, SetValue queues its commands    */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+typedef struct
+{
+   double dLowerLimit;   /* limits of the current panel                  */
+   double dUpperLimit;
+   int iFormat;          /* indicator format and precision, see          */
+   int iPrecision;       /* PanelView_ParseFormat                        */
+   double dHysteresis;   /* pass/fail colour hysteresis, value unit      */
+   int iAutoZoom;        /* slider range follows the value               */
+   int iRedraw;          /* next value sets indicator and colour         */
+   double dShownValue;   /* quantized value on the indicator             */
+   int iShownPassed;     /* colour of the background, -1 -> none yet     */
+   char cShownTrend[PANELVIEW_TREND_LENGTH]; /* text of ADJUSTMENT_TREND  */
+   double dScaleHalf;    /* half span of the slider around the window    */
+   double dZoomTime;     /* time stamp of the last range change          */
+   TREND trend;          /* slope of the shown values                    */
+} PANEL_VIEW;
+
+/* What PanelView_SetValue has done with the readings of one call */
+typedef struct
+{
+   double dValue;        /* transformed and filtered, checked and shown  */
+   double dRawValue;     /* last reading of the call                     */
+   int iPassed;          /* dValue within the limits, no hysteresis      */
+   int iKept;            /* TRUE -> kept until the panel is shown        */
+   int iCommands;        /* commands to execute, 0 if kept               */
+   int iSkipped;         /* redraws that were not needed                 */
+   PANEL_COMMAND commands[PANELVIEW_MAX_COMMANDS];
+} PANELVIEW_READING;
+
+/* Limit decision of a reading, before the panel commands are decided;
+   step result, telemetry and recorder of the library */
+typedef void (*PANELVIEW_RESULT_CALLBACK)(void *pContext,
+   const PANELVIEW_READING *pReading, double dTime);
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+int  PanelView_Begin(PANEL_VIEW *pView, double dLowerLimit, double dUpperLimit,
+        const char *pFormat, PANEL_COMMAND *pCommand);
+int  PanelView_Update(PANEL_VIEW *pView, double dValue, double dTime,
+        PANEL_COMMAND commands[PANELVIEW_MAX_COMMANDS], int *piSkipped);
+void PanelView_Invalidate(PANEL_VIEW *pView);
+int  PanelView_KeepUntilShown(PANEL_VIEW *pView, volatile long *plPending,
+        PANEL_COMMAND pending[PANELVIEW_MAX_COMMANDS], int *piPendingCount,
+        double dValue, double dTime);
+void PanelView_ClosePending(volatile long *plPending);
+void PanelView_SetValue(PANEL_VIEW *pView, FILTER *pFilter,
+        const TRANSFORM *pTransform, const double values[], long lCount,
+        double dTime, volatile long *plPending,
+        PANEL_COMMAND pending[PANELVIEW_MAX_COMMANDS], int *piPendingCount,
+        PANELVIEW_RESULT_CALLBACK pResultCallback, void *pContext,
+        PANELVIEW_READING *pReading);
+
+void PanelView_ParseFormat(const char *pFormat, int *piFormat,
+        int *piPrecision);
+void PanelView_FormatText(PANELIPC_DISPLAY_TEXT *pText, char nameOfStep[],
+        char buttonText[], char unit[], char format[], double lowerLimit,
+        double upperLimit);
+void FormatValues (char cValue[1024], char *cFormat, double dValue);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
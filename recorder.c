@@ -0,0 +1,427 @@
+/*******************************************************************************/
+/**
+@file recorder.c
+*
+@brief Double buffered value recorder with a background writer thread
+*
+Recorder_Append only stores into the active half of a buffer which has been
+allocated in tsadj_Setup. A full half is handed over to the writer thread,
+which appends it to the recording file. If the writer has not finished the
+other half yet, the record is dropped and counted instead of blocking the
+caller. Recorder_End writes the rest synchronously and closes the file.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <windows.h>
+#include <ansi_c.h>
+
+#include "recorder.h"
+
+/* LOCAL DEFINES **************************************************************/
+#define RECORDER_MAX_ACTIVE   64   /* recordings open at the same time */
+
+/* LOCAL TYPE DEFINITIONS *****************************************************/
+
+struct recorderRec
+{
+   HANDLE hFile;                 /* INVALID_HANDLE_VALUE if not recording  */
+   LONGLONG llStartCount;        /* performance counter at Recorder_Begin  */
+   double dTicksPerSecond;
+   RECORDER_RECORD *pBuffer[2];
+   int iActive;                  /* half written by Recorder_Append        */
+   int iFill;                    /* records in the active half             */
+   volatile LONG lPending[2];    /* records handed over, 0 -> half free    */
+   LONG lDropped;                /* records lost because the writer lagged */
+};
+
+/* GLOBAL VARIABLES DEFINITION ************************************************/
+static CRITICAL_SECTION gRecorderLock;    /* protects the list and files */
+static RECORDER *gpActive[RECORDER_MAX_ACTIVE];
+static int giRecorderCount = 0;          /* created recorders           */
+static HANDLE ghWriterThread = NULL;
+static HMODULE ghWriterModule = NULL;     /* reference held by the writer */
+static HANDLE ghWriterWake = NULL;
+static volatile LONG glWriterQuit = 0;
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static DWORD WINAPI WriterThread(LPVOID pData);
+static int HandOver(RECORDER *pRecorder);
+static void WritePending(RECORDER *pRecorder, int iHalf);
+static void BuildFileName(char cPath[], const char *pUUT, const char *pStepName);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Recorder_Initialize:  called once by the first exported function
+ *******************************************************************************/
+void Recorder_Initialize(void)
+{
+   InitializeCriticalSection(&gRecorderLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Recorder_Close:  called when the DLL is unloaded; the writer thread holds
+a reference to the DLL, so it has ended before
+ *******************************************************************************/
+void Recorder_Close(void)
+{
+   DeleteCriticalSection(&gRecorderLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Recorder_Create:  allocates the buffers and starts the writer thread if
+this is the first recorder
+ *
+@return           recorder or NULL if out of memory
+ *******************************************************************************/
+RECORDER *Recorder_Create(void)
+{
+   RECORDER *pRecorder;
+   LARGE_INTEGER liFrequency;
+
+   pRecorder = (RECORDER *)calloc(1, sizeof(RECORDER));
+   if (pRecorder == NULL)
+   {
+      return NULL;
+   }
+   pRecorder->pBuffer[0] = (RECORDER_RECORD *)malloc(2 * RECORDER_BUFFER_RECORDS
+      * sizeof(RECORDER_RECORD));
+   if (pRecorder->pBuffer[0] == NULL)
+   {
+      free(pRecorder);
+      return NULL;
+   }
+   pRecorder->pBuffer[1] = pRecorder->pBuffer[0] + RECORDER_BUFFER_RECORDS;
+   pRecorder->hFile = INVALID_HANDLE_VALUE;
+   QueryPerformanceFrequency(&liFrequency);
+   pRecorder->dTicksPerSecond = (double)liFrequency.QuadPart;
+
+   EnterCriticalSection(&gRecorderLock);
+   if (ghWriterThread == NULL)
+   {
+      glWriterQuit = 0;
+      ghWriterWake = CreateEvent(NULL, FALSE, FALSE, NULL);
+      /* the DLL cannot be unloaded before the writer has ended */
+      if ((ghWriterWake != NULL) && GetModuleHandleEx(
+         GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS, (LPCTSTR) WriterThread,
+         &ghWriterModule))
+      {
+         ghWriterThread = CreateThread(NULL, 0, WriterThread, NULL, 0, NULL);
+         if (ghWriterThread == NULL)
+         {
+            FreeLibrary(ghWriterModule);
+         }
+      }
+   }
+   if (ghWriterThread == NULL)
+   {
+      LeaveCriticalSection(&gRecorderLock);
+      free(pRecorder->pBuffer[0]);
+      free(pRecorder);
+      return NULL;
+   }
+   giRecorderCount++;
+   LeaveCriticalSection(&gRecorderLock);
+
+   return pRecorder;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Recorder_Destroy:  ends a running recording, frees the buffers and stops
+the writer thread with the last recorder; pRecorder may be NULL
+ *******************************************************************************/
+void Recorder_Destroy(RECORDER *pRecorder)
+{
+   HANDLE hThread = NULL;
+
+   if (pRecorder == NULL)
+   {
+      return;
+   }
+   Recorder_End(pRecorder);
+
+   EnterCriticalSection(&gRecorderLock);
+   giRecorderCount--;
+   if (giRecorderCount == 0)
+   {
+      hThread = ghWriterThread;
+      ghWriterThread = NULL;
+      InterlockedExchange(&glWriterQuit, 1);
+      SetEvent(ghWriterWake);
+   }
+   LeaveCriticalSection(&gRecorderLock);
+
+   if (hThread != NULL)
+   {
+      WaitForSingleObject(hThread, INFINITE);
+      CloseHandle(hThread);
+      CloseHandle(ghWriterWake);
+      ghWriterWake = NULL;
+   }
+
+   free(pRecorder->pBuffer[0]);
+   free(pRecorder);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Recorder_Begin:  opens a new recording file for one UUT and step
+ *
+@param pUUT:       serial number of the UUT, used in the file name
+@param pStepName:  name of the step, used in the file name
+ *
+@return            0 on success, -1 if the file could not be created
+ *******************************************************************************/
+int Recorder_Begin(RECORDER *pRecorder, const char *pUUT,
+   const char *pStepName)
+{
+   char cPath[MAX_PATH + 256];
+   RECORDER_FILE_HEADER header;
+   LARGE_INTEGER liCount;
+   DWORD dwWritten;
+   int idx;
+
+   if (pRecorder == NULL)
+   {
+      return -1;
+   }
+   Recorder_End(pRecorder);
+
+   BuildFileName(cPath, pUUT, pStepName);
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.cMagic, RECORDER_MAGIC, sizeof(header.cMagic));
+   header.lVersion = RECORDER_VERSION;
+   header.lHeaderSize = sizeof(RECORDER_FILE_HEADER);
+   header.lRecordSize = sizeof(RECORDER_RECORD);
+   strncpy(header.cUUT, pUUT, RECORDER_UUT_LENGTH - 1);
+   strncpy(header.cStepName, pStepName, RECORDER_STEPNAME_LENGTH - 1);
+   GetSystemTimeAsFileTime(&header.ftStart);
+
+   EnterCriticalSection(&gRecorderLock);
+   for (idx = 0; idx < RECORDER_MAX_ACTIVE; idx++)
+   {
+      if (gpActive[idx] == NULL)
+      {
+         break;
+      }
+   }
+   if (idx < RECORDER_MAX_ACTIVE)
+   {
+      /* written in sequence, only lDropped of the header is rewritten */
+      pRecorder->hFile = CreateFile(cPath, GENERIC_WRITE, FILE_SHARE_READ,
+         NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+   }
+   if (pRecorder->hFile != INVALID_HANDLE_VALUE)
+   {
+      WriteFile(pRecorder->hFile, &header, sizeof(header), &dwWritten, NULL);
+      pRecorder->iActive = 0;
+      pRecorder->iFill = 0;
+      pRecorder->lPending[0] = 0;
+      pRecorder->lPending[1] = 0;
+      pRecorder->lDropped = 0;
+      QueryPerformanceCounter(&liCount);
+      pRecorder->llStartCount = liCount.QuadPart;
+      gpActive[idx] = pRecorder;
+   }
+   LeaveCriticalSection(&gRecorderLock);
+
+   return (pRecorder->hFile != INVALID_HANDLE_VALUE) ? 0 : -1;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Recorder_Append:  stores one value, never blocks
+ *******************************************************************************/
+void Recorder_Append(RECORDER *pRecorder, double dValue, double dRawValue,
+   int iPassed)
+{
+   RECORDER_RECORD *pRecord;
+   LARGE_INTEGER liCount;
+
+   if ((pRecorder == NULL) || (pRecorder->hFile == INVALID_HANDLE_VALUE))
+   {
+      return;
+   }
+   if ((pRecorder->iFill == RECORDER_BUFFER_RECORDS) && !HandOver(pRecorder))
+   {
+      pRecorder->lDropped++;
+      return;
+   }
+
+   QueryPerformanceCounter(&liCount);
+   pRecord = &pRecorder->pBuffer[pRecorder->iActive][pRecorder->iFill];
+   pRecord->dTime = (double)(liCount.QuadPart - pRecorder->llStartCount)
+      / pRecorder->dTicksPerSecond;
+   pRecord->dValue = dValue;
+   pRecord->dRawValue = dRawValue;
+   pRecord->lPassed = iPassed;
+   pRecord->lReserved = 0;
+   pRecorder->iFill++;
+
+   if (pRecorder->iFill == RECORDER_BUFFER_RECORDS)
+   {
+      HandOver(pRecorder);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Recorder_End:  writes all buffered records and closes the recording file
+ *
+@return     records dropped during the recording, also stored in lDropped of
+            the file header
+ *******************************************************************************/
+long Recorder_End(RECORDER *pRecorder)
+{
+   DWORD dwWritten;
+   LONG lDropped;
+   int idx;
+
+   if ((pRecorder == NULL) || (pRecorder->hFile == INVALID_HANDLE_VALUE))
+   {
+      return 0;
+   }
+
+   EnterCriticalSection(&gRecorderLock);
+   /* the pending half is older than the active one */
+   WritePending(pRecorder, 1 - pRecorder->iActive);
+   if (pRecorder->iFill > 0)
+   {
+      WriteFile(pRecorder->hFile, pRecorder->pBuffer[pRecorder->iActive],
+         pRecorder->iFill * sizeof(RECORDER_RECORD), &dwWritten, NULL);
+      pRecorder->iFill = 0;
+   }
+   lDropped = pRecorder->lDropped;
+   if (lDropped > 0)
+   {
+      SetFilePointer(pRecorder->hFile, offsetof(RECORDER_FILE_HEADER, lDropped),
+         NULL, FILE_BEGIN);
+      WriteFile(pRecorder->hFile, &lDropped, sizeof(lDropped), &dwWritten, NULL);
+   }
+   CloseHandle(pRecorder->hFile);
+   pRecorder->hFile = INVALID_HANDLE_VALUE;
+   for (idx = 0; idx < RECORDER_MAX_ACTIVE; idx++)
+   {
+      if (gpActive[idx] == pRecorder)
+      {
+         gpActive[idx] = NULL;
+      }
+   }
+   LeaveCriticalSection(&gRecorderLock);
+
+   return lDropped;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+HandOver:  passes the full active half to the writer thread
+ *
+@return    1 if the halves were swapped, 0 if the other half is still
+           waiting for the writer
+ *******************************************************************************/
+static int HandOver(RECORDER *pRecorder)
+{
+   int iOther = 1 - pRecorder->iActive;
+
+   if (pRecorder->lPending[iOther] != 0)
+   {
+      return 0;
+   }
+   InterlockedExchange(&pRecorder->lPending[pRecorder->iActive],
+      pRecorder->iFill);
+   pRecorder->iActive = iOther;
+   pRecorder->iFill = 0;
+   SetEvent(ghWriterWake);
+   return 1;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+WritePending:  appends a handed over half to the file, lock must be held
+ *******************************************************************************/
+static void WritePending(RECORDER *pRecorder, int iHalf)
+{
+   DWORD dwWritten;
+   LONG lCount = pRecorder->lPending[iHalf];
+
+   if (lCount > 0)
+   {
+      WriteFile(pRecorder->hFile, pRecorder->pBuffer[iHalf],
+         lCount * sizeof(RECORDER_RECORD), &dwWritten, NULL);
+      InterlockedExchange(&pRecorder->lPending[iHalf], 0);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+WriterThread:  writes handed over halves of all open recordings
+ *******************************************************************************/
+static DWORD WINAPI WriterThread(LPVOID pData)
+{
+   int idx;
+
+   while (!glWriterQuit)
+   {
+      WaitForSingleObject(ghWriterWake, INFINITE);
+
+      EnterCriticalSection(&gRecorderLock);
+      for (idx = 0; idx < RECORDER_MAX_ACTIVE; idx++)
+      {
+         /* at most one half is pending at a time */
+         if (gpActive[idx] != NULL)
+         {
+            WritePending(gpActive[idx], 0);
+            WritePending(gpActive[idx], 1);
+         }
+      }
+      LeaveCriticalSection(&gRecorderLock);
+   }
+   FreeLibraryAndExitThread(ghWriterModule, 0);
+   return 0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+BuildFileName:  <TEMP>\tsadj\<UUT>_<step>_<yyyymmdd_hhmmss_mmm>.tsadjrec
+ *******************************************************************************/
+static void BuildFileName(char cPath[], const char *pUUT, const char *pStepName)
+{
+   SYSTEMTIME st;
+   char *pChar;
+   int iLength;
+
+   iLength = GetTempPath(MAX_PATH, cPath);
+   if ((iLength == 0) || (iLength > MAX_PATH))
+   {
+      strcpy(cPath, ".\\");
+      iLength = 2;
+   }
+   strcpy(cPath + iLength, RECORDER_SUBDIRECTORY);
+   CreateDirectory(cPath, NULL);
+   iLength += strlen(RECORDER_SUBDIRECTORY);
+
+   GetLocalTime(&st);
+   sprintf(cPath + iLength, "\\%.63s_%.127s_%04d%02d%02d_%02d%02d%02d_%03d"
+      RECORDER_FILE_EXTENSION, pUUT, pStepName, st.wYear, st.wMonth, st.wDay,
+      st.wHour, st.wMinute, st.wSecond, st.wMilliseconds);
+
+   /* UUT and step names may contain characters not allowed in file names */
+   for (pChar = cPath + iLength + 1; *pChar != '\0'; pChar++)
+   {
+      if (strchr("\\/:*?\"<>|", *pChar) != NULL)
+      {
+         *pChar = '_';
+      }
+   }
+}
@@ -0,0 +1,87 @@
+/*******************************************************************************/
+/**
+@file recorder.h
+*
+@brief Binary recording of the values passed to tsadj_SetValueAdjustmentPanel
+*
+A recording file is written for every displayed panel of a resource with the
+"Recorder" key enabled. The file starts with a RECORDER_FILE_HEADER followed
+by RECORDER_RECORD entries up to the end of the file. Both structures have a
+fixed size, so the file can be mapped into memory and read as an array.
+Records dropped because the writer thread lagged are counted in lDropped of
+the header when the recording ends.
+Use tools/tsadjrec2csv.c to convert a recording into a CSV file.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef RECORDER_H
+#define RECORDER_H
+
+/* INCLUDE FILES ***************************************************************/
+#include <windows.h>
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define RECORDER_MAGIC              "TSADJREC"
+#define RECORDER_VERSION            2           /* 1: records without raw value */
+#define RECORDER_FILE_EXTENSION     ".tsadjrec"
+#define RECORDER_SUBDIRECTORY       "tsadj"     /* below the TEMP directory */
+#define RECORDER_BUFFER_RECORDS     4096        /* records per half buffer  */
+#define RECORDER_UUT_LENGTH         64
+#define RECORDER_STEPNAME_LENGTH    128
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+/* 32 bytes per record */
+typedef struct
+{
+   double dTime;       /* seconds since the panel was displayed */
+   double dValue;      /* value shown, after the filter         */
+   double dRawValue;   /* value passed to SetValue              */
+   LONG lPassed;       /* 1 -> value within the limits          */
+   LONG lReserved;
+} RECORDER_RECORD;
+
+/* 24 bytes per record of version 1 files */
+typedef struct
+{
+   double dTime;
+   double dValue;
+   LONG lPassed;
+   LONG lReserved;
+} RECORDER_RECORD_V1;
+
+/* 224 bytes, records start directly behind the header */
+typedef struct
+{
+   char cMagic[8];     /* RECORDER_MAGIC, not zero terminated   */
+   LONG lVersion;      /* RECORDER_VERSION                      */
+   LONG lHeaderSize;   /* sizeof(RECORDER_FILE_HEADER)          */
+   LONG lRecordSize;   /* sizeof(RECORDER_RECORD)               */
+   LONG lDropped;      /* records lost, written at Recorder_End */
+   FILETIME ftStart;   /* system time of dTime == 0 (UTC)       */
+   char cUUT[RECORDER_UUT_LENGTH];
+   char cStepName[RECORDER_STEPNAME_LENGTH];
+} RECORDER_FILE_HEADER;
+
+typedef struct recorderRec RECORDER;
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+void Recorder_Initialize(void);
+void Recorder_Close(void);
+
+RECORDER *Recorder_Create(void);
+void Recorder_Destroy(RECORDER *pRecorder);
+int  Recorder_Begin(RECORDER *pRecorder, const char *pUUT,
+   const char *pStepName);
+void Recorder_Append(RECORDER *pRecorder, double dValue, double dRawValue,
+   int iPassed);
+long Recorder_End(RECORDER *pRecorder);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
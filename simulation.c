@@ -0,0 +1,217 @@
+/*******************************************************************************/
+/**
+@file simulation.c
+*
+@brief Simulated DUT and operator of a bench in simulation mode
+*
+The noise comes from a linear congruential generator with the seed of
+Simulation_Configure, so a run can be repeated value by value.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <ansi_c.h>
+
+#include "simulation.h"
+
+/* LOCAL VARIABLES ************************************************************/
+
+/* names of the "SimPlant" and "SimOperator" keys, the first one is the
+   default */
+static const char *gPlantNames[SIMULATION_PLANTS] =
+{
+   "Normal", "Slow", "Noisy", "Drifting"
+};
+
+static const SIM_PLANT gPlants[SIMULATION_PLANTS] =
+{
+   /* tau   noise  drift  start */
+   { 0.2,   0.02,  0.0,   5.0 },
+   { 1.5,   0.02,  0.0,   5.0 },
+   { 0.2,   0.3,   0.0,   5.0 },
+   { 0.2,   0.02,  0.2,   5.0 }
+};
+
+static const char *gOperatorNames[SIMULATION_OPERATORS] =
+{
+   "Normal", "Fast", "Careful"
+};
+
+static const SIM_OPERATOR gOperators[SIMULATION_OPERATORS] =
+{
+   /* reaction  gain  dwell */
+   { 0.4,       0.5,  1.0 },
+   { 0.2,       0.8,  0.3 },
+   { 0.6,       0.3,  2.0 }
+};
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static double NextGaussian(SIMULATION *pSim);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Simulation_PlantName:  name of a DUT preset
+ *
+@return             NULL for an unknown preset
+ *******************************************************************************/
+const char *Simulation_PlantName(int iPlant)
+{
+   return ((iPlant >= 0) && (iPlant < SIMULATION_PLANTS))
+      ? gPlantNames[iPlant] : NULL;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Simulation_OperatorName:  name of an operator preset
+ *
+@return             NULL for an unknown preset
+ *******************************************************************************/
+const char *Simulation_OperatorName(int iOperator)
+{
+   return ((iOperator >= 0) && (iOperator < SIMULATION_OPERATORS))
+      ? gOperatorNames[iOperator] : NULL;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Simulation_Configure:  selects the presets, the fields may be changed later
+ *
+@param ulSeed:      start of the noise, the same seed gives the same values
+ *******************************************************************************/
+void Simulation_Configure(SIMULATION *pSim, int iPlant, int iOperator,
+   unsigned long ulSeed)
+{
+   memset(pSim, 0, sizeof(SIMULATION));
+   pSim->plant = gPlants[((iPlant >= 0) && (iPlant < SIMULATION_PLANTS))
+      ? iPlant : 0];
+   pSim->op = gOperators[((iOperator >= 0)
+      && (iOperator < SIMULATION_OPERATORS)) ? iOperator : 0];
+   pSim->ulRandom = ulSeed;
+   pSim->dWindow = 1.0;
+   pSim->dGreenSince = -1.0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Simulation_Begin:  a new DUT with the adjustment off by plant.dStart windows,
+                   called for every displayed panel
+ *******************************************************************************/
+void Simulation_Begin(SIMULATION *pSim, double dLowerLimit,
+   double dUpperLimit, double dTime)
+{
+   pSim->dCentre = (dLowerLimit + dUpperLimit) / 2.0;
+   pSim->dWindow = fabs(dUpperLimit - dLowerLimit);
+   if (pSim->dWindow <= 0.0)
+   {
+      /* a single point as limit, any scale will do */
+      pSim->dWindow = (pSim->dCentre != 0.0) ? fabs(pSim->dCentre) * 1e-3
+         : 1e-3;
+   }
+   pSim->dSetting = pSim->dCentre + pSim->plant.dStart * pSim->dWindow;
+   pSim->dOutput = pSim->dSetting;
+   pSim->dBeginTime = dTime;
+   pSim->dLastTime = dTime;
+   pSim->dTurnTime = dTime;
+   pSim->dGreenSince = -1.0;
+   pSim->iPressed = 0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Simulation_Measure:  reading of the DUT at a time stamp
+ *
+@param dTime:       s, not before the last call
+ *******************************************************************************/
+double Simulation_Measure(SIMULATION *pSim, double dTime)
+{
+   double dTarget;
+   double dStep = dTime - pSim->dLastTime;
+
+   dTarget = pSim->dSetting + pSim->plant.dDrift * pSim->dWindow
+      * (dTime - pSim->dBeginTime);
+   if ((dStep > 0.0) && (pSim->plant.dTau > 0.0))
+   {
+      pSim->dOutput += (dTarget - pSim->dOutput)
+         * (1.0 - exp(-dStep / pSim->plant.dTau));
+   }
+   else if (pSim->plant.dTau <= 0.0)
+   {
+      pSim->dOutput = dTarget;
+   }
+   if (dStep > 0.0)
+   {
+      pSim->dLastTime = dTime;
+   }
+   return pSim->dOutput + pSim->plant.dNoise * pSim->dWindow
+      * NextGaussian(pSim);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Simulation_Operate:  the operator looks at the panel
+ *
+The operator turns the adjustment towards the middle of the limits at most
+every op.dReaction s, and presses the button once the panel has been green
+for op.dDwell s.
+ *
+@param dShownValue:   value on the indicator
+@param iShownPassed:  colour of the panel, -1 -> no value shown yet
+ *
+@return             1 once, when the operator presses the button
+ *******************************************************************************/
+int Simulation_Operate(SIMULATION *pSim, double dShownValue, int iShownPassed,
+   double dTime)
+{
+   if (pSim->iPressed || (iShownPassed < 0))
+   {
+      return 0;
+   }
+
+   if (iShownPassed)
+   {
+      if (pSim->dGreenSince < 0.0)
+      {
+         pSim->dGreenSince = dTime;
+      }
+      if (dTime - pSim->dGreenSince >= pSim->op.dDwell)
+      {
+         pSim->iPressed = 1;
+         return 1;
+      }
+   }
+   else
+   {
+      pSim->dGreenSince = -1.0;
+      if (dTime - pSim->dTurnTime >= pSim->op.dReaction)
+      {
+         pSim->dTurnTime = dTime;
+         pSim->dSetting += pSim->op.dGain * (pSim->dCentre - dShownValue);
+      }
+   }
+   return 0;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+NextGaussian:  standard normal number, sum of 12 uniform numbers
+ *******************************************************************************/
+static double NextGaussian(SIMULATION *pSim)
+{
+   double dSum = 0.0;
+   int idx;
+
+   for (idx = 0; idx < 12; idx++)
+   {
+      pSim->ulRandom = (pSim->ulRandom * 1103515245UL + 12345UL)
+         & 0xFFFFFFFFUL;
+      dSum += (double)(pSim->ulRandom >> 8) / 16777216.0;
+   }
+   return dSum - 6.0;
+}
@@ -0,0 +1,78 @@
+/*******************************************************************************/
+/**
+@file simulation.h
+*
+@brief Simulated DUT and operator of a bench in simulation mode
+*
+With "Simulation = 1" the reading passed to tsadj_SetValueAdjustmentPanel is
+replaced by the output of a simulated DUT, and a simulated operator turns its
+adjustment and presses the button. The operator only sees what the panel
+shows, so hysteresis, filter and auto zoom change the adjustment time as
+they would for a person. tools/tsadjsim.c runs the same models without a
+panel for many cycles.
+The DUT follows its adjustment with a first-order lag and adds noise and a
+drift. All parameters are relative to the tolerance window (upper - lower
+limit), so one preset fits every step. A SIMULATION is part of the memory
+block of a resource and never allocates.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define SIMULATION_PLANTS      4     /* presets, see Simulation_PlantName  */
+#define SIMULATION_OPERATORS   3     /* presets, see Simulation_OperatorName */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+typedef struct
+{
+   double dTau;          /* s, time constant of the response             */
+   double dNoise;        /* standard deviation, windows                  */
+   double dDrift;        /* windows / s, after Simulation_Begin          */
+   double dStart;        /* offset of the first value, windows           */
+} SIM_PLANT;
+
+typedef struct
+{
+   double dReaction;     /* s between two turns of the adjustment        */
+   double dGain;         /* part of the shown error corrected per turn   */
+   double dDwell;        /* s the panel is green before the button       */
+} SIM_OPERATOR;
+
+typedef struct
+{
+   SIM_PLANT plant;
+   SIM_OPERATOR op;
+   unsigned long ulRandom;  /* state of the noise generator             */
+   double dCentre;          /* middle of the limits                     */
+   double dWindow;          /* upper - lower limit, > 0                 */
+   double dBeginTime;       /* time stamp of Simulation_Begin           */
+   double dLastTime;        /* time stamp of the last value             */
+   double dSetting;         /* where the operator has put the adjustment */
+   double dOutput;          /* DUT output without noise                 */
+   double dTurnTime;        /* time stamp of the last turn              */
+   double dGreenSince;      /* shown in the limits since, < 0 -> not    */
+   int iPressed;            /* the button has been pressed              */
+} SIMULATION;
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+const char *Simulation_PlantName(int iPlant);
+const char *Simulation_OperatorName(int iOperator);
+void Simulation_Configure(SIMULATION *pSim, int iPlant, int iOperator,
+        unsigned long ulSeed);
+void Simulation_Begin(SIMULATION *pSim, double dLowerLimit,
+        double dUpperLimit, double dTime);
+double Simulation_Measure(SIMULATION *pSim, double dTime);
+int  Simulation_Operate(SIMULATION *pSim, double dShownValue,
+        int iShownPassed, double dTime);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
@@ -0,0 +1,96 @@
+/*******************************************************************************/
+/**
+@file stepresult.c
+*
+@brief Result of one adjustment, kept while the values arrive
+*
+The time in the limits counts from a value within the limits to the next
+value, the last value counts up to the time the result is taken.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <ansi_c.h>
+
+#include "stepresult.h"
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+StepResult_Begin:  forgets all values, called for every displayed panel
+ *******************************************************************************/
+void StepResult_Begin(STEP_RESULT *pResult)
+{
+   memset(pResult, 0, sizeof(STEP_RESULT));
+}
+
+/* FUNCTION *******************************************************************/
+/**
+StepResult_Add:  adds one value
+ *
+@param dTime:       time stamp of the value, s
+@param iPassed:     value within the limits
+ *******************************************************************************/
+void StepResult_Add(STEP_RESULT *pResult, double dTime, double dValue,
+   int iPassed)
+{
+   if (pResult->lValues == 0)
+   {
+      pResult->dMinimum = dValue;
+      pResult->dMaximum = dValue;
+   }
+   else
+   {
+      if (pResult->iLastPassed)
+      {
+         pResult->dTimeInLimits += dTime - pResult->dLastTime;
+      }
+      if (iPassed != pResult->iLastPassed)
+      {
+         pResult->lCrossings++;
+      }
+      if (dValue < pResult->dMinimum)
+      {
+         pResult->dMinimum = dValue;
+      }
+      else if (dValue > pResult->dMaximum)
+      {
+         pResult->dMaximum = dValue;
+      }
+   }
+   pResult->lValues++;
+   pResult->dLastValue = dValue;
+   pResult->iLastPassed = iPassed;
+   pResult->dLastTime = dTime;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+StepResult_Get:  result at a time stamp
+ *
+@param dTime:        time stamp of the result, e.g. of the Hide call
+@param dDisplayEnd:  time stamp the operator got the panel
+@param dButtonTime:  time stamp of the button, 0.0 -> not pressed
+@param dFields:      receives the result, see STEPRESULT_xxx
+ *******************************************************************************/
+void StepResult_Get(const STEP_RESULT *pResult, double dTime,
+   double dDisplayEnd, double dButtonTime, double dFields[STEPRESULT_FIELDS])
+{
+   dFields[STEPRESULT_FINAL_VALUE] = pResult->dLastValue;
+   dFields[STEPRESULT_MINIMUM] = pResult->dMinimum;
+   dFields[STEPRESULT_MAXIMUM] = pResult->dMaximum;
+   dFields[STEPRESULT_TIME_IN_LIMITS] = pResult->dTimeInLimits;
+   if ((pResult->lValues > 0) && pResult->iLastPassed
+      && (dTime > pResult->dLastTime))
+   {
+      dFields[STEPRESULT_TIME_IN_LIMITS] += dTime - pResult->dLastTime;
+   }
+   dFields[STEPRESULT_CROSSINGS] = pResult->lCrossings;
+   dFields[STEPRESULT_TIME_TO_CONFIRM] = (dButtonTime > dDisplayEnd)
+      ? dButtonTime - dDisplayEnd : -1.0;
+   dFields[STEPRESULT_VALUES] = pResult->lValues;
+}
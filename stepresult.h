@@ -0,0 +1,59 @@
+/*******************************************************************************/
+/**
+@file stepresult.h
+*
+@brief Result of one adjustment, kept while the values arrive
+*
+A STEP_RESULT is updated by every tsadj_SetValueAdjustmentPanel call with a
+few comparisons and additions, so the result is ready at Hide without a pass
+over the values. tsadj_PublishAdjustmentResult writes it as one number array,
+the elements are in the order of the STEPRESULT_xxx indices. It is part of
+the memory block of a resource and never allocates.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef STEPRESULT_H
+#define STEPRESULT_H
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+/* Elements of the published array */
+#define STEPRESULT_FINAL_VALUE      0   /* last value, 0.0 without values  */
+#define STEPRESULT_MINIMUM          1   /* smallest value seen             */
+#define STEPRESULT_MAXIMUM          2   /* largest value seen              */
+#define STEPRESULT_TIME_IN_LIMITS   3   /* s a value in limits was shown   */
+#define STEPRESULT_CROSSINGS        4   /* changes between in and out      */
+#define STEPRESULT_TIME_TO_CONFIRM  5   /* s Display end -> button, -1 ->
+                                           not confirmed                    */
+#define STEPRESULT_VALUES           6   /* values passed to SetValue       */
+#define STEPRESULT_FIELDS           7
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+typedef struct
+{
+   long lValues;                 /* values since StepResult_Begin        */
+   double dLastValue;
+   double dMinimum;
+   double dMaximum;
+   int iLastPassed;              /* last value within the limits         */
+   double dLastTime;             /* time stamp of the last value         */
+   double dTimeInLimits;         /* s up to dLastTime                    */
+   long lCrossings;
+} STEP_RESULT;
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+void StepResult_Begin(STEP_RESULT *pResult);
+void StepResult_Add(STEP_RESULT *pResult, double dTime, double dValue,
+        int iPassed);
+void StepResult_Get(const STEP_RESULT *pResult, double dTime,
+        double dDisplayEnd, double dButtonTime,
+        double dFields[STEPRESULT_FIELDS]);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
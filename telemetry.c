@@ -0,0 +1,309 @@
+/*******************************************************************************/
+/**
+@file telemetry.c
+*
+@brief Writer side of the live value telemetry channel
+*
+The mapping is created on the first slot claim and kept until the DLL is
+unloaded, so monitors attached to it do not lose their view between two
+UUTs. Claiming and releasing a slot is done in tsadj_Setup / tsadj_Cleanup,
+the publish functions are called from the panel functions and only do a
+handful of stores between the two sequence counter increments.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <windows.h>
+#include <ansi_c.h>
+
+#include "telemetry.h"
+
+/* GLOBAL VARIABLES DEFINITION ************************************************/
+static HANDLE ghTelemetryMapping = NULL;
+static TELEMETRY_REGION *gpTelemetryRegion = NULL;
+static CRITICAL_SECTION gTelemetryLock;
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static TELEMETRY_REGION *OpenRegion(void);
+static int ProcessExited(LONG lProcessId);
+static void FillSlot(TELEMETRY_SLOT *pSlot, long lResourceId);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Telemetry_Initialize:  called once by the first exported function
+ *******************************************************************************/
+void Telemetry_Initialize(void)
+{
+   InitializeCriticalSection(&gTelemetryLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Telemetry_Close:  unmaps the region, called when the DLL is unloaded
+ *******************************************************************************/
+void Telemetry_Close(void)
+{
+   if (gpTelemetryRegion != NULL)
+   {
+      UnmapViewOfFile(gpTelemetryRegion);
+      gpTelemetryRegion = NULL;
+   }
+   if (ghTelemetryMapping != NULL)
+   {
+      CloseHandle(ghTelemetryMapping);
+      ghTelemetryMapping = NULL;
+   }
+   DeleteCriticalSection(&gTelemetryLock);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Telemetry_ClaimSlot:  reserves a free slot for a resource
+ *
+The slot keeps the process ID of its owner in lClaimed. If no slot is free,
+the slots of processes that have ended without Cleanup, e.g. a crashed
+TestStand while a monitor kept the mapping open, are taken over.
+ *
+@param lResourceId:  resource ID, only published for the monitor
+ *
+@return              slot index or -1 if the channel is not available
+ *******************************************************************************/
+int Telemetry_ClaimSlot(long lResourceId)
+{
+   TELEMETRY_REGION *pRegion;
+   TELEMETRY_SLOT *pSlot;
+   LONG lOwnProcess = (LONG)GetCurrentProcessId();
+   LONG lOwner;
+   int idx;
+
+   pRegion = OpenRegion();
+   if (pRegion == NULL)
+   {
+      return -1;
+   }
+
+   for (idx = 0; idx < TELEMETRY_SLOTS; idx++)
+   {
+      pSlot = &pRegion->slots[idx];
+      if (InterlockedCompareExchange(&pSlot->lClaimed, lOwnProcess, 0) == 0)
+      {
+         FillSlot(pSlot, lResourceId);
+         return idx;
+      }
+   }
+
+   for (idx = 0; idx < TELEMETRY_SLOTS; idx++)
+   {
+      pSlot = &pRegion->slots[idx];
+      lOwner = pSlot->lClaimed;
+      /* the exchange makes one process the new owner of the slot */
+      if ((lOwner != 0) && (lOwner != lOwnProcess) && ProcessExited(lOwner)
+         && (InterlockedCompareExchange(&pSlot->lClaimed, lOwnProcess,
+         lOwner) == lOwner))
+      {
+         /* the owner may have died between the two increments */
+         if (pSlot->lSequence & 1)
+         {
+            InterlockedIncrement(&pSlot->lSequence);
+         }
+         FillSlot(pSlot, lResourceId);
+         return idx;
+      }
+   }
+   return -1;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Telemetry_ReleaseSlot:  gives a slot back, iSlot may be -1
+ *******************************************************************************/
+void Telemetry_ReleaseSlot(int iSlot)
+{
+   TELEMETRY_SLOT *pSlot;
+
+   if ((iSlot < 0) || (gpTelemetryRegion == NULL))
+   {
+      return;
+   }
+   pSlot = &gpTelemetryRegion->slots[iSlot];
+
+   InterlockedIncrement(&pSlot->lSequence);
+   pSlot->lState = TELEMETRY_STATE_FREE;
+   GetSystemTimeAsFileTime(&pSlot->ftTimeStamp);
+   InterlockedIncrement(&pSlot->lSequence);
+   InterlockedExchange(&pSlot->lClaimed, 0);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Telemetry_PublishConfig:  publishes step name and limits of a new panel
+ *******************************************************************************/
+void Telemetry_PublishConfig(int iSlot, const char *pStepName,
+   double dLowerLimit, double dUpperLimit, long lState)
+{
+   TELEMETRY_SLOT *pSlot;
+
+   if ((iSlot < 0) || (gpTelemetryRegion == NULL))
+   {
+      return;
+   }
+   pSlot = &gpTelemetryRegion->slots[iSlot];
+
+   InterlockedIncrement(&pSlot->lSequence);
+   strncpy(pSlot->cStepName, pStepName, TELEMETRY_STEPNAME_LENGTH - 1);
+   pSlot->cStepName[TELEMETRY_STEPNAME_LENGTH - 1] = '\0';
+   pSlot->dLowerLimit = dLowerLimit;
+   pSlot->dUpperLimit = dUpperLimit;
+   pSlot->lState = lState;
+   pSlot->lPassed = 0;
+   pSlot->lUpdateCount = 0;
+   GetSystemTimeAsFileTime(&pSlot->ftTimeStamp);
+   InterlockedIncrement(&pSlot->lSequence);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Telemetry_PublishState:  changes the state of a slot only
+ *******************************************************************************/
+void Telemetry_PublishState(int iSlot, long lState)
+{
+   TELEMETRY_SLOT *pSlot;
+
+   if ((iSlot < 0) || (gpTelemetryRegion == NULL))
+   {
+      return;
+   }
+   pSlot = &gpTelemetryRegion->slots[iSlot];
+
+   InterlockedIncrement(&pSlot->lSequence);
+   pSlot->lState = lState;
+   GetSystemTimeAsFileTime(&pSlot->ftTimeStamp);
+   InterlockedIncrement(&pSlot->lSequence);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Telemetry_PublishValue:  publishes a new value and its limit check result
+ *******************************************************************************/
+void Telemetry_PublishValue(int iSlot, double dValue, int iPassed)
+{
+   TELEMETRY_SLOT *pSlot;
+
+   if ((iSlot < 0) || (gpTelemetryRegion == NULL))
+   {
+      return;
+   }
+   pSlot = &gpTelemetryRegion->slots[iSlot];
+
+   InterlockedIncrement(&pSlot->lSequence);
+   pSlot->dValue = dValue;
+   pSlot->lPassed = iPassed;
+   pSlot->lUpdateCount++;
+   GetSystemTimeAsFileTime(&pSlot->ftTimeStamp);
+   InterlockedIncrement(&pSlot->lSequence);
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+FillSlot:  publishes a claimed slot as set up and idle
+ *******************************************************************************/
+static void FillSlot(TELEMETRY_SLOT *pSlot, long lResourceId)
+{
+   InterlockedIncrement(&pSlot->lSequence);
+   pSlot->lProcessId = (LONG)GetCurrentProcessId();
+   pSlot->lResourceId = lResourceId;
+   pSlot->lState = TELEMETRY_STATE_IDLE;
+   pSlot->lPassed = 0;
+   pSlot->lUpdateCount = 0;
+   pSlot->dValue = 0.0;
+   pSlot->dLowerLimit = 0.0;
+   pSlot->dUpperLimit = 0.0;
+   GetSystemTimeAsFileTime(&pSlot->ftTimeStamp);
+   pSlot->cStepName[0] = '\0';
+   InterlockedIncrement(&pSlot->lSequence);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ProcessExited:  checks whether the owner of a slot still runs
+ *
+@return      TRUE if the process has ended, FALSE if it runs or cannot be
+             checked, e.g. it belongs to another user
+ *******************************************************************************/
+static int ProcessExited(LONG lProcessId)
+{
+   HANDLE hProcess;
+   int iExited;
+
+   hProcess = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)lProcessId);
+   if (hProcess == NULL)
+   {
+      /* no process with this ID any more */
+      return GetLastError() == ERROR_INVALID_PARAMETER;
+   }
+   iExited = (WaitForSingleObject(hProcess, 0) == WAIT_OBJECT_0);
+   CloseHandle(hProcess);
+   return iExited;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+OpenRegion:  creates or opens the named mapping on first use
+ *
+@return      pointer to the region or NULL if the mapping is not available
+             or has been created by an incompatible library version
+ *******************************************************************************/
+static TELEMETRY_REGION *OpenRegion(void)
+{
+   TELEMETRY_REGION *pRegion;
+
+   EnterCriticalSection(&gTelemetryLock);
+   if (gpTelemetryRegion == NULL)
+   {
+      ghTelemetryMapping = CreateFileMapping(INVALID_HANDLE_VALUE, NULL,
+         PAGE_READWRITE, 0, sizeof(TELEMETRY_REGION), TELEMETRY_MAPPING_NAME);
+      if (ghTelemetryMapping != NULL)
+      {
+         pRegion = (TELEMETRY_REGION *)MapViewOfFile(ghTelemetryMapping,
+            FILE_MAP_WRITE, 0, 0, sizeof(TELEMETRY_REGION));
+         if (pRegion != NULL)
+         {
+            /* a new mapping is zero filled; concurrent creators write the
+               same values, so no further synchronisation is needed */
+            if (pRegion->lMagic == 0)
+            {
+               pRegion->lVersion = TELEMETRY_VERSION;
+               pRegion->lSlotCount = TELEMETRY_SLOTS;
+               pRegion->lSlotSize = sizeof(TELEMETRY_SLOT);
+               InterlockedExchange(&pRegion->lMagic, TELEMETRY_MAGIC);
+            }
+            if ((pRegion->lMagic == TELEMETRY_MAGIC)
+               && (pRegion->lVersion == TELEMETRY_VERSION)
+               && (pRegion->lSlotSize == sizeof(TELEMETRY_SLOT)))
+            {
+               gpTelemetryRegion = pRegion;
+            }
+            else
+            {
+               UnmapViewOfFile(pRegion);
+            }
+         }
+         if (gpTelemetryRegion == NULL)
+         {
+            CloseHandle(ghTelemetryMapping);
+            ghTelemetryMapping = NULL;
+         }
+      }
+   }
+   pRegion = gpTelemetryRegion;
+   LeaveCriticalSection(&gTelemetryLock);
+
+   return pRegion;
+}
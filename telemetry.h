@@ -0,0 +1,113 @@
+/*******************************************************************************/
+/**
+@file telemetry.h
+*
+@brief Shared memory layout of the live value telemetry channel
+*
+The adjustment library publishes the state of every resource that has the
+"Telemetry" key enabled into a named file mapping. External monitors open
+the mapping read-only and read the slots at their own pace. Each slot is
+protected by a sequence counter: the writer makes it odd before and even
+after an update, a reader retries while the counter is odd or has changed
+during the copy. The writer never waits for a reader.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+/* INCLUDE FILES ***************************************************************/
+#include <windows.h>
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define TELEMETRY_MAPPING_NAME      "Local\\TSADJ_Telemetry"
+#define TELEMETRY_MAGIC             0x4A444154  /* "TADJ" */
+#define TELEMETRY_VERSION           1
+#define TELEMETRY_SLOTS             64
+#define TELEMETRY_STEPNAME_LENGTH   128
+
+/* Slot states */
+#define TELEMETRY_STATE_FREE        0   /* slot not claimed             */
+#define TELEMETRY_STATE_IDLE        1   /* resource set up, no panel    */
+#define TELEMETRY_STATE_ACTIVE      2   /* adjustment panel displayed   */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+/* One slot per resource, 192 bytes, doubles 8 byte aligned */
+typedef struct
+{
+   volatile LONG lSequence;  /* odd while the writer updates the slot   */
+   volatile LONG lClaimed;   /* 0 -> free, else process ID of the owner */
+   LONG lProcessId;          /* process of the writer                   */
+   LONG lResourceId;         /* RESMGR resource ID in the writer process */
+   LONG lState;              /* TELEMETRY_STATE_xxx                     */
+   LONG lPassed;             /* 1 -> last value within the limits       */
+   LONG lUpdateCount;        /* number of values published              */
+   LONG lReserved;
+   double dValue;            /* last value                              */
+   double dLowerLimit;
+   double dUpperLimit;
+   FILETIME ftTimeStamp;     /* system time of the last update (UTC)    */
+   char cStepName[TELEMETRY_STEPNAME_LENGTH];
+} TELEMETRY_SLOT;
+
+typedef struct
+{
+   LONG lMagic;              /* TELEMETRY_MAGIC                         */
+   LONG lVersion;            /* TELEMETRY_VERSION                       */
+   LONG lSlotCount;          /* TELEMETRY_SLOTS                         */
+   LONG lSlotSize;           /* sizeof(TELEMETRY_SLOT)                  */
+   LONG lReserved[4];
+   TELEMETRY_SLOT slots[TELEMETRY_SLOTS];
+} TELEMETRY_REGION;
+
+/* GLOBAL FUNCTION DECLARATIONS (writer side, tsadj.dll internal) *************/
+
+void Telemetry_Initialize(void);
+void Telemetry_Close(void);
+int  Telemetry_ClaimSlot(long lResourceId);
+void Telemetry_ReleaseSlot(int iSlot);
+void Telemetry_PublishConfig(int iSlot, const char *pStepName,
+   double dLowerLimit, double dUpperLimit, long lState);
+void Telemetry_PublishState(int iSlot, long lState);
+void Telemetry_PublishValue(int iSlot, double dValue, int iPassed);
+
+/* READER SIDE ****************************************************************/
+
+/* Define TELEMETRY_READER before including this file in a monitor program
+   to get a consistent copy of a slot. Returns 1 if the slot was copied,
+   0 if it is free or the writer kept it busy for all retries. */
+#ifdef TELEMETRY_READER
+static int Telemetry_ReadSlot(const TELEMETRY_REGION *pRegion, int iSlot,
+   TELEMETRY_SLOT *pCopy)
+{
+   const TELEMETRY_SLOT *pSlot = &pRegion->slots[iSlot];
+   LONG lBefore;
+   int iRetry;
+
+   for (iRetry = 0; iRetry < 1000; iRetry++)
+   {
+      lBefore = pSlot->lSequence;
+      if (lBefore & 1)
+      {
+         continue;
+      }
+      MemoryBarrier();
+      memcpy(pCopy, (const void *)pSlot, sizeof(TELEMETRY_SLOT));
+      MemoryBarrier();
+      if (pSlot->lSequence == lBefore)
+      {
+         return pCopy->lClaimed != 0;
+      }
+   }
+   return 0;
+}
+#endif
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
@@ -0,0 +1,50 @@
+/*******************************************************************************/
+/**
+@file headless.h
+*
+@brief The CVI and Win32 names of ../panelview.c for a build without either
+*
+../panelview.c includes this file instead of windows.h, userint.h and
+testadjustmentpanel.h when PANELVIEW_HEADLESS is defined, tsadjreplay.c
+includes it for the names it prints. The values only have to differ from
+each other, the output of the tools shows names. The tools run in one thread,
+so the interlocked functions are plain assignments.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+/* windows.h */
+#define TRUE                      1
+#define FALSE                     0
+
+/* userint.h */
+#define VAL_RED                   0xFF0000L
+#define VAL_GREEN                 0x00FF00L
+#define VAL_DECIMAL_FORMAT        0
+#define VAL_FLOATING_PT_FORMAT    1
+#define VAL_SCIENTIFIC_FORMAT     2
+#define ATTR_TEXT_BGCOLOR         1
+
+/* testadjustmentpanel.h */
+#define ADJUSTMENT_INDICATOR      2
+#define ADJUSTMENT_BACKGROUND     7
+
+/* GLOBAL MACRO DEFINITIONS ***************************************************/
+
+/* windows.h, one thread: the exchange happens at once */
+#define InterlockedExchange(plTarget, lValue)  (*(plTarget) = (lValue))
+#define InterlockedCompareExchange(plTarget, lExchange, lComparand) \
+   ((*(plTarget) == (lComparand)) ? (*(plTarget) = (lExchange), (lComparand)) \
+   : *(plTarget))
+#define Sleep(dwMilliseconds)
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
@@ -0,0 +1,430 @@
+/*******************************************************************************/
+/**
+@file tsadjpanelsrv.c
+*
+@brief Adjustment panel server for resources with the "PanelServer" key
+*
+Usage: tsadjpanelsrv [-headless]
+The server shows the adjustment panels of all TestStand processes of the
+machine, one panel per pipe connection. Every connection is served by its own
+thread, which also owns the panel of the connection. A hanging panel blocks
+only its own connection, the library runs into PANELIPC_TIMEOUT and reports
+an error instead of waiting.
+The library sends the panel commands of its PANEL_VIEW with every value, so
+the server only executes them, like the panel thread of the library does.
+With -headless no panel is created. The commands are written to stdout and
+the button is reported as pressed after the first value within the limits,
+so sequences can be run without an operator.
+Build as a console application together with ../adjustmentpanel.c.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <userint.h>
+
+#include "../panelipc.h"
+#include "../panelqueue.h"
+#include "../definitions.h"
+#include "../testadjustmentpanel.h"
+
+/* LOCAL DEFINES **************************************************************/
+#define POLL_INTERVAL   10     /* ms between two checks for a command */
+
+/* LOCAL TYPE DEFINITIONS *****************************************************/
+
+typedef struct
+{
+   HANDLE hPipe;
+   int iPanel;                 /* 0 -> no panel displayed             */
+   volatile LONG lButtonHit;   /* set by AdjustmentCallback           */
+   int iDemoMode;
+   double dLowerLimit;
+   double dUpperLimit;
+} CONNECTION;
+
+/* GLOBAL VARIABLES DEFINITION ************************************************/
+static int giHeadless = FALSE;
+static volatile LONG glConnections = 0;
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static DWORD WINAPI ConnectionThread(LPVOID pParameter);
+static int ReadCommand(CONNECTION *pConnection, PANELIPC_MESSAGE *pMessage);
+static void Execute(CONNECTION *pConnection, const PANELIPC_MESSAGE *pMessage,
+   PANELIPC_REPLY *pReply);
+static int ShowPanel(CONNECTION *pConnection, const PANELIPC_DISPLAY_MESSAGE
+   *pMessage);
+static void ShowValue(CONNECTION *pConnection, const PANELIPC_SETVALUE_MESSAGE
+   *pMessage);
+static void ExecuteView(CONNECTION *pConnection, const PANELIPC_VIEW_COMMAND
+   *pView);
+static void DiscardConnectionPanel(CONNECTION *pConnection);
+
+/* EXPORTED FUNCTION DEFINITIONS **********************************************/
+
+int main(int argc, char *argv[])
+{
+   CONNECTION *pConnection;
+   HANDLE hPipe;
+   HANDLE hThread;
+   BOOL bConnected;
+
+   if ((argc == 2) && (strcmp(argv[1], "-headless") == 0))
+   {
+      giHeadless = TRUE;
+   }
+   else if (argc != 1)
+   {
+      fprintf(stderr, "usage: tsadjpanelsrv [-headless]\n");
+      return 2;
+   }
+
+   printf("tsadjpanelsrv: waiting on %s%s\n", PANELIPC_PIPE_NAME,
+      giHeadless ? " (headless)" : "");
+   for (;;)
+   {
+      hPipe = CreateNamedPipe(PANELIPC_PIPE_NAME, PIPE_ACCESS_DUPLEX,
+         PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
+         PIPE_UNLIMITED_INSTANCES, sizeof(PANELIPC_REPLY),
+         sizeof(PANELIPC_MESSAGE), 0, NULL);
+      if (hPipe == INVALID_HANDLE_VALUE)
+      {
+         fprintf(stderr, "cannot create %s\n", PANELIPC_PIPE_NAME);
+         return 1;
+      }
+      bConnected = ConnectNamedPipe(hPipe, NULL) ? TRUE : (GetLastError()
+         == ERROR_PIPE_CONNECTED);
+      if (!bConnected)
+      {
+         CloseHandle(hPipe);
+         continue;
+      }
+
+      pConnection = (CONNECTION *)calloc(1, sizeof(CONNECTION));
+      if (pConnection == NULL)
+      {
+         DisconnectNamedPipe(hPipe);
+         CloseHandle(hPipe);
+         continue;
+      }
+      pConnection->hPipe = hPipe;
+      hThread = CreateThread(NULL, 0, ConnectionThread, pConnection, 0, NULL);
+      if (hThread == NULL)
+      {
+         DisconnectNamedPipe(hPipe);
+         CloseHandle(hPipe);
+         free(pConnection);
+         continue;
+      }
+      CloseHandle(hThread);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+AdjustmentCallback:  button of a panel, runs in the thread of the connection
+ *******************************************************************************/
+int CVICALLBACK AdjustmentCallback(int panel, int control, int event,
+   void *callbackData, int eventData1, int eventData2)
+{
+   if (event == EVENT_COMMIT)
+   {
+      InterlockedExchange((LONG *)callbackData, 1);
+   }
+   return 0;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+ConnectionThread:  serves one library resource until it disconnects
+ *******************************************************************************/
+static DWORD WINAPI ConnectionThread(LPVOID pParameter)
+{
+   CONNECTION *pConnection = (CONNECTION *)pParameter;
+   PANELIPC_MESSAGE message;
+   PANELIPC_REPLY reply;
+   DWORD dwWritten;
+
+   printf("connection %ld opened\n", InterlockedIncrement(&glConnections));
+   while (ReadCommand(pConnection, &message))
+   {
+      Execute(pConnection, &message, &reply);
+      if (!WriteFile(pConnection->hPipe, &reply, sizeof(reply), &dwWritten,
+         NULL))
+      {
+         break;
+      }
+   }
+   printf("connection closed, %ld left\n",
+      InterlockedDecrement(&glConnections));
+
+   DiscardConnectionPanel(pConnection);
+   DisconnectNamedPipe(pConnection->hPipe);
+   CloseHandle(pConnection->hPipe);
+   free(pConnection);
+   return 0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ReadCommand:  waits for the next command, keeps the panel responsive
+ *
+@return       FALSE if the library has closed the connection
+ *******************************************************************************/
+static int ReadCommand(CONNECTION *pConnection, PANELIPC_MESSAGE *pMessage)
+{
+   DWORD dwAvailable;
+   DWORD dwRead;
+
+   for (;;)
+   {
+      if (!PeekNamedPipe(pConnection->hPipe, NULL, 0, NULL, &dwAvailable,
+         NULL))
+      {
+         return FALSE;
+      }
+      if (dwAvailable > 0)
+      {
+         break;
+      }
+      if (pConnection->iPanel > 0)
+      {
+         ProcessSystemEvents();
+      }
+      Sleep(POLL_INTERVAL);
+   }
+
+   memset(pMessage, 0, sizeof(PANELIPC_MESSAGE));
+   if (!ReadFile(pConnection->hPipe, pMessage, sizeof(PANELIPC_MESSAGE),
+      &dwRead, NULL)
+      || (dwRead < sizeof(PANELIPC_COMMAND)))
+   {
+      return FALSE;
+   }
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Execute:  runs one command of the library
+ *******************************************************************************/
+static void Execute(CONNECTION *pConnection, const PANELIPC_MESSAGE *pMessage,
+   PANELIPC_REPLY *pReply)
+{
+   const PANELIPC_COMMAND *pCommand = &pMessage->command;
+
+   pReply->lStatus = PANELIPC_STATUS_OK;
+   switch (pCommand->lCommand)
+   {
+      case PANELIPC_CMD_HELLO:
+         if ((LONG)pCommand->dValue != PANELIPC_VERSION)
+         {
+            pReply->lStatus = PANELIPC_STATUS_VERSION;
+         }
+         break;
+
+      case PANELIPC_CMD_DISPLAY:
+         pConnection->lButtonHit = 0;
+         pConnection->iDemoMode = (pCommand->lFlags & PANELIPC_FLAG_DEMO)
+            != 0;
+         pConnection->dLowerLimit = pCommand->dLowerLimit;
+         pConnection->dUpperLimit = pCommand->dUpperLimit;
+         if (!ShowPanel(pConnection, &pMessage->display))
+         {
+            pReply->lStatus = PANELIPC_STATUS_FAILED;
+         }
+         break;
+
+      case PANELIPC_CMD_SETVALUE:
+         ShowValue(pConnection, &pMessage->setValue);
+         break;
+
+      case PANELIPC_CMD_HIDE:
+         if (giHeadless)
+         {
+            printf("hide\n");
+         }
+         DiscardConnectionPanel(pConnection);
+         break;
+
+      default:
+         pReply->lStatus = PANELIPC_STATUS_FAILED;
+         break;
+   }
+   pReply->lButtonHit = pConnection->lButtonHit;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ShowPanel:  creates the panel of the connection and sets the texts
+ *
+@return     FALSE if the panel could not be created
+ *******************************************************************************/
+static int ShowPanel(CONNECTION *pConnection, const PANELIPC_DISPLAY_MESSAGE
+   *pMessage)
+{
+   const PANELIPC_DISPLAY_TEXT *pText = &pMessage->text;
+   int iPanel;
+
+   if (giHeadless)
+   {
+      printf("display \"%.*s\" %s %s\n", PANELIPC_STEPNAME_LENGTH,
+         pText->cStepName, pText->cLowerLimit, pText->cUpperLimit);
+      return TRUE;
+   }
+
+   DiscardConnectionPanel(pConnection);
+   iPanel = CreateAdjustmentPanel();
+   if (iPanel < 0)
+   {
+      return FALSE;
+   }
+   pConnection->iPanel = iPanel;
+
+   ConfigureAdjustmentPanel(iPanel, pMessage);
+   SetCtrlAttribute(iPanel, ADJUSTMENT_OK, ATTR_CALLBACK_DATA,
+      (void *)&pConnection->lButtonHit);
+
+   DisplayPanel(iPanel);
+   ProcessDrawEvents();
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ShowValue:  executes the view commands of a value
+ *
+The library has decided range, indicator, trend and colour; without
+commands the panel already shows the value.
+ *******************************************************************************/
+static void ShowValue(CONNECTION *pConnection, const PANELIPC_SETVALUE_MESSAGE
+   *pMessage)
+{
+   double dValue = pMessage->command.dValue;
+   int iPassed = (dValue >= pConnection->dLowerLimit)
+      && (dValue <= pConnection->dUpperLimit);
+   int iCount = pMessage->lCount;
+   int idx;
+
+   if ((iCount < 0) || (iCount > PANELIPC_VIEW_COMMANDS))
+   {
+      iCount = 0;
+   }
+   if (giHeadless)
+   {
+      printf("value %.12g %s\n", dValue, iPassed ? "pass" : "fail");
+      for (idx = 0; idx < iCount; idx++)
+      {
+         ExecuteView(pConnection, &pMessage->view[idx]);
+      }
+      if (iPassed)
+      {
+         /* the stand-in operator confirms the first value in the window */
+         pConnection->lButtonHit = 1;
+      }
+      return;
+   }
+   if (pConnection->iPanel <= 0)
+   {
+      return;
+   }
+
+   for (idx = 0; idx < iCount; idx++)
+   {
+      ExecuteView(pConnection, &pMessage->view[idx]);
+   }
+   if (pConnection->iDemoMode)
+   {
+      SetCtrlVal(pConnection->iPanel, ADJUSTMENT_TEXT,
+         "Adjustment panel in demo mode");
+      SetCtrlAttribute(pConnection->iPanel, ADJUSTMENT_BACKGROUND,
+         ATTR_TEXT_BGCOLOR, VAL_MAGENTA);
+      SetCtrlVal(pConnection->iPanel, ADJUSTMENT_INDICATOR, -1.0);
+   }
+   ProcessDrawEvents();
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ExecuteView:  one view command, as ExecuteCommand of the library does
+ *******************************************************************************/
+static void ExecuteView(CONNECTION *pConnection, const PANELIPC_VIEW_COMMAND
+   *pView)
+{
+   char cText[PANELIPC_TEXT_LENGTH];
+   int iPanel = pConnection->iPanel;
+
+   switch (pView->lCommand)
+   {
+      case PANELQUEUE_CMD_VALUE:
+         if (giHeadless)
+         {
+            printf("   set %ld %.12g\n", pView->lCtrl, pView->dValue);
+            break;
+         }
+         SetCtrlVal(iPanel, pView->lCtrl, pView->dValue);
+         break;
+
+      case PANELQUEUE_CMD_TEXT:
+         strncpy(cText, pView->cText, PANELIPC_TEXT_LENGTH - 1);
+         cText[PANELIPC_TEXT_LENGTH - 1] = '\0';
+         if (giHeadless)
+         {
+            printf("   text %ld \"%s\"\n", pView->lCtrl, cText);
+            break;
+         }
+         SetCtrlVal(iPanel, pView->lCtrl, cText);
+         break;
+
+      case PANELQUEUE_CMD_ATTRIBUTE:
+         if (giHeadless)
+         {
+            printf("   attribute %ld %ld %ld\n", pView->lCtrl,
+               pView->lAttribute, pView->lValue);
+            break;
+         }
+         SetCtrlAttribute(iPanel, pView->lCtrl, pView->lAttribute,
+            pView->lValue);
+         break;
+
+      case PANELQUEUE_CMD_SCALE:
+         if (giHeadless)
+         {
+            printf("   scale %.12g %.12g\n", pView->dValue, pView->dMaximum);
+            break;
+         }
+         SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_MIN_VALUE,
+            pView->dValue);
+         SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_MAX_VALUE,
+            pView->dMaximum);
+         break;
+
+      default:
+         break;
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+DiscardConnectionPanel:  removes the panel of the connection, if any
+ *******************************************************************************/
+static void DiscardConnectionPanel(CONNECTION *pConnection)
+{
+   if (giHeadless)
+   {
+      return;
+   }
+   if (pConnection->iPanel > 0)
+   {
+      DiscardPanel(pConnection->iPanel);
+      pConnection->iPanel = 0;
+   }
+}
@@ -0,0 +1,108 @@
+/*******************************************************************************/
+/**
+@file tsadjrec2csv.c
+*
+@brief Converts a tsadj value recording (*.tsadjrec) into a CSV file
+*
+Usage: tsadjrec2csv <recording> [<csv file>]
+Without a CSV file name the output is written to stdout. Build as a console
+application together with ../recorder.h, no other file of the library is
+needed.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "../recorder.h"
+
+/* EXPORTED FUNCTION DEFINITIONS **********************************************/
+
+int main(int argc, char *argv[])
+{
+   RECORDER_FILE_HEADER header;
+   RECORDER_RECORD record;
+   RECORDER_RECORD_V1 recordV1;
+   FILE *pIn;
+   FILE *pOut = stdout;
+   long lCount = 0;
+
+   if ((argc < 2) || (argc > 3))
+   {
+      fprintf(stderr, "usage: tsadjrec2csv <recording> [<csv file>]\n");
+      return 2;
+   }
+
+   pIn = fopen(argv[1], "rb");
+   if (pIn == NULL)
+   {
+      fprintf(stderr, "cannot open %s\n", argv[1]);
+      return 1;
+   }
+   if ((fread(&header, sizeof(header), 1, pIn) != 1)
+      || (memcmp(header.cMagic, RECORDER_MAGIC, sizeof(header.cMagic)) != 0)
+      || !(((header.lVersion == RECORDER_VERSION)
+      && (header.lRecordSize == sizeof(RECORDER_RECORD)))
+      || ((header.lVersion == 1)
+      && (header.lRecordSize == sizeof(RECORDER_RECORD_V1)))))
+   {
+      fprintf(stderr, "%s is not a version 1 .. %d recording\n", argv[1],
+         RECORDER_VERSION);
+      fclose(pIn);
+      return 1;
+   }
+   /* skip a larger header of a later version */
+   fseek(pIn, header.lHeaderSize, SEEK_SET);
+
+   if (argc == 3)
+   {
+      pOut = fopen(argv[2], "w");
+      if (pOut == NULL)
+      {
+         fprintf(stderr, "cannot create %s\n", argv[2]);
+         fclose(pIn);
+         return 1;
+      }
+   }
+
+   header.cUUT[RECORDER_UUT_LENGTH - 1] = '\0';
+   header.cStepName[RECORDER_STEPNAME_LENGTH - 1] = '\0';
+   fprintf(pOut, "# UUT: %s\n# Step: %s\n", header.cUUT, header.cStepName);
+   fprintf(pOut, "Time [s];Value;Raw value;Passed\n");
+   if (header.lVersion == 1)
+   {
+      /* no filter before version 2, the raw value is the value */
+      while (fread(&recordV1, sizeof(recordV1), 1, pIn) == 1)
+      {
+         fprintf(pOut, "%.6f;%.12g;%.12g;%ld\n", recordV1.dTime,
+            recordV1.dValue, recordV1.dValue, (long)recordV1.lPassed);
+         lCount++;
+      }
+   }
+   else
+   {
+      while (fread(&record, sizeof(record), 1, pIn) == 1)
+      {
+         fprintf(pOut, "%.6f;%.12g;%.12g;%ld\n", record.dTime,
+            record.dValue, record.dRawValue, (long)record.lPassed);
+         lCount++;
+      }
+   }
+
+   fclose(pIn);
+   if (pOut != stdout)
+   {
+      fclose(pOut);
+   }
+   fprintf(stderr, "%ld records converted\n", lCount);
+   if (header.lDropped > 0)
+   {
+      fprintf(stderr, "%ld records were dropped while recording\n",
+         (long) header.lDropped);
+   }
+   return 0;
+}
@@ -0,0 +1,735 @@
+/*******************************************************************************/
+/**
+@file tsadjreplay.c
+*
+@brief Replays a trace or a value recording through the SetValue pipeline
+*
+Usage: tsadjreplay [<option> <value>] ... <input> [<golden file>]
+   -limits <LL> <UL>   limits of the step (required for a recording)
+   -format <format>    format of the values ("%.6g")
+   -unit <unit>        unit of the values (none)
+   -transform <text>   transform of the readings, see ../transform.h (none)
+   -filter <name>      EMA, Mean, Median or none (none)
+   -window <n>         filter window (8)
+   -hysteresis <h>     pass/fail colour hysteresis, value unit (0)
+   -autozoom <0|1>     slider range follows the value (0)
+   -async <s>          the panel is shown s after Display, values before are
+                       kept as by tsadj_DisplayAdjustmentPanelAsync (0)
+The input is a recording (*.tsadjrec) of a resource with the "Recorder" key
+or a trace, a text file with one call per line, '#' starts a comment:
+   display <LL> <UL> <format> <unit> [<hysteresis> [<autozoom>]]
+   value <time> <reading>
+   button <time>
+   transform <text>      for the next display, "-" -> none
+   filter <name> [<window>]
+   async <s>
+The unit "-" stands for none, times are in s since the Display. Limits,
+format and unit of a trace are those of its display lines, the other options
+are the settings before the first line.
+Every reading takes the way of tsadj_SetValueAdjustmentPanel: transform and
+filter, the pending commands before the panel is shown, and PanelView_Update.
+For every call the texts, the colour decision and the panel commands the
+library would queue are written to stdout. The raw value of a recording is
+the last reading of the call, the filtered value of the recording is compared
+with the replayed one, differences are written and counted; a filter sees
+the other readings of a burst only in the original run.
+With a golden file the output is compared with it line by line, the first
+difference is reported and the exit code is 1. A golden file is made by
+redirecting the output of a reviewed replay. replay/ holds the examples:
+   tsadjreplay replay/hysteresis.trace replay/hysteresis.golden
+   tsadjreplay -limits -1 1 -format %.3f -transform "percent=10; unit=%"
+      -filter EMA -window 4 -async 0.2 replay/reference.tsadjrec
+      replay/reference.golden
+Every reading goes through PanelView_SetValue, which the library calls for
+tsadj_SetValueAdjustmentPanel as well. The tool needs neither CVI nor
+Windows: build it as a console application together with ../panelview.c,
+../trend.c, ../filter.c and ../transform.c, with PANELVIEW_HEADLESS defined
+for ../panelview.c, e.g.
+   cc -DPANELVIEW_HEADLESS -o tsadjreplay tsadjreplay.c ../panelview.c
+      ../trend.c ../filter.c ../transform.c -lm
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "headless.h"
+#include "../panelview.h"
+#include "../filter.h"
+#include "../transform.h"
+#include "../trend.h"
+
+/* LOCAL DEFINES **************************************************************/
+#define REPLAY_LINE_LENGTH    256
+#define REPLAY_DIFFERENCE     1e-9   /* relative, recorded vs replayed value */
+
+/* The file layout of ../recorder.h, which needs the Windows headers */
+#define REPLAY_MAGIC          "TSADJREC"
+#define REPLAY_VERSION        2      /* 1: records without raw value */
+#define REPLAY_UUT_LENGTH     64
+#define REPLAY_STEPNAME_LENGTH 128
+
+/* LOCAL TYPE DEFINITIONS *****************************************************/
+
+/* RECORDER_RECORD, 32 bytes, int has the 32 bits of a LONG */
+typedef struct
+{
+   double dTime;
+   double dValue;
+   double dRawValue;
+   int lPassed;
+   int lReserved;
+} REPLAY_RECORD;
+
+/* RECORDER_RECORD_V1, 24 bytes */
+typedef struct
+{
+   double dTime;
+   double dValue;
+   int lPassed;
+   int lReserved;
+} REPLAY_RECORD_V1;
+
+/* RECORDER_FILE_HEADER, 224 bytes */
+typedef struct
+{
+   char cMagic[8];
+   int lVersion;
+   int lHeaderSize;
+   int lRecordSize;
+   int lDropped;
+   unsigned int ulStart[2];   /* FILETIME */
+   char cUUT[REPLAY_UUT_LENGTH];
+   char cStepName[REPLAY_STEPNAME_LENGTH];
+} REPLAY_FILE_HEADER;
+
+/* The part of a bench SetValue works on */
+typedef struct
+{
+   PANEL_VIEW view;
+   FILTER filter;
+   TRANSFORM transform;
+   volatile long lPending;             /* PENDING_xxx                    */
+   int iPendingCount;
+   PANEL_COMMAND pending[PANELVIEW_MAX_COMMANDS];
+   double dAsync;                      /* s from Display to the panel    */
+   int iDisplayed;
+   int iShown;
+   long lValues;
+   long lPassed;                       /* values within the limits       */
+   long lCalls;
+   long lSkipped;
+   long lKept;
+   long lDiffer;
+} REPLAY;
+
+/* LOCAL VARIABLES ************************************************************/
+static FILE *gpGolden = NULL;      /* NULL -> no comparison            */
+static long glOutputLine = 0;
+static int giDifferent = FALSE;    /* a difference has been reported   */
+
+/* Values of -filter, in the order FILTER_NONE .. FILTER_MEDIAN */
+static const char *gFilterNames[] =
+{
+   "none", "EMA", "Mean", "Median"
+};
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static int ReplayTrace(REPLAY *pReplay, FILE *pIn);
+static int ReplayRecording(REPLAY *pReplay, FILE *pIn, double dLowerLimit,
+   double dUpperLimit, const char *pFormat, const char *pUnit);
+static void Display(REPLAY *pReplay, const char *pStepName, double dLowerLimit,
+   double dUpperLimit, const char *pFormat, const char *pUnit);
+static void ShowPanel(REPLAY *pReplay, double dTime);
+static void SetValue(REPLAY *pReplay, double dTime, double dRawValue,
+   const double *pRecorded);
+static void CountResult(void *pContext, const PANELVIEW_READING *pReading,
+   double dTime);
+static int FindFilter(const char *pName);
+static const char *FormatName(int iFormat);
+static void Emit(const char *pLine);
+static void EmitCommand(const PANEL_COMMAND *pCommand);
+static void StripNewline(char *pLine);
+
+/* EXPORTED FUNCTION DEFINITIONS **********************************************/
+
+int main(int argc, char *argv[])
+{
+   static REPLAY replay;
+   char cFormat[64] = "%.6g";
+   char cUnit[32] = "";
+   char cMagic[sizeof(REPLAY_MAGIC) - 1];
+   char cOutput[REPLAY_LINE_LENGTH];
+   char cLine[REPLAY_LINE_LENGTH];
+   double dLowerLimit = 0.0;
+   double dUpperLimit = 0.0;
+   FILE *pIn;
+   int iLimits = FALSE;
+   int iFilter = FILTER_NONE;
+   int iWindow = 8;
+   int iRecording;
+   int iResult;
+   int idx;
+
+   memset(&replay, 0, sizeof(replay));
+   Transform_Compile(&replay.transform, "");
+   for (idx = 1; (idx < argc) && (argv[idx][0] == '-'); idx++)
+   {
+      if ((strcmp(argv[idx], "-limits") == 0) && (idx + 2 < argc))
+      {
+         dLowerLimit = atof(argv[++idx]);
+         dUpperLimit = atof(argv[++idx]);
+         iLimits = TRUE;
+      }
+      else if (idx + 1 >= argc)
+      {
+         break;
+      }
+      else if (strcmp(argv[idx], "-format") == 0)
+      {
+         strncpy(cFormat, argv[++idx], sizeof(cFormat) - 1);
+      }
+      else if (strcmp(argv[idx], "-unit") == 0)
+      {
+         strncpy(cUnit, argv[++idx], sizeof(cUnit) - 1);
+      }
+      else if (strcmp(argv[idx], "-transform") == 0)
+      {
+         if (Transform_Compile(&replay.transform, argv[++idx]) != 0)
+         {
+            break;
+         }
+      }
+      else if (strcmp(argv[idx], "-filter") == 0)
+      {
+         iFilter = FindFilter(argv[++idx]);
+      }
+      else if (strcmp(argv[idx], "-window") == 0)
+      {
+         iWindow = atoi(argv[++idx]);
+      }
+      else if (strcmp(argv[idx], "-hysteresis") == 0)
+      {
+         replay.view.dHysteresis = atof(argv[++idx]);
+      }
+      else if (strcmp(argv[idx], "-autozoom") == 0)
+      {
+         replay.view.iAutoZoom = atoi(argv[++idx]);
+      }
+      else if (strcmp(argv[idx], "-async") == 0)
+      {
+         replay.dAsync = atof(argv[++idx]);
+      }
+      else
+      {
+         break;
+      }
+   }
+   if ((argc - idx < 1) || (argc - idx > 2) || (iFilter < 0)
+      || (replay.dAsync < 0.0) || (dUpperLimit < dLowerLimit)
+      || (Filter_Configure(&replay.filter, iFilter, iWindow) != 0))
+   {
+      fprintf(stderr, "usage: tsadjreplay [-limits <LL> <UL>] [-format"
+         " <format>] [-unit <unit>]\n   [-transform <text>] [-filter <name>]"
+         " [-window <n>] [-hysteresis <h>]\n   [-autozoom <0|1>] [-async <s>]"
+         " <input> [<golden file>]\n");
+      return 2;
+   }
+
+   pIn = fopen(argv[idx], "rb");
+   if (pIn == NULL)
+   {
+      fprintf(stderr, "cannot open %s\n", argv[idx]);
+      return 1;
+   }
+   iRecording = (fread(cMagic, sizeof(cMagic), 1, pIn) == 1)
+      && (memcmp(cMagic, REPLAY_MAGIC, sizeof(cMagic)) == 0);
+   rewind(pIn);
+   if (iRecording && !iLimits)
+   {
+      fprintf(stderr, "%s is a recording, -limits <LL> <UL> expected\n",
+         argv[idx]);
+      fclose(pIn);
+      return 2;
+   }
+   if (argc - idx == 2)
+   {
+      gpGolden = fopen(argv[idx + 1], "r");
+      if (gpGolden == NULL)
+      {
+         fprintf(stderr, "cannot open %s\n", argv[idx + 1]);
+         fclose(pIn);
+         return 1;
+      }
+   }
+
+   if (iRecording)
+   {
+      iResult = ReplayRecording(&replay, pIn, dLowerLimit, dUpperLimit,
+         cFormat, cUnit);
+   }
+   else
+   {
+      iResult = ReplayTrace(&replay, pIn);
+   }
+   fclose(pIn);
+   if (iResult != 0)
+   {
+      if (gpGolden != NULL)
+      {
+         fclose(gpGolden);
+      }
+      return iResult;
+   }
+
+   sprintf(cOutput, "total %ld values, %ld within the limits, %ld calls, %ld"
+      " skipped, %ld kept", replay.lValues, replay.lPassed, replay.lCalls,
+      replay.lSkipped, replay.lKept);
+   if (iRecording)
+   {
+      sprintf(cOutput + strlen(cOutput), ", %ld differ from the recording",
+         replay.lDiffer);
+   }
+   Emit(cOutput);
+
+   if (gpGolden != NULL)
+   {
+      if (!giDifferent && (fgets(cLine, sizeof(cLine), gpGolden) != NULL))
+      {
+         fprintf(stderr, "golden file has more than %ld lines\n",
+            glOutputLine);
+         giDifferent = TRUE;
+      }
+      fclose(gpGolden);
+   }
+   return giDifferent ? 1 : 0;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+ReplayTrace:  runs the calls of a trace file
+ *
+Hysteresis and auto zoom are kept from display to display, as they are kept
+by a bench.
+ *
+@return       0, or 1 after a line that cannot be read
+ *******************************************************************************/
+static int ReplayTrace(REPLAY *pReplay, FILE *pIn)
+{
+   char cLine[REPLAY_LINE_LENGTH];
+   char cOutput[REPLAY_LINE_LENGTH];
+   char cFormat[64];
+   char cUnit[32];
+   char cName[16];
+   double dLowerLimit;
+   double dUpperLimit;
+   double dTime;
+   double dValue;
+   long lLine = 0;
+   int iFields;
+   int iWindow;
+   int iFilter;
+
+   while (fgets(cLine, sizeof(cLine), pIn) != NULL)
+   {
+      lLine++;
+      StripNewline(cLine);
+      if ((cLine[0] == '\0') || (cLine[0] == '#'))
+      {
+         continue;
+      }
+
+      if (strncmp(cLine, "display ", 8) == 0)
+      {
+         iFields = sscanf(cLine, "display %lf %lf %63s %31s %lf %d",
+            &dLowerLimit, &dUpperLimit, cFormat, cUnit,
+            &pReplay->view.dHysteresis, &pReplay->view.iAutoZoom);
+         if (iFields < 4)
+         {
+            fprintf(stderr, "line %ld: display <LL> <UL> <format> <unit>"
+               " [<hysteresis> [<autozoom>]] expected\n", lLine);
+            return 1;
+         }
+         if (strcmp(cUnit, "-") == 0)
+         {
+            cUnit[0] = '\0';
+         }
+         Display(pReplay, "replay", dLowerLimit, dUpperLimit, cFormat,
+            cUnit);
+      }
+      else if ((strncmp(cLine, "value ", 6) == 0) && pReplay->iDisplayed
+         && (sscanf(cLine, "value %lf %lf", &dTime, &dValue) == 2))
+      {
+         SetValue(pReplay, dTime, dValue, NULL);
+      }
+      else if ((strncmp(cLine, "button ", 7) == 0) && pReplay->iDisplayed
+         && (sscanf(cLine, "button %lf", &dTime) == 1))
+      {
+         /* the operator confirms what the background shows */
+         sprintf(cOutput, "button %.6g -> %s", dTime,
+            ((pReplay->view.iShownPassed < 0) || !pReplay->iShown) ? "no value"
+            : (pReplay->view.iShownPassed ? "green" : "red"));
+         Emit(cOutput);
+      }
+      else if ((strncmp(cLine, "transform ", 10) == 0)
+         && (Transform_Compile(&pReplay->transform, (strcmp(cLine + 10, "-")
+         == 0) ? "" : cLine + 10) == 0))
+      {
+         continue;
+      }
+      else if ((strncmp(cLine, "filter ", 7) == 0)
+         && ((iFields = sscanf(cLine, "filter %15s %d", cName, &iWindow))
+         >= 1) && ((iFilter = FindFilter(cName)) >= 0)
+         && (Filter_Configure(&pReplay->filter, iFilter, (iFields == 2)
+         ? iWindow : pReplay->filter.iWindow) == 0))
+      {
+         continue;
+      }
+      else if ((strncmp(cLine, "async ", 6) == 0)
+         && (sscanf(cLine, "async %lf", &pReplay->dAsync) == 1)
+         && (pReplay->dAsync >= 0.0))
+      {
+         continue;
+      }
+      else
+      {
+         fprintf(stderr, "line %ld: unknown or misplaced call: %s\n", lLine,
+            cLine);
+         return 1;
+      }
+   }
+   return 0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ReplayRecording:  runs the values of a *.tsadjrec file after one display
+ *
+@return           0, or 1 if the file is not a recording of a known version
+ *******************************************************************************/
+static int ReplayRecording(REPLAY *pReplay, FILE *pIn, double dLowerLimit,
+   double dUpperLimit, const char *pFormat, const char *pUnit)
+{
+   REPLAY_FILE_HEADER header;
+   REPLAY_RECORD record;
+   REPLAY_RECORD_V1 recordV1;
+   char cOutput[REPLAY_LINE_LENGTH];
+
+   if ((fread(&header, sizeof(header), 1, pIn) != 1)
+      || !(((header.lVersion == REPLAY_VERSION)
+      && (header.lRecordSize == sizeof(REPLAY_RECORD)))
+      || ((header.lVersion == 1)
+      && (header.lRecordSize == sizeof(REPLAY_RECORD_V1)))))
+   {
+      fprintf(stderr, "not a version 1 .. %d recording\n", REPLAY_VERSION);
+      return 1;
+   }
+   /* skip a larger header of a later version */
+   fseek(pIn, header.lHeaderSize, SEEK_SET);
+
+   header.cUUT[REPLAY_UUT_LENGTH - 1] = '\0';
+   header.cStepName[REPLAY_STEPNAME_LENGTH - 1] = '\0';
+   sprintf(cOutput, "recording version %ld, UUT \"%.64s\", %ld dropped",
+      (long) header.lVersion, header.cUUT, (long) header.lDropped);
+   Emit(cOutput);
+   Display(pReplay, header.cStepName, dLowerLimit, dUpperLimit, pFormat,
+      pUnit);
+
+   if (header.lVersion == 1)
+   {
+      /* no raw value before version 2, the shown value is replayed */
+      Transform_Compile(&pReplay->transform, "");
+      Filter_Configure(&pReplay->filter, FILTER_NONE, 1);
+      while (fread(&recordV1, sizeof(recordV1), 1, pIn) == 1)
+      {
+         SetValue(pReplay, recordV1.dTime, recordV1.dValue, &recordV1.dValue);
+      }
+   }
+   else
+   {
+      while (fread(&record, sizeof(record), 1, pIn) == 1)
+      {
+         SetValue(pReplay, record.dTime, record.dRawValue, &record.dValue);
+      }
+   }
+   return 0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Display:  starts a panel as tsadj_DisplayAdjustmentPanel does
+ *******************************************************************************/
+static void Display(REPLAY *pReplay, const char *pStepName, double dLowerLimit,
+   double dUpperLimit, const char *pFormat, const char *pUnit)
+{
+   PANELIPC_DISPLAY_TEXT text;
+   PANEL_COMMAND scale;
+   char cOutput[REPLAY_LINE_LENGTH];
+   char cStepName[PANELIPC_STEPNAME_LENGTH];
+   char cFormat[64];
+   char cUnit[32];
+   char cButton[] = "OK";
+   int iScale;
+
+   strncpy(cStepName, pStepName, sizeof(cStepName) - 1);
+   cStepName[sizeof(cStepName) - 1] = '\0';
+   strncpy(cFormat, pFormat, sizeof(cFormat) - 1);
+   cFormat[sizeof(cFormat) - 1] = '\0';
+   /* the unit of the transform is shown instead of the Display unit */
+   strncpy(cUnit, (pReplay->transform.cUnit[0] != '\0')
+      ? pReplay->transform.cUnit : pUnit, sizeof(cUnit) - 1);
+   cUnit[sizeof(cUnit) - 1] = '\0';
+
+   Filter_Reset(&pReplay->filter);
+   PanelView_FormatText(&text, cStepName, cButton, cUnit, cFormat,
+      dLowerLimit, dUpperLimit);
+   iScale = PanelView_Begin(&pReplay->view, dLowerLimit, dUpperLimit,
+      cFormat, &scale);
+   pReplay->lPending = PENDING_OPEN;
+   pReplay->iPendingCount = 0;
+   pReplay->iDisplayed = TRUE;
+   pReplay->iShown = FALSE;
+
+   /* the format is parsed by PanelView_Begin */
+   sprintf(cOutput, "display \"%s\" \"%s\" format %s precision %d, filter %s"
+      " %d", text.cLowerLimit, text.cUpperLimit,
+      FormatName(pReplay->view.iFormat), pReplay->view.iPrecision,
+      gFilterNames[pReplay->filter.iType], pReplay->filter.iWindow);
+   Emit(cOutput);
+   /* queued behind the texts, before the panel is shown */
+   if (iScale)
+   {
+      EmitCommand(&scale);
+      pReplay->lCalls++;
+   }
+   if (pReplay->dAsync == 0.0)
+   {
+      /* the Display call returns with the panel shown */
+      ShowPanel(pReplay, 0.0);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ShowPanel:  the panel thread shows the panel with the pending commands
+ *******************************************************************************/
+static void ShowPanel(REPLAY *pReplay, double dTime)
+{
+   char cOutput[REPLAY_LINE_LENGTH];
+   int idx;
+
+   PanelView_ClosePending(&pReplay->lPending);
+   pReplay->iShown = TRUE;
+   if ((dTime == 0.0) && (pReplay->iPendingCount == 0))
+   {
+      return;
+   }
+   sprintf(cOutput, "shown %.6g, %d pending calls", dTime,
+      pReplay->iPendingCount);
+   Emit(cOutput);
+   for (idx = 0; idx < pReplay->iPendingCount; idx++)
+   {
+      EmitCommand(&pReplay->pending[idx]);
+   }
+   pReplay->lCalls += pReplay->iPendingCount;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+SetValue:  one reading as tsadj_SetValueAdjustmentPanel takes it
+ *
+@param pRecorded:   filtered value of the recording, NULL for a trace
+ *******************************************************************************/
+static void SetValue(REPLAY *pReplay, double dTime, double dRawValue,
+   const double *pRecorded)
+{
+   PANELVIEW_READING reading;
+   char cOutput[REPLAY_LINE_LENGTH];
+   int idx;
+
+   if (!pReplay->iShown && (dTime >= pReplay->dAsync))
+   {
+      ShowPanel(pReplay, pReplay->dAsync);
+   }
+
+   PanelView_SetValue(&pReplay->view, &pReplay->filter, &pReplay->transform,
+      &dRawValue, 1, dTime, &pReplay->lPending, pReplay->pending,
+      &pReplay->iPendingCount, CountResult, pReplay, &reading);
+   if (reading.iKept)
+   {
+      sprintf(cOutput, "value %.6g %.6g -> %.6g kept", dTime, dRawValue,
+         reading.dValue);
+      Emit(cOutput);
+      pReplay->lKept++;
+   }
+   else
+   {
+      sprintf(cOutput, "value %.6g %.6g -> %.6g -> %.6g %s, %d calls,"
+         " %d skipped", dTime, dRawValue, reading.dValue,
+         pReplay->view.dShownValue, pReplay->view.iShownPassed ? "green"
+         : "red", reading.iCommands, reading.iSkipped);
+      Emit(cOutput);
+      for (idx = 0; idx < reading.iCommands; idx++)
+      {
+         EmitCommand(&reading.commands[idx]);
+      }
+      pReplay->lCalls += reading.iCommands;
+      pReplay->lSkipped += reading.iSkipped;
+   }
+   pReplay->lValues++;
+
+   if ((pRecorded != NULL) && (fabs(*pRecorded - reading.dValue)
+      > REPLAY_DIFFERENCE * fabs(reading.dValue) + REPLAY_DIFFERENCE))
+   {
+      sprintf(cOutput, "   recorded %.6g", *pRecorded);
+      Emit(cOutput);
+      pReplay->lDiffer++;
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+CountResult:  limit decision of PanelView_SetValue, where the library
+              publishes and records the value
+ *******************************************************************************/
+static void CountResult(void *pContext, const PANELVIEW_READING *pReading,
+   double dTime)
+{
+   REPLAY *pReplay = (REPLAY *) pContext;
+
+   if (pReading->iPassed)
+   {
+      pReplay->lPassed++;
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+FindFilter:  FILTER_xxx of a -filter name, case sensitive
+ *
+@return             -1 for an unknown name
+ *******************************************************************************/
+static int FindFilter(const char *pName)
+{
+   int idx;
+
+   for (idx = FILTER_NONE; idx <= FILTER_MEDIAN; idx++)
+   {
+      if (strcmp(pName, gFilterNames[idx]) == 0)
+      {
+         return idx;
+      }
+   }
+   return -1;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+FormatName:  name of a format of PanelView_ParseFormat, so the output does
+             not depend on the values of the user interface library
+ *******************************************************************************/
+static const char *FormatName(int iFormat)
+{
+   switch (iFormat)
+   {
+      case VAL_DECIMAL_FORMAT:
+         return "decimal";
+
+      case VAL_FLOATING_PT_FORMAT:
+         return "floating";
+
+      case VAL_SCIENTIFIC_FORMAT:
+         return "scientific";
+
+      default:
+         return "?";
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Emit:  writes one line of the output and compares it with the golden file
+ *******************************************************************************/
+static void Emit(const char *pLine)
+{
+   char cGolden[REPLAY_LINE_LENGTH];
+
+   glOutputLine++;
+   printf("%s\n", pLine);
+   if ((gpGolden == NULL) || giDifferent)
+   {
+      return;
+   }
+   if (fgets(cGolden, sizeof(cGolden), gpGolden) == NULL)
+   {
+      fprintf(stderr, "golden file ends before line %ld\n", glOutputLine);
+      giDifferent = TRUE;
+      return;
+   }
+   StripNewline(cGolden);
+   if (strcmp(cGolden, pLine) != 0)
+   {
+      fprintf(stderr, "line %ld differs\n  golden: %s\n  replay: %s\n",
+         glOutputLine, cGolden, pLine);
+      giDifferent = TRUE;
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+EmitCommand:  writes a command the library would queue for the panel thread
+ *******************************************************************************/
+static void EmitCommand(const PANEL_COMMAND *pCommand)
+{
+   char cOutput[REPLAY_LINE_LENGTH];
+
+   switch (pCommand->iCommand)
+   {
+      case PANELQUEUE_CMD_SCALE:
+         sprintf(cOutput, "   scale %.6g .. %.6g", pCommand->dValue,
+            pCommand->dMaximum);
+         break;
+
+      case PANELQUEUE_CMD_VALUE:
+         sprintf(cOutput, "   indicator %.6g", pCommand->dValue);
+         break;
+
+      case PANELQUEUE_CMD_TEXT:
+         sprintf(cOutput, "   %s \"%s\"", (pCommand->iCtrl == ADJUSTMENT_TREND)
+            ? "trend" : "text", pCommand->data.cText);
+         break;
+
+      case PANELQUEUE_CMD_ATTRIBUTE:
+         sprintf(cOutput, "   background %s", (pCommand->iValue == VAL_GREEN)
+            ? "green" : "red");
+         break;
+
+      default:
+         sprintf(cOutput, "   command %d", pCommand->iCommand);
+         break;
+   }
+   Emit(cOutput);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+StripNewline:  removes the line end, also of files with CR LF
+ *******************************************************************************/
+static void StripNewline(char *pLine)
+{
+   size_t length = strlen(pLine);
+
+   while ((length > 0) && ((pLine[length - 1] == '\n')
+      || (pLine[length - 1] == '\r')))
+   {
+      pLine[--length] = '\0';
+   }
+}
@@ -0,0 +1,284 @@
+/*******************************************************************************/
+/**
+@file tsadjsim.c
+*
+@brief Runs simulated adjustments without a panel and measures them
+*
+Usage: tsadjsim [<option> <value>] ...
+   -plant <name>       DUT preset: Normal, Slow, Noisy or Drifting
+   -operator <name>    operator preset: Normal, Fast or Careful
+   -cycles <n>         Display -> SetValue -> button cycles (1000)
+   -rate <Hz>          SetValue calls per s (20)
+   -limits <LL> <UL>   limits of the step (9.5 10.5)
+   -format <format>    format of the values ("%.2f")
+   -hysteresis <h>     pass/fail colour hysteresis, value unit (0)
+   -autozoom <0|1>     slider range follows the value (0)
+   -filter <name>      EMA, Mean or Median (none)
+   -window <n>         filter window (8)
+   -timeout <s>        a cycle without the button ends after (120)
+   -seed <n>           start of the DUT noise (1)
+Every cycle takes the way of one panel through the library: the simulated
+DUT of ../simulation.c is read at the rate, the value is filtered and passed
+to PanelView_Update, and the simulated operator looks at the shown value and
+colour. The times are simulated, so thousands of cycles take seconds. The
+adjustment time, the panel commands per cycle and the time of the decisions
+per value are written to stdout. The panel thread and its latency are not
+part of the cycle.
+Build as a console application together with ../panelview.c, ../trend.c,
+../filter.c, ../transform.c and ../simulation.c.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../definitions.h"
+#include "../panelview.h"
+#include "../filter.h"
+#include "../simulation.h"
+
+/* LOCAL DEFINES **************************************************************/
+#define SIM_MAX_CYCLES        1000000L
+
+/* LOCAL VARIABLES ************************************************************/
+
+/* Values of -filter, in the order FILTER_EMA .. FILTER_MEDIAN */
+static const char *gFilterNames[] =
+{
+   "EMA", "Mean", "Median"
+};
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static int FindName(const char *pName, const char *(*pGetName)(int), int iCount);
+static const char *FilterName(int iIndex);
+static int CompareTimes(const void *pLeft, const void *pRight);
+
+/* EXPORTED FUNCTION DEFINITIONS **********************************************/
+
+int main(int argc, char *argv[])
+{
+   SIMULATION sim;
+   PANEL_VIEW view;
+   FILTER filter;
+   PANEL_COMMAND commands[PANELVIEW_MAX_COMMANDS];
+   char cFormat[64] = "%.2f";
+   double dLowerLimit = 9.5;
+   double dUpperLimit = 10.5;
+   double dRate = 20.0;
+   double dTimeout = 120.0;
+   double dHysteresis = 0.0;
+   double dTime;
+   double dValue;
+   double dSum = 0.0;
+   double *pTimes;
+   long lCycles = 1000;
+   long lConfirmed = 0;
+   long lCycle;
+   long lStep;
+   long lValues = 0;
+   long lCalls = 0;
+   long lSkipped = 0;
+   unsigned long ulSeed = 1;
+   clock_t start;
+   clock_t ticks;
+   int iPlant = 0;
+   int iOperator = 0;
+   int iFilter = FILTER_NONE;
+   int iWindow = 8;
+   int iAutoZoom = 0;
+   int iSkipped;
+   int idx;
+
+   for (idx = 1; idx < argc; idx++)
+   {
+      if ((strcmp(argv[idx], "-limits") == 0) && (idx + 2 < argc))
+      {
+         dLowerLimit = atof(argv[++idx]);
+         dUpperLimit = atof(argv[++idx]);
+      }
+      else if (idx + 1 >= argc)
+      {
+         break;
+      }
+      else if (strcmp(argv[idx], "-plant") == 0)
+      {
+         iPlant = FindName(argv[++idx], Simulation_PlantName,
+            SIMULATION_PLANTS);
+      }
+      else if (strcmp(argv[idx], "-operator") == 0)
+      {
+         iOperator = FindName(argv[++idx], Simulation_OperatorName,
+            SIMULATION_OPERATORS);
+      }
+      else if (strcmp(argv[idx], "-filter") == 0)
+      {
+         iFilter = FindName(argv[++idx], FilterName, 3);
+         iFilter = (iFilter < 0) ? -1 : FILTER_EMA + iFilter;
+      }
+      else if (strcmp(argv[idx], "-cycles") == 0)
+      {
+         lCycles = atol(argv[++idx]);
+      }
+      else if (strcmp(argv[idx], "-rate") == 0)
+      {
+         dRate = atof(argv[++idx]);
+      }
+      else if (strcmp(argv[idx], "-format") == 0)
+      {
+         strncpy(cFormat, argv[++idx], sizeof(cFormat) - 1);
+         cFormat[sizeof(cFormat) - 1] = '\0';
+      }
+      else if (strcmp(argv[idx], "-hysteresis") == 0)
+      {
+         dHysteresis = atof(argv[++idx]);
+      }
+      else if (strcmp(argv[idx], "-autozoom") == 0)
+      {
+         iAutoZoom = atoi(argv[++idx]);
+      }
+      else if (strcmp(argv[idx], "-window") == 0)
+      {
+         iWindow = atoi(argv[++idx]);
+      }
+      else if (strcmp(argv[idx], "-timeout") == 0)
+      {
+         dTimeout = atof(argv[++idx]);
+      }
+      else if (strcmp(argv[idx], "-seed") == 0)
+      {
+         ulSeed = (unsigned long) atol(argv[++idx]);
+      }
+      else
+      {
+         break;
+      }
+   }
+   if ((idx < argc) || (iPlant < 0) || (iOperator < 0) || (iFilter < 0)
+      || (lCycles < 1) || (lCycles > SIM_MAX_CYCLES) || (dRate <= 0.0)
+      || (dTimeout <= 0.0) || (dUpperLimit < dLowerLimit)
+      || (Filter_Configure(&filter, iFilter, iWindow) != 0))
+   {
+      fprintf(stderr, "usage: tsadjsim [-plant <name>] [-operator <name>]"
+         " [-cycles <n>] [-rate <Hz>]\n   [-limits <LL> <UL>] [-format"
+         " <format>] [-hysteresis <h>] [-autozoom <0|1>]\n   [-filter <name>]"
+         " [-window <n>] [-timeout <s>] [-seed <n>]\n");
+      return 2;
+   }
+
+   pTimes = (double *) malloc(lCycles * sizeof(double));
+   if (pTimes == NULL)
+   {
+      fprintf(stderr, "out of memory\n");
+      return 1;
+   }
+
+   Simulation_Configure(&sim, iPlant, iOperator, ulSeed);
+   memset(&view, 0, sizeof(view));
+   view.dHysteresis = dHysteresis;
+   view.iAutoZoom = iAutoZoom;
+
+   start = clock();
+   for (lCycle = 0; lCycle < lCycles; lCycle++)
+   {
+      /* Display */
+      Simulation_Begin(&sim, dLowerLimit, dUpperLimit, 0.0);
+      Filter_Reset(&filter);
+      lCalls += PanelView_Begin(&view, dLowerLimit, dUpperLimit, cFormat,
+         &commands[0]);
+
+      /* SetValue loop until the button */
+      for (lStep = 1; lStep * (1.0 / dRate) <= dTimeout; lStep++)
+      {
+         dTime = lStep * (1.0 / dRate);
+         dValue = Filter_Apply(&filter, Simulation_Measure(&sim, dTime));
+         lCalls += PanelView_Update(&view, dValue, dTime, commands,
+            &iSkipped);
+         lSkipped += iSkipped;
+         lValues++;
+         if (Simulation_Operate(&sim, view.dShownValue, view.iShownPassed,
+            dTime))
+         {
+            pTimes[lConfirmed++] = dTime;
+            break;
+         }
+      }
+   }
+   ticks = clock() - start;
+
+   printf("plant %s, operator %s, %g Hz, limits %g .. %g, format %s\n",
+      Simulation_PlantName(iPlant), Simulation_OperatorName(iOperator), dRate,
+      dLowerLimit, dUpperLimit, cFormat);
+   printf("filter %s, window %d, hysteresis %g, auto zoom %s\n",
+      (iFilter == FILTER_NONE) ? "none" : gFilterNames[iFilter - FILTER_EMA],
+      iWindow, dHysteresis, iAutoZoom ? "on" : "off");
+   printf("%ld cycles, %ld confirmed, %ld timed out after %g s\n", lCycles,
+      lConfirmed, lCycles - lConfirmed, dTimeout);
+   if (lConfirmed > 0)
+   {
+      qsort(pTimes, lConfirmed, sizeof(double), CompareTimes);
+      for (lCycle = 0; lCycle < lConfirmed; lCycle++)
+      {
+         dSum += pTimes[lCycle];
+      }
+      printf("adjustment time s: mean %.3f, median %.3f, 95%% %.3f,"
+         " max %.3f\n", dSum / lConfirmed, pTimes[lConfirmed / 2],
+         pTimes[(lConfirmed * 95) / 100], pTimes[lConfirmed - 1]);
+   }
+   printf("per cycle: %.1f values, %.1f panel commands, %.1f skipped\n",
+      (double) lValues / lCycles, (double) lCalls / lCycles,
+      (double) lSkipped / lCycles);
+   printf("decisions: %.3f us per value\n", (lValues > 0) ? 1e6 * ticks
+      / CLOCKS_PER_SEC / lValues : 0.0);
+
+   free(pTimes);
+   return 0;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+FindName:  index of a preset name, case sensitive
+ *
+@return             -1 for an unknown name
+ *******************************************************************************/
+static int FindName(const char *pName, const char *(*pGetName)(int), int iCount)
+{
+   int idx;
+
+   for (idx = 0; idx < iCount; idx++)
+   {
+      if (strcmp(pName, pGetName(idx)) == 0)
+      {
+         return idx;
+      }
+   }
+   return -1;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+FilterName:  name of a filter, for FindName
+ *******************************************************************************/
+static const char *FilterName(int iIndex)
+{
+   return gFilterNames[iIndex];
+}
+
+/* FUNCTION *******************************************************************/
+/**
+CompareTimes:  qsort order of the adjustment times
+ *******************************************************************************/
+static int CompareTimes(const void *pLeft, const void *pRight)
+{
+   double dLeft = *(const double *) pLeft;
+   double dRight = *(const double *) pRight;
+
+   return (dLeft < dRight) ? -1 : ((dLeft > dRight) ? 1 : 0);
+}
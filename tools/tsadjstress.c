@@ -0,0 +1,496 @@
+/*******************************************************************************/
+/**
+@file tsadjstress.c
+*
+@brief Runs parallel sockets against tsadj.dll and measures them
+*
+Usage: tsadjstress [<option> <value>] ...
+   -bench <format>     bench names, %d is the socket 1 .. N ("Sample%d")
+   -max <n>            runs N = 1, 2, 4 .. up to n sockets, at most 64 (64)
+   -seconds <s>        duration of one run (10)
+   -timeout <ms>       a call taking longer counts as timed out (2500)
+   -hang <ms>          a call taking longer counts as hanging (30000)
+   -seed <n>           start of the schedules (1)
+Every socket runs in its own thread with its own bench, set up with
+tsadjc_Setup. The thread calls Display, SetValue, Hide and Cleanup (followed
+by a new Setup) in a random order, also out of the order of a sequence,
+since the library has to cope with any of them. No button is pressed. For
+every N the calls per second of all sockets, the call latency percentiles
+and the calls with an error, timed out or hanging are written to stdout.
+A hanging call is a suspected deadlock; its thread is abandoned and the
+remaining runs are skipped.
+The benches must be defined in the application INI file of the resource
+manager, e.g. [LogicalNames] Sample2 = bench->Sample2 and a [bench->Sample2]
+section like the one of Sample1, up to the largest N.
+Build as a console application and link it with tsadj.lib.
+The tool runs on Windows only. tsadj.dll depends on the CVI run-time, the
+resource manager and Win32, so there is no Linux build of it that could be
+run under a thread sanitizer, and a stand-in for the DLL would not exercise
+its locking. Races are found by the hang watchdog and the error counts.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../tsadjc.h"
+
+/* LOCAL DEFINES **************************************************************/
+#define STRESS_MAX_SOCKETS    MAXIMUM_WAIT_OBJECTS
+#define STRESS_BUCKETS        256      /* latency buckets, 10 % wide each  */
+#define STRESS_BUCKET_BASE    1.1
+#define STRESS_NAME_LENGTH    256
+#define STRESS_WATCH_INTERVAL 100      /* ms between two checks for hangs  */
+
+/* TSPAN_ERR_THREADWASNOTSTARTET of tsadj.h, which needs the CVI headers */
+#define STRESS_ERR_NOT_SHOWN  -1004002
+
+/* Calls of the schedule and their weights in percent */
+#define STRESS_CALL_DISPLAY   0
+#define STRESS_CALL_SETVALUE  1
+#define STRESS_CALL_HIDE      2
+#define STRESS_CALL_CLEANUP   3
+#define STRESS_CALLS          4
+
+/* LOCAL TYPE DEFINITIONS *****************************************************/
+
+typedef struct
+{
+   int iSocket;                         /* 1 .. N                       */
+   char cBenchName[STRESS_NAME_LENGTH];
+   long lResourceId;
+   unsigned long ulRandom;              /* state of the schedule        */
+   volatile LONG lInCall;               /* 1 -> a call is running       */
+   volatile int iCurrentCall;           /* STRESS_CALL_xxx              */
+   volatile double dCallStart;          /* s, of the running call       */
+   long lCalls[STRESS_CALLS];
+   long lErrors;
+   long lTimeouts;
+   double dMaxLatency;                  /* s                            */
+   long lBuckets[STRESS_BUCKETS];
+   char cLastError[256];
+} SOCKET_STATE;
+
+/* LOCAL VARIABLES ************************************************************/
+static double gdTicksPerSecond = 0.0;
+static double gdTimeout = 2.5;          /* s                            */
+static volatile LONG glStop = 0;
+
+static const char *gCallNames[STRESS_CALLS] =
+{
+   "Display", "SetValue", "Hide", "Cleanup"
+};
+static const int giCallWeights[STRESS_CALLS] =
+{
+   10, 75, 10, 5
+};
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static DWORD WINAPI SocketThread(LPVOID pData);
+static int RunCall(SOCKET_STATE *pSocket, int iCall);
+static void Account(SOCKET_STATE *pSocket, double dLatency, int iError,
+   long lErrorCode);
+static double TimeStamp(void);
+static unsigned long NextRandom(unsigned long *pState);
+static double Percentile(const long lBuckets[], long lCount, double dShare);
+
+/* EXPORTED FUNCTION DEFINITIONS **********************************************/
+
+int main(int argc, char *argv[])
+{
+   static SOCKET_STATE sockets[STRESS_MAX_SOCKETS];
+   HANDLE hThreads[STRESS_MAX_SOCKETS];
+   LARGE_INTEGER liFrequency;
+   char cFormat[STRESS_NAME_LENGTH] = "Sample%d";
+   char cErrorMessage[1024];
+   double dSeconds = 10.0;
+   double dHang = 30.0;
+   double dStart;
+   double dNow;
+   double dMax;
+   long lBuckets[STRESS_BUCKETS];
+   long lErrorCode;
+   long lCalls;
+   long lErrors;
+   long lTimeouts;
+   long lHangs = 0;
+   long lRunHangs;
+   int iComplete = TRUE;                 /* all benches could be set up */
+   unsigned long ulSeed = 1;
+   short sErrorOccurred;
+   int iMax = STRESS_MAX_SOCKETS;
+   int iSockets;
+   int iStarted;
+   int idx;
+   int iCall;
+   int iBucket;
+
+   for (idx = 1; idx + 1 < argc; idx += 2)
+   {
+      if (strcmp(argv[idx], "-bench") == 0)
+      {
+         strncpy(cFormat, argv[idx + 1], sizeof(cFormat) - 1);
+      }
+      else if (strcmp(argv[idx], "-max") == 0)
+      {
+         iMax = atoi(argv[idx + 1]);
+      }
+      else if (strcmp(argv[idx], "-seconds") == 0)
+      {
+         dSeconds = atof(argv[idx + 1]);
+      }
+      else if (strcmp(argv[idx], "-timeout") == 0)
+      {
+         gdTimeout = atof(argv[idx + 1]) / 1000.0;
+      }
+      else if (strcmp(argv[idx], "-hang") == 0)
+      {
+         dHang = atof(argv[idx + 1]) / 1000.0;
+      }
+      else if (strcmp(argv[idx], "-seed") == 0)
+      {
+         ulSeed = (unsigned long) atol(argv[idx + 1]);
+      }
+      else
+      {
+         break;
+      }
+   }
+   if ((idx < argc) || (iMax < 1) || (iMax > STRESS_MAX_SOCKETS)
+      || (dSeconds <= 0.0) || (gdTimeout <= 0.0) || (dHang < gdTimeout)
+      || (strstr(cFormat, "%d") == NULL))
+   {
+      fprintf(stderr, "usage: tsadjstress [-bench <format>] [-max <n>]"
+         " [-seconds <s>]\n   [-timeout <ms>] [-hang <ms>] [-seed <n>]\n");
+      return 2;
+   }
+
+   QueryPerformanceFrequency(&liFrequency);
+   gdTicksPerSecond = (double) liFrequency.QuadPart;
+
+   printf("%7s %10s %9s %9s %9s %9s %7s %8s %5s\n", "sockets", "calls/s",
+      "p50 ms", "p99 ms", "p99.9 ms", "max ms", "errors", "timeouts",
+      "hangs");
+
+   for (iSockets = 1; (iSockets <= iMax) && (lHangs == 0) && iComplete;
+      iSockets *= 2)
+   {
+      /* every run ends with all sockets, also if N is no power of 2 */
+      if ((iSockets * 2 > iMax) && (iSockets < iMax))
+      {
+         iSockets = iMax;
+      }
+
+      /* Setup in this thread, a failing bench ends the runs */
+      for (idx = 0; idx < iSockets; idx++)
+      {
+         memset(&sockets[idx], 0, sizeof(SOCKET_STATE));
+         sockets[idx].iSocket = idx + 1;
+         sockets[idx].ulRandom = ulSeed * 1000UL + (unsigned long) idx;
+         sprintf(sockets[idx].cBenchName, cFormat, idx + 1);
+         tsadjc_Setup(sockets[idx].cBenchName, &sockets[idx].lResourceId,
+            &sErrorOccurred, &lErrorCode, cErrorMessage);
+         if (sErrorOccurred)
+         {
+            fprintf(stderr, "Setup of %s failed: %ld %s\n",
+               sockets[idx].cBenchName, lErrorCode, cErrorMessage);
+            iSockets = idx;
+            iComplete = FALSE;
+            break;
+         }
+      }
+      if (idx == 0)
+      {
+         return 1;
+      }
+
+      InterlockedExchange(&glStop, 0);
+      iStarted = 0;
+      for (idx = 0; idx < iSockets; idx++)
+      {
+         hThreads[idx] = CreateThread(NULL, 0, SocketThread, &sockets[idx], 0,
+            NULL);
+         if (hThreads[idx] == NULL)
+         {
+            break;
+         }
+         iStarted++;
+      }
+
+      /* watch for calls which do not come back */
+      dStart = TimeStamp();
+      do
+      {
+         Sleep(STRESS_WATCH_INTERVAL);
+         dNow = TimeStamp();
+         for (idx = 0; idx < iStarted; idx++)
+         {
+            if (sockets[idx].lInCall
+               && (dNow - sockets[idx].dCallStart > dHang))
+            {
+               InterlockedExchange(&glStop, 1);
+            }
+         }
+      } while (!glStop && (dNow - dStart < dSeconds));
+      InterlockedExchange(&glStop, 1);
+
+      /* the last calls may take up to the hang limit */
+      if (iStarted > 0)
+      {
+         WaitForMultipleObjects(iStarted, hThreads, TRUE, (DWORD)(dHang
+            * 1000.0));
+      }
+      dNow = TimeStamp();
+      lRunHangs = 0;
+      for (idx = 0; idx < iStarted; idx++)
+      {
+         if (WaitForSingleObject(hThreads[idx], 0) != WAIT_OBJECT_0)
+         {
+            fprintf(stderr, "socket %d hangs in %s for %.1f s\n",
+               sockets[idx].iSocket, gCallNames[sockets[idx].iCurrentCall],
+               dNow - sockets[idx].dCallStart);
+            lRunHangs++;
+         }
+      }
+      lHangs += lRunHangs;
+
+      /* merge the sockets */
+      memset(lBuckets, 0, sizeof(lBuckets));
+      lCalls = 0;
+      lErrors = 0;
+      lTimeouts = 0;
+      dMax = 0.0;
+      for (idx = 0; idx < iStarted; idx++)
+      {
+         for (iCall = 0; iCall < STRESS_CALLS; iCall++)
+         {
+            lCalls += sockets[idx].lCalls[iCall];
+         }
+         for (iBucket = 0; iBucket < STRESS_BUCKETS; iBucket++)
+         {
+            lBuckets[iBucket] += sockets[idx].lBuckets[iBucket];
+         }
+         lErrors += sockets[idx].lErrors;
+         lTimeouts += sockets[idx].lTimeouts;
+         if (sockets[idx].dMaxLatency > dMax)
+         {
+            dMax = sockets[idx].dMaxLatency;
+         }
+      }
+      printf("%7d %10.1f %9.3f %9.3f %9.3f %9.3f %7ld %8ld %5ld\n", iSockets,
+         lCalls / (dNow - dStart), 1000.0 * Percentile(lBuckets, lCalls, 0.5),
+         1000.0 * Percentile(lBuckets, lCalls, 0.99), 1000.0 * Percentile(
+         lBuckets, lCalls, 0.999), 1000.0 * dMax, lErrors, lTimeouts,
+         lRunHangs);
+
+      for (idx = 0; idx < iStarted; idx++)
+      {
+         if (sockets[idx].cLastError[0] != '\0')
+         {
+            fprintf(stderr, "socket %d, last error: %s\n",
+               sockets[idx].iSocket, sockets[idx].cLastError);
+         }
+      }
+
+      /* a hanging socket keeps its bench, the others are cleaned up */
+      for (idx = 0; idx < iSockets; idx++)
+      {
+         if ((idx >= iStarted) || (WaitForSingleObject(hThreads[idx], 0)
+            == WAIT_OBJECT_0))
+         {
+            tsadjc_Cleanup(sockets[idx].lResourceId, &sErrorOccurred,
+               &lErrorCode, cErrorMessage);
+         }
+         if (idx < iStarted)
+         {
+            CloseHandle(hThreads[idx]);
+         }
+      }
+   }
+
+   return (lHangs > 0) ? 1 : 0;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+SocketThread:  runs the random schedule of one socket until glStop
+ *******************************************************************************/
+static DWORD WINAPI SocketThread(LPVOID pData)
+{
+   SOCKET_STATE *pSocket = (SOCKET_STATE *) pData;
+   int iDraw;
+   int iCall;
+
+   while (!glStop)
+   {
+      iDraw = (int)(NextRandom(&pSocket->ulRandom) % 100UL);
+      for (iCall = 0; iCall < STRESS_CALLS - 1; iCall++)
+      {
+         if (iDraw < giCallWeights[iCall])
+         {
+            break;
+         }
+         iDraw -= giCallWeights[iCall];
+      }
+      if (!RunCall(pSocket, iCall))
+      {
+         /* no bench any more, e.g. the Setup after Cleanup failed */
+         break;
+      }
+   }
+   return 0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+RunCall:  runs and accounts one call of the schedule
+ *
+@return     FALSE if the socket has no bench any more
+ *******************************************************************************/
+static int RunCall(SOCKET_STATE *pSocket, int iCall)
+{
+   char cErrorMessage[1024];
+   long lErrorCode = 0;
+   short sErrorOccurred = 0;
+   double dValue;
+   double dStart;
+   int iSetup = TRUE;
+
+   dStart = TimeStamp();
+   pSocket->dCallStart = dStart;
+   pSocket->iCurrentCall = iCall;
+   InterlockedExchange(&pSocket->lInCall, 1);
+
+   switch (iCall)
+   {
+      case STRESS_CALL_DISPLAY:
+         tsadjc_Display(pSocket->lResourceId, "stress", "OK", "V", "%.3f",
+            9.5, 10.5, &sErrorOccurred, &lErrorCode, cErrorMessage);
+         break;
+
+      case STRESS_CALL_SETVALUE:
+         dValue = 9.0 + 2.0 * (NextRandom(&pSocket->ulRandom) % 1000UL)
+            / 1000.0;
+         tsadjc_SetValue(pSocket->lResourceId, dValue, &sErrorOccurred,
+            &lErrorCode, cErrorMessage);
+         break;
+
+      case STRESS_CALL_HIDE:
+         tsadjc_Hide(pSocket->lResourceId, &sErrorOccurred, &lErrorCode,
+            cErrorMessage);
+         break;
+
+      default:
+         tsadjc_Cleanup(pSocket->lResourceId, &sErrorOccurred, &lErrorCode,
+            cErrorMessage);
+         if (!sErrorOccurred)
+         {
+            tsadjc_Setup(pSocket->cBenchName, &pSocket->lResourceId,
+               &sErrorOccurred, &lErrorCode, cErrorMessage);
+            iSetup = !sErrorOccurred;
+         }
+         break;
+   }
+
+   InterlockedExchange(&pSocket->lInCall, 0);
+   pSocket->lCalls[iCall]++;
+   Account(pSocket, TimeStamp() - dStart, sErrorOccurred, lErrorCode);
+   if (sErrorOccurred)
+   {
+      sprintf(pSocket->cLastError, "%s %ld", gCallNames[iCall], lErrorCode);
+   }
+   return iSetup;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Account:  adds the latency and the result of one call to the histogram
+ *******************************************************************************/
+static void Account(SOCKET_STATE *pSocket, double dLatency, int iError,
+   long lErrorCode)
+{
+   int iBucket = 0;
+
+   /* bucket n: below 1 us * 1.1^n */
+   if (dLatency > 1e-6)
+   {
+      iBucket = (int)(log(dLatency / 1e-6) / log(STRESS_BUCKET_BASE)) + 1;
+   }
+   if (iBucket >= STRESS_BUCKETS)
+   {
+      iBucket = STRESS_BUCKETS - 1;
+   }
+   pSocket->lBuckets[iBucket]++;
+   if (dLatency > pSocket->dMaxLatency)
+   {
+      pSocket->dMaxLatency = dLatency;
+   }
+
+   if ((dLatency > gdTimeout) || (iError && (lErrorCode
+      == STRESS_ERR_NOT_SHOWN)))
+   {
+      pSocket->lTimeouts++;
+   }
+   else if (iError)
+   {
+      pSocket->lErrors++;
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Percentile:  upper bound of the bucket holding the given share of the calls
+ *
+@return      s, 0.0 without calls
+ *******************************************************************************/
+static double Percentile(const long lBuckets[], long lCount, double dShare)
+{
+   double dLimit = lCount * dShare;
+   long lSum = 0;
+   int iBucket;
+
+   if (lCount == 0)
+   {
+      return 0.0;
+   }
+   for (iBucket = 0; iBucket < STRESS_BUCKETS - 1; iBucket++)
+   {
+      lSum += lBuckets[iBucket];
+      if (lSum >= dLimit)
+      {
+         break;
+      }
+   }
+   return 1e-6 * pow(STRESS_BUCKET_BASE, iBucket);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+TimeStamp:  performance counter in s
+ *******************************************************************************/
+static double TimeStamp(void)
+{
+   LARGE_INTEGER liCount;
+
+   QueryPerformanceCounter(&liCount);
+   return (double) liCount.QuadPart / gdTicksPerSecond;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+NextRandom:  linear congruential generator, the same schedule for a seed
+ *******************************************************************************/
+static unsigned long NextRandom(unsigned long *pState)
+{
+   *pState = (*pState * 1103515245UL + 12345UL) & 0x7fffffffUL;
+   return *pState >> 8;
+}
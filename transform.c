@@ -0,0 +1,201 @@
+/*******************************************************************************/
+/**
+@file transform.c
+*
+@brief Conversion of the readings into the quantity shown on the panel
+*
+The description is compiled once. Consecutive linear operations are folded
+into one scale and offset, so a transform costs one multiply-add plus one
+logarithm and multiply-add per "db" operation for every value.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "transform.h"
+
+/* LOCAL DEFINES **************************************************************/
+#define TRANSFORM_TEXT_LENGTH   256
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static void Linear(TRANSFORM *pTransform, double dScale, double dOffset);
+static char *Trim(char *pText);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Transform_Compile:  translates a description, see transform.h
+ *
+@param pDescription:  operations separated by ';', "" -> no transform
+ *
+@return               0, or -1 if the description is not valid; the
+                      transform is not changed then
+ *******************************************************************************/
+int Transform_Compile(TRANSFORM *pTransform, const char *pDescription)
+{
+   TRANSFORM compiled;
+   char cText[TRANSFORM_TEXT_LENGTH];
+   char *pNext;
+   char *pOperation;
+   char *pArgument;
+   char *pEnd;
+   double dArgument;
+
+   if (strlen(pDescription) >= TRANSFORM_TEXT_LENGTH)
+   {
+      return -1;
+   }
+   strcpy(cText, pDescription);
+
+   memset(&compiled, 0, sizeof(compiled));
+   compiled.iSteps = 1;
+   compiled.steps[0].dScale = 1.0;
+
+   for (pNext = cText; pNext != NULL; )
+   {
+      pOperation = pNext;
+      pNext = strchr(pNext, ';');
+      if (pNext != NULL)
+      {
+         *pNext++ = '\0';
+      }
+      pOperation = Trim(pOperation);
+      if (*pOperation == '\0')
+      {
+         continue;
+      }
+      pArgument = strchr(pOperation, '=');
+      if (pArgument == NULL)
+      {
+         return -1;
+      }
+      *pArgument++ = '\0';
+      pOperation = Trim(pOperation);
+      pArgument = Trim(pArgument);
+
+      if (strcmp(pOperation, "unit") == 0)
+      {
+         if (strlen(pArgument) >= TRANSFORM_UNIT_LENGTH)
+         {
+            return -1;
+         }
+         strcpy(compiled.cUnit, pArgument);
+         continue;
+      }
+
+      dArgument = strtod(pArgument, &pEnd);
+      if ((pEnd == pArgument) || (*pEnd != '\0'))
+      {
+         return -1;
+      }
+      if (strcmp(pOperation, "scale") == 0)
+      {
+         Linear(&compiled, dArgument, 0.0);
+      }
+      else if (strcmp(pOperation, "offset") == 0)
+      {
+         Linear(&compiled, 1.0, dArgument);
+      }
+      else if ((strcmp(pOperation, "ppm") == 0) && (dArgument != 0.0))
+      {
+         Linear(&compiled, 1e6 / dArgument, -1e6);
+         strcpy(compiled.cUnit, "ppm");
+      }
+      else if ((strcmp(pOperation, "percent") == 0) && (dArgument != 0.0))
+      {
+         Linear(&compiled, 100.0 / dArgument, -100.0);
+         strcpy(compiled.cUnit, "%");
+      }
+      else if ((strcmp(pOperation, "db") == 0) && (dArgument > 0.0)
+         && (compiled.iSteps <= TRANSFORM_MAX_STEPS))
+      {
+         compiled.steps[compiled.iSteps].dScale = 20.0;
+         compiled.steps[compiled.iSteps].dOffset = -20.0 * log10(dArgument);
+         compiled.iSteps++;
+         strcpy(compiled.cUnit, "dB");
+      }
+      else
+      {
+         return -1;
+      }
+   }
+
+   /* nothing but the identity left */
+   if ((compiled.iSteps == 1) && (compiled.steps[0].dScale == 1.0)
+      && (compiled.steps[0].dOffset == 0.0))
+   {
+      compiled.iSteps = 0;
+   }
+   memcpy(pTransform, &compiled, sizeof(TRANSFORM));
+   return 0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Transform_Apply:  converts one value
+ *******************************************************************************/
+double Transform_Apply(const TRANSFORM *pTransform, double dValue)
+{
+   const TRANSFORM_STEP *pStep;
+   int idx;
+
+   if (pTransform->iSteps == 0)
+   {
+      return dValue;
+   }
+   pStep = pTransform->steps;
+   dValue = pStep->dScale * dValue + pStep->dOffset;
+   for (idx = 1; idx < pTransform->iSteps; idx++)
+   {
+      pStep++;
+      /* also catches NaN */
+      if (!(dValue >= TRANSFORM_LOG_MIN))
+      {
+         dValue = TRANSFORM_LOG_MIN;
+      }
+      dValue = pStep->dScale * log10(dValue) + pStep->dOffset;
+   }
+   return dValue;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Linear:  folds x * dScale + dOffset into the last step
+ *******************************************************************************/
+static void Linear(TRANSFORM *pTransform, double dScale, double dOffset)
+{
+   TRANSFORM_STEP *pStep = &pTransform->steps[pTransform->iSteps - 1];
+
+   pStep->dScale *= dScale;
+   pStep->dOffset = pStep->dOffset * dScale + dOffset;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Trim:  removes leading and trailing blanks in place
+ *******************************************************************************/
+static char *Trim(char *pText)
+{
+   char *pEnd;
+
+   while (isspace((unsigned char)*pText))
+   {
+      pText++;
+   }
+   pEnd = pText + strlen(pText);
+   while ((pEnd > pText) && isspace((unsigned char)pEnd[-1]))
+   {
+      *--pEnd = '\0';
+   }
+   return pText;
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************/
+/**
+@file transform.h
+*
+@brief Conversion of the readings into the quantity shown on the panel
+*
+A transform is described by a text like "percent=5.0" or
+"scale=1e-3; db=0.775; unit=dBu", the operations are applied from left to
+right:
+   scale=k      x * k
+   offset=c     x + c
+   db=ref       20 * log10(x / ref)
+   ppm=nom      (x - nom) / nom * 1e6
+   percent=nom  (x - nom) / nom * 100
+   unit=text    unit shown on the panel
+Without "unit" the unit follows the last of db, ppm or percent. The limits
+passed to tsadj_DisplayAdjustmentPanel are in the transformed quantity.
+A db operation takes values below TRANSFORM_LOG_MIN, e.g. 0 or a negative
+reading of a dead DUT, as TRANSFORM_LOG_MIN, so they are shown about 600 dB
+below the reference instead of -inf or NaN which would stick in the EMA and
+mean filters.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define TRANSFORM_MAX_STEPS     4     /* logarithms in one transform     */
+#define TRANSFORM_UNIT_LENGTH   32
+#define TRANSFORM_LOG_MIN       1e-30 /* smallest value of a db step     */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+/* y = dScale * f(x) + dOffset, f is log10 for all steps but the first */
+typedef struct
+{
+   double dScale;
+   double dOffset;
+} TRANSFORM_STEP;
+
+typedef struct
+{
+   int iSteps;                         /* 0 -> values are not changed    */
+   TRANSFORM_STEP steps[TRANSFORM_MAX_STEPS + 1];
+   char cUnit[TRANSFORM_UNIT_LENGTH];  /* "" -> unit of the Display call */
+} TRANSFORM;
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+int  Transform_Compile(TRANSFORM *pTransform, const char *pDescription);
+double Transform_Apply(const TRANSFORM *pTransform, double dValue);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
@@ -0,0 +1,175 @@
+/*******************************************************************************/
+/**
+@file trend.c
+*
+@brief Direction and speed of the shown values, time to reach the limits
+*
+The sums of the regression are updated for the new and the dropped value, a
+value costs constant time. Once per window the sums are recalculated around
+the oldest value, so the time stamps stay small and rounding errors cannot
+accumulate.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+#include "trend.h"
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+static void Rebase(TREND *pTrend);
+
+/* GLOBAL FUNCTION DEFINITIONS ************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Trend_Reset:  forgets all values, called for every displayed panel
+ *******************************************************************************/
+void Trend_Reset(TREND *pTrend)
+{
+   pTrend->iCount = 0;
+   pTrend->iNext = 0;
+   pTrend->dOrigin = 0.0;
+   pTrend->dSumX = 0.0;
+   pTrend->dSumY = 0.0;
+   pTrend->dSumXX = 0.0;
+   pTrend->dSumXY = 0.0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Trend_Add:  adds one value
+ *
+@param dTime:      time stamp of the value in s, see Metrics_TimeStamp
+ *******************************************************************************/
+void Trend_Add(TREND *pTrend, double dTime, double dValue)
+{
+   double dX;
+   int idx = pTrend->iNext;
+
+   if (pTrend->iCount == 0)
+   {
+      pTrend->dOrigin = dTime;
+   }
+   if (pTrend->iCount == TREND_WINDOW)
+   {
+      dX = pTrend->dX[idx];
+      pTrend->dSumX -= dX;
+      pTrend->dSumY -= pTrend->dY[idx];
+      pTrend->dSumXX -= dX * dX;
+      pTrend->dSumXY -= dX * pTrend->dY[idx];
+   }
+   else
+   {
+      pTrend->iCount++;
+   }
+
+   dX = dTime - pTrend->dOrigin;
+   pTrend->dX[idx] = dX;
+   pTrend->dY[idx] = dValue;
+   pTrend->dSumX += dX;
+   pTrend->dSumY += dValue;
+   pTrend->dSumXX += dX * dX;
+   pTrend->dSumXY += dX * dValue;
+
+   if (++pTrend->iNext == TREND_WINDOW)
+   {
+      pTrend->iNext = 0;
+      Rebase(pTrend);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Trend_Slope:  slope of the least squares line
+ *
+@param pdSlope:    receives the change of the value per s
+ *
+@return            TRUE, or FALSE if there are too few values or all of them
+                   have the same time stamp
+ *******************************************************************************/
+int Trend_Slope(const TREND *pTrend, double *pdSlope)
+{
+   double dDenominator;
+
+   if (pTrend->iCount < TREND_MIN_COUNT)
+   {
+      return 0;
+   }
+   dDenominator = pTrend->iCount * pTrend->dSumXX
+      - pTrend->dSumX * pTrend->dSumX;
+   if (dDenominator <= 0.0)
+   {
+      return 0;
+   }
+   *pdSlope = (pTrend->iCount * pTrend->dSumXY
+      - pTrend->dSumX * pTrend->dSumY) / dDenominator;
+   return 1;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+Trend_Guidance:  where the value goes relative to the limits
+ *
+@param dValue:          current value
+@param pdTimeToWindow:  receives the estimated s until the value is within
+                        the limits, TREND_APPROACHING only
+ *
+@return                 TREND_xxx
+ *******************************************************************************/
+int Trend_Guidance(const TREND *pTrend, double dValue, double dLowerLimit,
+   double dUpperLimit, double *pdTimeToWindow)
+{
+   double dSlope;
+   double dDistance;
+
+   if ((dValue >= dLowerLimit) && (dValue <= dUpperLimit))
+   {
+      return TREND_INSIDE;
+   }
+   if (!Trend_Slope(pTrend, &dSlope))
+   {
+      return TREND_UNKNOWN;
+   }
+
+   /* signed distance to the nearer limit, positive -> limit is above */
+   dDistance = (dValue < dLowerLimit) ? dLowerLimit - dValue
+      : dUpperLimit - dValue;
+   if ((dSlope == 0.0) || (dDistance / dSlope > TREND_HORIZON))
+   {
+      return TREND_STEADY;
+   }
+   if (dDistance / dSlope < 0.0)
+   {
+      return TREND_MOVING_AWAY;
+   }
+   *pdTimeToWindow = dDistance / dSlope;
+   return TREND_APPROACHING;
+}
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* FUNCTION *******************************************************************/
+/**
+Rebase:  moves the origin to the oldest value and recalculates the sums
+ *******************************************************************************/
+static void Rebase(TREND *pTrend)
+{
+   double dShift = pTrend->dX[pTrend->iNext];
+   int idx;
+
+   pTrend->dOrigin += dShift;
+   pTrend->dSumX = 0.0;
+   pTrend->dSumY = 0.0;
+   pTrend->dSumXX = 0.0;
+   pTrend->dSumXY = 0.0;
+   for (idx = 0; idx < pTrend->iCount; idx++)
+   {
+      pTrend->dX[idx] -= dShift;
+      pTrend->dSumX += pTrend->dX[idx];
+      pTrend->dSumY += pTrend->dY[idx];
+      pTrend->dSumXX += pTrend->dX[idx] * pTrend->dX[idx];
+      pTrend->dSumXY += pTrend->dX[idx] * pTrend->dY[idx];
+   }
+}
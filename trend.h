@@ -0,0 +1,57 @@
+/*******************************************************************************/
+/**
+@file trend.h
+*
+@brief Direction and speed of the shown values, time to reach the limits
+*
+A TREND keeps a least squares line over the last TREND_WINDOW values passed
+to tsadj_SetValueAdjustmentPanel. It is part of the memory block of a
+resource and never allocates.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef TREND_H
+#define TREND_H
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+#define TREND_WINDOW          16    /* values of the regression            */
+#define TREND_MIN_COUNT       3     /* values needed for an estimate       */
+#define TREND_HORIZON         60.0  /* s, slower -> TREND_STEADY           */
+
+/* Guidance states */
+#define TREND_UNKNOWN         0     /* not enough values yet               */
+#define TREND_INSIDE          1     /* value within the limits             */
+#define TREND_APPROACHING     2     /* moves towards the limits            */
+#define TREND_MOVING_AWAY     3     /* moves away from the limits          */
+#define TREND_STEADY          4     /* would not reach them in the horizon */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+typedef struct
+{
+   int iCount;                   /* values in the window                 */
+   int iNext;                    /* ring position of the next value      */
+   double dOrigin;               /* time stamp x = 0 of the sums         */
+   double dX[TREND_WINDOW];      /* s since dOrigin                      */
+   double dY[TREND_WINDOW];
+   double dSumX;
+   double dSumY;
+   double dSumXX;
+   double dSumXY;
+} TREND;
+
+/* GLOBAL FUNCTION DECLARATIONS ***********************************************/
+
+void Trend_Reset(TREND *pTrend);
+void Trend_Add(TREND *pTrend, double dTime, double dValue);
+int  Trend_Slope(const TREND *pTrend, double *pdSlope);
+int  Trend_Guidance(const TREND *pTrend, double dValue, double dLowerLimit,
+        double dUpperLimit, double *pdTimeToWindow);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
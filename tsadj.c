@@ -1,1088 +1,3915 @@
-
-/*******************************************************************************/
-/**
-@file tsadjus.c
- *
-@brief all functions to control teststand control panel @ compactTSVP
- *
-@version 1.0.0.0
- *
-@author Robert Renner <A HREF=k"mailto:robert.renner@spectral.de">robert.renner@spectral.de</A>\n
-&copy; Spectral Electronic Forschungs- und Produktions GmbH - Berlin \n \n
-language: ANSI-C ISO/IEC9899:1990
- *
-<b>History:</b>
-- <b>23.11.2007 R. Renner</b>
-- Initial revision
-
- ******************************************************************************
- *****************************************************************************/
-
-/* INCLUDE FILES **************************************************************/
-
-/* EXPORT */
-#include "tsadj.h"
-
-/* GLOBAL CONSTANT DEFINITIONS ************************************************/
-
-
-#ifndef COINIT_MULTITHREADED
-   #define COINIT_MULTITHREADED  0x0      // OLE calls objects on any thread.
-#endif
-
-
-
-/* GLOBAL VARIABLES DEFINITION ************************************************/
-CRITICAL_SECTION CriticalSection;
-int giAdjustmentPanelHandle = 0;
-int giMenuBarHandle = 0;
-int iThreadCount = 0;
-HANDLE hThreadReady = 0;
-HANDLE hThreadHandle = 0;
-
-
-
-/* LOCAL DEFINES *************************************************/
-
-
-/* LOCAL FUNCTION DEFINITIONS *************************************************/
-
-/* LOCAL CONSTANT DEFINITIONS *************************************************/
-static const char LIBRARY_NAME[] = "TSADJ"; /* Library Version String */
-static const char LIB_VERSION[] = "TSADJ 1.1.0.4"; /* Library Version String */
-static char *cDLLPATH;
-
-/* Error code to message reference table */
-static GTSL_ERROR_TABLE errorTable =
-{
-   /* library specific error codes and messages */
-   {
-      TSPAN_ERR_NOT_A_BENCH, "The given resource is not a bench"
-   }
-   ,
-   {
-      TSPAN_ERR_THREADWASNOTSTARTET,
-         "Thread was not started. Possible cause: UIR file was not found."
-   }
-   ,                                                                           
-   {
-      TSPAN_ERR_WRONGFORMATYTE,
-         "Format type is not supported."
-   }     
-  ,
-   /* include common GTSL error codes and messages */
-   GTSL_ERROR_CODES_AND_MESSAGES,                         
-                                                           
-   /* this must be the last entry ! */
-   {
-      0, NULL
-   }
-};
-                                                             
-
-/* LOCAL TYPE DEFINITIONS *****************************************************/
-
-typedef struct
-{
-   int iOwner; /* memory block owner                          */
-   int iSimulation; /* driver simulation                           */
-   int iDemoMode; /* driver simulation                           */
-   int iActualPanelHandle;
-   DWORD gThreadID;
-   
-} BENCH_STRUCT;
-
-typedef struct threadDataRec
-{
-   CAObjHandle execution;
-   CAObjHandle ThisContext;
-} ThreadData;
-
-
-/* LOCAL MACRO DEFINITIONS ****************************************************/
-
-
-/* LOCAL FUNCTION DECLARATIONS ************************************************/
-WINOLEAPI CoInitializeEx(LPVOID pvReserved, DWORD dwCoInit);
-int StartThreadForAdjustmentPanel(void *data); 
-void CVICALLBACK QuitThread(void *callbackData);
-static void formatError(char buffer[], int code, long resId, char *benchDevice);
-
-/* EXPORTED FUNCTION DEFINITIONS **********************************************/
-
-int __stdcall DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReserved)
-{
-   switch (fdwReason)
-   {
-      case DLL_PROCESS_ATTACH:
-
-         if (InitCVIRTE(hinstDLL, 0, 0) == 0)
-         /* Needed if linking in external compiler; harmless otherwise */
-         {
-            return 0;
-         }
-         /* out of memory */
-         InitializeCriticalSection(&CriticalSection);
-         hThreadReady = CreateEvent(NULL, TRUE, FALSE, NULL);
-         //GetModuleDir(__CVIUserHInst, cDLLPATH);
-         if (hThreadReady == NULL)
-         {
-            return FALSE;
-         }
-         break;
-
-      case DLL_PROCESS_DETACH:
-
-         if (!CVIRTEHasBeenDetached())
-         /* Do not call CVI functions if cvirte.dll has already been detached.    */
-         {
-            CloseCVIRTE(); /* Needed if linking in external compiler; harmless
-               */
-            //otherwise
-         }
-         break;
-   }
-
-   return 1;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-int __stdcall DllEntryPoint(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID
-   lpvReserved)
-{
-   /* Included for compatibility with Borland    */
-
-   return DllMain(hinstDLL, fdwReason, lpvReserved);
-}
-
-
-
-void __stdcall tsadj_Setup(CAObjHandle sequenceContext, char *pBenchName, long
-   *pResourceId, short *pErrorOccurred, long *pErrorCode, char errorMessage[])
-{
-   char cSectionName[1024];
-   char cTraceBuffer[1024];
-   char cTempBuffer[1024];
-   char cTempBuffer2[1024];
-   char cSystemID[1024];
-   
-   short sLicenseOK;
-   
-   int idx;
-
-   long lBytesWritten;
-   long lMatched;
-   long lResourceType;
-   long lTrace;
-
-   BENCH_STRUCT *pBench = NULL;
-   
-   ERRORINFO pTSErrorInfo;
-   
-   /*---------------------------------------------------------------------/
-   /   Allocate the resource:
-   /     Check whether "pBenchName" can be found in the INI files and
-   /     return a resource ID for the bench. This resource ID is the
-   /     "ticket" for any subsequent action dealing with this bench.
-   /---------------------------------------------------------------------*/
-   RESMGR_Alloc_Resource(sequenceContext, pBenchName, pResourceId,
-      pErrorOccurred, pErrorCode, errorMessage);
-
-   /*---------------------------------------------------------------------/
-   /  Check for trace flag:
-   /    The "Trace" key in the bench section is searched and its
-   /    value is checked. The result is recorded in the static
-   /    variable trace
-   /---------------------------------------------------------------------*/
-   if (!*pErrorOccurred)
-   {
-      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "", RESMGR_KEY_TRACE,
-         "1", &lTrace, pErrorOccurred, pErrorCode, errorMessage);
-   }
-   if (!*pErrorOccurred)
-   {
-      RESMGR_Set_Trace_Flag(*pResourceId, lTrace);
-
-      if (lTrace)
-      {
-         RESMGR_Trace(">>TSADJ_Setup begin");
-         RESMGR_Trace("Tracing for tsadj.dll enabled");
-         sprintf(cTraceBuffer, "Bench name %s -> Resource ID %ld", pBenchName,
-            *pResourceId);
-         RESMGR_Trace(cTraceBuffer);
-      }
-   }
-
-   /*---------------------------------------------------------------------/
-   /   Check the resource type:
-   /     The tspan library requires that pBenchName refers to a bench,
-   /     not to a single device. It is always recommended to use a bench
-   /     instead of a device, because a bench makes it easy to add
-   /     a device in future and to work with alternative devices
-   /     like a ....
-   /---------------------------------------------------------------------*/
-   if (! *pErrorOccurred)
-   {
-      RESMGR_Get_Resource_Type(sequenceContext,  *pResourceId, &lResourceType,
-         pErrorOccurred, pErrorCode, errorMessage);
-      if (!*pErrorOccurred)
-      {
-         if (lResourceType != RESMGR_TYPE_BENCH)
-         {
-            *pErrorOccurred = TRUE;
-            *pErrorCode = TSPAN_ERR_NOT_A_BENCH;
-            formatError(errorMessage,  *pErrorCode,  *pResourceId, NULL);
-         }
-      }
-   }
-   
-   /*---------------------------------------------------------------------/
-   /   Check the license:
-   /      If correct license file not found, the tspan library runs in 
-   /      demo mode
-   /---------------------------------------------------------------------*/
-   /*if (!*pErrorOccurred)
-   {
-       RESMGR_Read_ROM (sequenceContext, cSystemID, pErrorOccurred, pErrorCode, errorMessage);
-       sLicenseOK = lc_CheckLicense ("SW-ITS", cSystemID);
-   } */
-   
-   /*---------------------------------------------------------------------/
-   /   Allocate a memory block:
-   /     The tspan library uses a structure to store some private
-   /     information along with the resource ID. This information can
-   /     be retrieved in subsequent calls to the measurement functions.
-   /---------------------------------------------------------------------*/
-   if (!*pErrorOccurred)
-   {
-      RESMGR_Alloc_Memory(sequenceContext,  *pResourceId, sizeof(BENCH_STRUCT),
-         (void **)(&pBench), pErrorOccurred, pErrorCode, errorMessage);
-      if (! *pErrorOccurred)
-      {
-         /* set the memory block owner field to a unique value
-         which identifies the ENOCEAN library as the owner of the memory.
-          */
-         pBench->iOwner = TSPAN_ERR_BASE;
-
-         /* set default values */
-         /*if (sLicenseOK) 
-         {
-            sprintf(cTraceBuffer, "Valid license found! (System ID: %s)", cSystemID);
-            pBench->iDemoMode = FALSE; 
-         }
-         if (!sLicenseOK) 
-         {
-             sprintf(cTraceBuffer, "Demo mode is enabled, not valid license found! (System ID: %s)", cSystemID);
-             pBench->iDemoMode = FALSE;
-         }		*/
-		 pBench->iDemoMode = FALSE;
-         RESMGR_Trace(cTraceBuffer);
-         pBench->iSimulation = FALSE;
-         pBench->iActualPanelHandle = 0;
-      }
-   }
-
-   /*---------------------------------------------------------------------/
-   /   Check for simulation flag:
-   /     The "Simulation" key in the bench section is searched and its
-   /     value is checked. The result is recorded in the memory block.
-   /     Any other library-specific information like calibration,
-   /     path for calibration files etc. may be handled the same way
-   /     (not shown in the example).
-   /---------------------------------------------------------------------*/
-   if (!*pErrorOccurred)
-   {
-      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
-         RESMGR_KEY_SIMULATION, "1", &lMatched, pErrorOccurred, pErrorCode,
-         errorMessage);
-      if (! *pErrorOccurred)
-      {
-         if (lMatched)
-         {
-            pBench->iSimulation = TRUE;
-            if (lTrace)
-            {
-               RESMGR_Trace("Simulation is enabled!");
-            }
-         }
-      }
-   }
-   
-   
-   /*---------------------------------------------------------------------/
-   /   Cleanup and error handling
-   /---------------------------------------------------------------------*/
-   if (lTrace)
-   {
-      if (*pErrorOccurred)
-      {
-         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
-         RESMGR_Trace(cTraceBuffer);
-      }
-      RESMGR_Trace("<<TSADJ_Setup end");
-   }
-
-}
-
-
-
-
-void __stdcall tsadj_DisplayAdjustmentPanel (CAObjHandle sequenceContext,
-                                            long pResourceId, char nameOfStep[], char buttonText[],
-                                            char unit[], char compType[],
-                                            char format[], double lowerLimit,
-                                            double upperLimit, short AlwaysOnTop,
-                                            short *pErrorOccurred,
-                                            long *pErrorCode, char errorMessage[])
-{
-   char cTraceBuffer[1024];
-   char cTempBuffer[1024]; 
-   char cValue[1024]; 
-   int iTabHandle;
-   
-   int iFindFormat;
-   int iFindComaHa;
-   int iCanConvert;
-   char cTemp[4];
-   int iTemp;
-   int idx;
-   char cPrecision[4];
-   int iPrecision;
-
-   long lTrace;
-
-   BENCH_STRUCT *pBench = NULL;
-
-   CAObjHandle execution;
-   ERRORINFO errorInfo;
-   HRESULT hResult;
-   static ThreadData threadDataItem =
-   {
-      0
-   };
-   CAObjHandle tmpExecutionObjHandle = 0;
-   LPDISPATCH tmpExecutionDispPtr = NULL;
-   CAObjHandle tmpStationGlobalsObjHandle = 0;
-   LPDISPATCH tmpStationGlobalsDispPtr = NULL;
-
-
-   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
-
-   if (lTrace)
-   {
-      RESMGR_Trace(">>TSPAN_DisplayAdjustmentPanel begin");
-   }
-   /*---------------------------------------------------------------------/
-   /   Retrieve the memory pointer:
-   /     Get a pointer to the memory block to check the configuration
-   /---------------------------------------------------------------------*/
-   RESMGR_Get_Mem_Ptr(sequenceContext, pResourceId, (void **)(&pBench),
-      pErrorOccurred, pErrorCode, errorMessage);
-   /*---------------------------------------------------------------------/
-   /   Check for memory block owner:
-   /     To be sure that the given resource ID belongs to the ENOCEAN
-   /     library, we check the "owner" field of the memory block if it
-   /     contains the "magic number" we have stored there in the
-   /     ENOCEAN_Setup function
-   /---------------------------------------------------------------------*/
-   if (! *pErrorOccurred)
-   {
-      if (pBench->iOwner != TSPAN_ERR_BASE)
-      {
-         *pErrorOccurred = TRUE;
-         *pErrorCode = GTSL_ERR_WRONG_RESOURCE_ID;
-         formatError(errorMessage,  *pErrorCode, pResourceId, NULL);
-      }
-   }
-
-   if (! *pErrorOccurred)
-   {
-      if (lTrace)
-      {
-         RESMGR_Trace("InterlockedIncrement");
-      }
-
-      // Ensure only 1 thread updates thread_count at a time
-      InterlockedIncrement(&iThreadCount);
-
-      if (lTrace)
-      {
-         sprintf(cTraceBuffer, "ThreadCount: %d", iThreadCount);
-         RESMGR_Trace(cTraceBuffer);
-         RESMGR_Trace("EnterCriticalSection");
-      }
-
-      //InitializeCriticalSection(&CriticalSection);
-
-      EnterCriticalSection(&CriticalSection);
-
-      if (iThreadCount > 1)
-      {
-         LeaveCriticalSection(&CriticalSection);
-      }
-      else
-      {
-
-         if (lTrace)
-         {
-            RESMGR_Trace("TS_SeqContextGetProperty");
-         }
-
-         //Get teststand executon reference
-         hResult = TS_SeqContextGetProperty(sequenceContext, &errorInfo,
-            TS_SeqContextExecution, CAVT_OBJHANDLE, &execution);
-         if (hResult < 0)
-         {
-            *pErrorOccurred = TRUE;
-            *pErrorCode = hResult;
-            CA_GetAutomationErrorString(hResult, errorMessage, 1024);
-         }
-
-      }
-
-   }
-
-   if (lTrace)
-   {
-      RESMGR_Trace("Add a reference to the execution activeX automation object")
-         ;
-   }
-   // add a reference to the execution activeX automation object
-   if (! *pErrorOccurred)
-   {
-      hResult = CA_GetDispatchFromObjHandle(execution, &tmpExecutionDispPtr);
-      if (hResult < 0)
-      {
-         *pErrorOccurred = TRUE;
-         *pErrorCode = hResult;
-         CA_GetAutomationErrorString(hResult, errorMessage, 1024);
-      }
-   }
-
-   if (! *pErrorOccurred)
-   {
-      hResult = CA_CreateObjHandleFromIDispatch(tmpExecutionDispPtr, 1,
-         &tmpExecutionObjHandle);
-      if (hResult < 0)
-      {
-         *pErrorOccurred = TRUE;
-         *pErrorCode = hResult;
-         CA_GetAutomationErrorString(hResult, errorMessage, 1024);
-      }
-   }
-
-   threadDataItem.execution = tmpExecutionObjHandle;
-   if (lTrace)
-   {
-      RESMGR_Trace("Add a reference to the station globals activeX automation object");
-   }
-   // add a reference to the ThisContext activeX automation object
-   if (! *pErrorOccurred)
-   {
-      hResult = CA_GetDispatchFromObjHandle(sequenceContext,
-         &tmpStationGlobalsDispPtr);
-      if (hResult < 0)
-      {
-         *pErrorOccurred = TRUE;
-         *pErrorCode = hResult;
-         CA_GetAutomationErrorString(hResult, errorMessage, 1024);
-      }
-   }
-   if (! *pErrorOccurred)
-   {
-      hResult = CA_CreateObjHandleFromIDispatch(tmpStationGlobalsDispPtr, 1,
-         &tmpStationGlobalsObjHandle);
-      if (hResult < 0)
-      {
-         *pErrorOccurred = TRUE;
-         *pErrorCode = hResult;
-         CA_GetAutomationErrorString(hResult, errorMessage, 1024);
-      }
-   }
-   if (! *pErrorOccurred)
-   {
-      threadDataItem.ThisContext = tmpStationGlobalsObjHandle;
-
-      if (lTrace)
-      {
-         RESMGR_Trace("Create new thread for UIR control");
-      }
-	  
-      hThreadReady = 0;
-      //Create new thread for UIR control
-      hThreadHandle = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)
-         StartThreadForAdjustmentPanel, (void*) &threadDataItem, 0, &pBench
-         ->gThreadID);
-
-      // Wait until thread starts
-      if (WaitForSingleObject(hThreadReady, WAITTMO) == WAIT_TIMEOUT)
-      {
-         *pErrorOccurred = TRUE;
-         *pErrorCode = TSPAN_ERR_THREADWASNOTSTARTET;
-         formatError(errorMessage,  *pErrorCode, pResourceId, NULL);
-      }
-
-   }
-   
-   if (lTrace)
-   {
-      RESMGR_Trace("LeaveCriticalSection");
-   }
-   
-   LeaveCriticalSection(&CriticalSection);
-
-   if (execution)
-   {
-      CA_DiscardObjHandle(execution);
-      execution = 0;
-   }		  
-
-   Delay(1.0);
-   
-   SetCtrlVal(giAdjustmentPanelHandle, ADJUSTMENT_TEXT, nameOfStep); 
-   
-   FormatValues (cValue, format, lowerLimit); 
-   sprintf(cTempBuffer, "LL: %s %s", cValue, unit);
-   SetCtrlVal(giAdjustmentPanelHandle, ADJUSTMENT_LL, cTempBuffer);
-   
-   FormatValues (cValue, format, upperLimit);   
-   sprintf(cTempBuffer, "UL: %s %s", cValue, unit);
-   SetCtrlVal(giAdjustmentPanelHandle, ADJUSTMENT_UL, cTempBuffer); 
-   
-   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_UL, ATTR_TEXT_BGCOLOR, VAL_TRANSPARENT); 
-   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_LL, ATTR_TEXT_BGCOLOR, VAL_TRANSPARENT); 
-   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_TEXT, ATTR_TEXT_BGCOLOR, VAL_TRANSPARENT); 
-   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_UNIT, ATTR_TEXT_BGCOLOR, VAL_TRANSPARENT); 
-   SetCtrlVal(giAdjustmentPanelHandle, ADJUSTMENT_UNIT, unit); 
-    
-   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_MIN_VALUE, lowerLimit);
-   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_MAX_VALUE, upperLimit);
-   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_FILL_COLOR, VAL_BLACK);
-   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_FILL_HOUSING_COLOR, VAL_WHITE);
-   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_FILL_HOUSING_COLOR, VAL_WHITE);
-   
-   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_FORMAT, VAL_DECIMAL_FORMAT);
-   iFindFormat = FindPattern (format, 0, strlen(format), "f", 0, 0);
-   if (iFindFormat != -1) 
-   {
-	   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_FORMAT, VAL_FLOATING_PT_FORMAT);
-   } else 
-   {
-   	iFindFormat = FindPattern (format, 0, strlen(format), "e", 0, 0);
-   	if (iFindFormat != -1) SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_FORMAT, VAL_SCIENTIFIC_FORMAT);
-   }
-   
-   if (iFindFormat != -1)
-   {
-	   iFindComaHa = FindPattern (format, 0, strlen(format), ".", 0, 0);
-	   if (iFindComaHa == -1) iFindComaHa = FindPattern (format, 0, strlen(format), ",", 0, 0);
-	   if (iFindComaHa != -1) 
-	   {
-		   iCanConvert = 1; idx = 0;
-		   while (iCanConvert)
-		   {
-				iFindComaHa++;
-				cTemp[0] = format[iFindComaHa];
-				cTemp[1] = '\0';
-				iCanConvert = StrToInt(cTemp, &iTemp);
-				if (iCanConvert) 
-				{
-					cPrecision[idx] = format[iFindComaHa];
-					idx++;
-				}
-		   }
-		   cPrecision[idx] = '\0'; 
-	   }
-	   iCanConvert = StrToInt(cPrecision, &iPrecision);
-	   SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_PRECISION, iPrecision);
-   
-   }
-   
-   
-   
-   if (strlen(buttonText) > 8)
-   {
-   		cTempBuffer[0] = buttonText[0];
-	    cTempBuffer[1] = buttonText[1];
-	    cTempBuffer[2] = buttonText[2];
-	    cTempBuffer[3] = buttonText[3];
-	    cTempBuffer[4] = buttonText[4];
-	    cTempBuffer[5] = buttonText[5];
-	    cTempBuffer[6] = buttonText[6];
-	    cTempBuffer[7] = buttonText[7];
-	    cTempBuffer[8] = buttonText[8];
-	    cTempBuffer[9] = '.';
-	    cTempBuffer[10] = '.';
-	    cTempBuffer[11] = '.';
-	    SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_OK, ATTR_LABEL_TEXT, cTempBuffer);
-   } else {
-   		SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_OK, ATTR_LABEL_TEXT, buttonText);
-   }
-   
-   if (pBench->iDemoMode)
-   {
-   		SetCtrlVal(giAdjustmentPanelHandle, ADJUSTMENT_TEXT, "Adjustment panel in demo mode");  
-		SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_OK, ATTR_LABEL_TEXT, "DEMO"); 
-   }
-   
-   Delay(0.6);
-   
-   ProcessDrawEvents();
-   
-   if (lTrace)
-   {
-      if (*pErrorOccurred)
-      {
-         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
-         RESMGR_Trace(cTraceBuffer);
-      }
-      RESMGR_Trace("<<TSPAN_DisplayAdjustmentPanel end");
-   }
-   
-    
-}
-
-void __stdcall tsadj_SetValueAdjustmentPanel (CAObjHandle sequenceContext,
-                                             long pResourceId, double value,
-                                             short *pErrorOccurred,
-                                             long *pErrorCode,
-                                             char errorMessage[])
-{
-
-   char cTraceBuffer[1024];
-   double lowerLimit;
-   double upperLimit;
-   long lTrace;
-
-   BENCH_STRUCT *pBench = NULL;
-
-   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
-
-   if (lTrace)
-   {
-      RESMGR_Trace(">>TSPAN_SetValueAdjustmentPanel begin");
-   }
-   /*---------------------------------------------------------------------/
-   /   Retrieve the memory pointer:
-   /     Get a pointer to the memory block to check the configuration
-   /---------------------------------------------------------------------*/
-   RESMGR_Get_Mem_Ptr(sequenceContext, pResourceId, (void **)(&pBench),
-      pErrorOccurred, pErrorCode, errorMessage);
-   /*---------------------------------------------------------------------/
-   /   Check for memory block owner:
-   /     To be sure that the given resource ID belongs to the ENOCEAN
-   /     library, we check the "owner" field of the memory block if it
-   /     contains the "magic number" we have stored there in the
-   /     ENOCEAN_Setup function
-   /---------------------------------------------------------------------*/
-   if (! *pErrorOccurred)
-   {
-      if (pBench->iOwner != TSPAN_ERR_BASE)
-      {
-         *pErrorOccurred = TRUE;
-         *pErrorCode = GTSL_ERR_WRONG_RESOURCE_ID;
-         formatError(errorMessage,  *pErrorCode, pResourceId, NULL);
-      }
-   }
-
-   if (! *pErrorOccurred)
-   {
-	  
-	  GetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_MIN_VALUE, &lowerLimit);
-      GetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_INDICATOR, ATTR_MAX_VALUE, &upperLimit);
-      SetCtrlVal(giAdjustmentPanelHandle,ADJUSTMENT_INDICATOR,value);
-	  if ((value < lowerLimit) || (value > upperLimit))
-      {
-		SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_BACKGROUND, ATTR_TEXT_BGCOLOR, VAL_RED);
-	  } else {
-	  	SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_BACKGROUND, ATTR_TEXT_BGCOLOR, VAL_GREEN);
-	  }
-	  
-	  if (pBench->iDemoMode)
-      {
-   		Delay(0.5);
-		SetCtrlVal(giAdjustmentPanelHandle, ADJUSTMENT_TEXT, "Adjustment panel in demo mode");  
-		SetCtrlAttribute (giAdjustmentPanelHandle, ADJUSTMENT_BACKGROUND, ATTR_TEXT_BGCOLOR, VAL_MAGENTA);
-		SetCtrlVal(giAdjustmentPanelHandle,ADJUSTMENT_INDICATOR,-1.0);
-      }
-   
-   }
-   
-   
-   if (lTrace)
-   {
-      if (*pErrorOccurred)
-      {
-         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
-         RESMGR_Trace(cTraceBuffer);
-      }
-      RESMGR_Trace("<<TSPAN_SetValueAdjustmentPanel end");
-   }
-
-}
-
-void __stdcall tsadj_HideAdjustmentPanel (CAObjHandle sequenceContext,
-                                         long pResourceId, short *pErrorOccurred,
-                                         long *pErrorCode, char errorMessage[])
-{
-
-   char cTraceBuffer[1024];
-
-   long lTrace;
-
-   BENCH_STRUCT *pBench = NULL;
-
-   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
-
-   if (lTrace)
-   {
-      RESMGR_Trace(">>TSPAN_HideAdjustmentPanel begin");
-   }
-   /*---------------------------------------------------------------------/
-   /   Retrieve the memory pointer:
-   /     Get a pointer to the memory block to check the configuration
-   /---------------------------------------------------------------------*/
-   RESMGR_Get_Mem_Ptr(sequenceContext, pResourceId, (void **)(&pBench),
-      pErrorOccurred, pErrorCode, errorMessage);
-   /*---------------------------------------------------------------------/
-   /   Check for memory block owner:
-   /     To be sure that the given resource ID belongs to the ENOCEAN
-   /     library, we check the "owner" field of the memory block if it
-   /     contains the "magic number" we have stored there in the
-   /     ENOCEAN_Setup function
-   /---------------------------------------------------------------------*/
-   if (! *pErrorOccurred)
-   {
-      if (pBench->iOwner != TSPAN_ERR_BASE)
-      {
-         *pErrorOccurred = TRUE;
-         *pErrorCode = GTSL_ERR_WRONG_RESOURCE_ID;
-         formatError(errorMessage,  *pErrorCode, pResourceId, NULL);
-      }
-   }
-
-   if (! *pErrorOccurred)
-   {
-      if (lTrace)
-      {
-         RESMGR_Trace("InterlockedDecrement");
-      }
-      // Ensure only 1 thread updates thread_count at a time
-      InterlockedDecrement(&iThreadCount);
-
-      if (lTrace)
-      {
-         RESMGR_Trace("EnterCriticalSection");
-      }
-
-      EnterCriticalSection(&CriticalSection);
-      if (iThreadCount > 0)
-      {
-         LeaveCriticalSection(&CriticalSection);
-         return ;
-      }
-
-      if (lTrace)
-      {
-         RESMGR_Trace("LeaveCriticalSection");
-      }
-
-      LeaveCriticalSection(&CriticalSection);
-
-      if (lTrace)
-      {
-         RESMGR_Trace("PostDeferredCallToThread");
-      }
-
-      // Call function in new thread to quit new thread
-      PostDeferredCallToThread(QuitThread, 0, pBench->gThreadID);
-
-      if (hThreadHandle != NULL)
-      {
-         // wait for the thread to complete.
-         WaitForSingleObject(hThreadHandle, INFINITE);
-         CloseHandle(hThreadHandle);
-      }
-	  
-	  DiscardPanel(giAdjustmentPanelHandle);
-	  
-   
-
-   }
-   
-   
-   if (lTrace)
-   {
-      if (*pErrorOccurred)
-      {
-         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
-         RESMGR_Trace(cTraceBuffer);
-      }
-      RESMGR_Trace("<<TSPAN_HideAdjustmentPanel end");
-   }
-
-}
-
-void __stdcall tsadj_Cleanup(CAObjHandle sequenceContext, long pResourceId,
-   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
-{
-   char cTraceBuffer[1024];
-
-   long lTrace;
-
-   BENCH_STRUCT *pBench = NULL;
-
-   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
-
-   if (lTrace)
-   {
-      RESMGR_Trace(">>TSADJ_Cleanup begin");
-   }
-   /*---------------------------------------------------------------------/
-   /   Retrieve the memory pointer:
-   /     Get a pointer to the memory block to check the configuration
-   /---------------------------------------------------------------------*/
-   RESMGR_Get_Mem_Ptr(sequenceContext, pResourceId, (void **)(&pBench),
-      pErrorOccurred, pErrorCode, errorMessage);
-   /*---------------------------------------------------------------------/
-   /   Check for memory block owner:
-   /     To be sure that the given resource ID belongs to the ENOCEAN
-   /     library, we check the "owner" field of the memory block if it
-   /     contains the "magic number" we have stored there in the
-   /     ENOCEAN_Setup function
-   /---------------------------------------------------------------------*/
-   if (! *pErrorOccurred)
-   {
-      if (pBench->iOwner != TSPAN_ERR_BASE)
-      {
-         *pErrorOccurred = TRUE;
-         *pErrorCode = GTSL_ERR_WRONG_RESOURCE_ID;
-         formatError(errorMessage,  *pErrorCode, pResourceId, NULL);
-      }
-   }
-   /*---------------------------------------------------------------------/
-   /   Dispose memory:
-   /     Free the memory block associated with the resource ID.
-   /     Note that pBench is no longer valid now because it points
-   /     to dynamic memory that has been released!
-   /---------------------------------------------------------------------*/
-   if (! *pErrorOccurred)
-   {
-      RESMGR_Free_Memory(sequenceContext, pResourceId, pErrorOccurred,
-         pErrorCode, errorMessage);
-   }
-   pBench = NULL;
-
-   /*---------------------------------------------------------------------/
-   /   Free resource:
-   /     The resource ID (our "ticket") is given back to the resource
-   /     manager and may be reused in a subsequent RESMGR_Alloc_Resource
-   /     call.
-   /---------------------------------------------------------------------*/
-   if (! *pErrorOccurred)
-   {
-      RESMGR_Free_Resource(sequenceContext, pResourceId, pErrorOccurred,
-         pErrorCode, errorMessage);
-   }
-   if (! *pErrorOccurred)
-   {
-      if (lTrace)
-      {
-         sprintf(cTraceBuffer, "Free Resource ID %ld", pResourceId);
-         RESMGR_Trace(cTraceBuffer);
-      }
-   }
-
-   /*---------------------------------------------------------------------/
-   /   Cleanup and error handling
-   /---------------------------------------------------------------------*/
-   if (lTrace)
-   {
-      if (*pErrorOccurred)
-      {
-         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
-         RESMGR_Trace(cTraceBuffer);
-      }
-      RESMGR_Trace("<<TSADJ_Cleanup end");
-   }
-
-}
-
-int StartThreadForAdjustmentPanel(void *data)
-{
-
-   ThreadData *threadData = (ThreadData*) data;
-   
-   CoInitializeEx(NULL, COINIT_MULTITHREADED);
-
-   //  CoInitializeEx() is not declared in objbase.h which ships with CVI 5.0.
-   //  You will need to declare this function yourself using the following declaration:
-   //  WINOLEAPI  CoInitializeEx(LPVOID pvReserved, DWORD dwCoInit);
-
-   //  You must also use objbase.lib which ships with VC++ 5.0.
-
-
-   if ((giAdjustmentPanelHandle = LoadPanelEx(0, "testadjustmentpanel.uir",
-      ADJUSTMENT, __CVIUserHInst)) < 0)
-   {
-      return  - 1;
-   }
-
- 
-   DisplayPanel(giAdjustmentPanelHandle);
-   
-   //SetPanelAttribute(giActualPanelHandle, ATTR_TITLE, cLastNameOfStep);
-   //SetCtrlAttribute(panelHandle, PANEL_INFO, ATTR_CTRL_VAL, cTextMessageIntern);
-   //GetCtrlAttribute (giActualPanelHandle, OP_SINGLE_TESTCASEPATHWAY, ATTR_VISIBLE_LINES, &giVisibleLines);
-   
-   /*SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_REPORT, ATTR_OFF_COLOR, VAL_PANEL_GRAY);
-   SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_TICKET, ATTR_OFF_COLOR, VAL_PANEL_GRAY);
-   SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_YIELD, ATTR_OFF_COLOR, VAL_PANEL_GRAY);
-   SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_REPORT, ATTR_ON_COLOR, VAL_DK_GREEN);
-   SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_TICKET, ATTR_ON_COLOR, VAL_DK_GREEN);
-   SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_YIELD, ATTR_ON_COLOR, VAL_DK_GREEN);   */
-
-   // Use thread data in callbacks
-   SetCtrlAttribute(giAdjustmentPanelHandle, ADJUSTMENT_OK, ATTR_CALLBACK_DATA, data);
-   
-   // Signal main thread that the new thread started
-   SetEvent(hThreadReady);
-
-   RunUserInterface();
-
-   DiscardPanel(giAdjustmentPanelHandle);
-   if (threadData->execution)
-   {
-      CA_DiscardObjHandle(threadData->execution);
-      threadData->execution = 0;
-   }
-   if (threadData->ThisContext)
-   {
-      CA_DiscardObjHandle(threadData->ThisContext);
-      threadData->ThisContext = 0;
-   }
-   Error: return 0;
-}
-
-
-
-/* FUNCTION *******************************************************************/
-/**
-formatError:    formats the error string.
-formats the error string.
- *
-@precondition       --
-@postcondition      --
-@side_effects       --
- *
-@param buffer:      points to a buffer where the error message is stored
-(size must be >= GTSL_ERROR_BUFFER_SIZE)
-@param code:        Error code
-@param resId:       Resource ID
-@param benchDevice: Name of the bench device, may be NULL
- *
-@return             void
- *******************************************************************************/
-static void formatError(char buffer[], int code, long resId, char *benchDevice)
-{
-   char *pMsg = NULL;
-   char resourceName[RESMGR_MAX_NAME_LENGTH + 1] = "";
-   char tempMsg[GTSL_ERROR_BUFFER_SIZE] = "";
-   short tempOcc = FALSE;
-   long tempCode = 0;
-   int written = 0;
-   GTSL_ERROR_ENTRY *pErr = errorTable; /* pointer into error entry table */
-
-
-   /* find the error message for a given error code */
-   while (pErr->string != NULL)
-   {
-      if (pErr->value == code)
-      {
-         pMsg = pErr->string;
-         break;
-      }
-      pErr++;
-   }
-   if (pMsg == NULL)
-   {
-      /* should never happen */
-      pMsg = "(no message available for this code)";
-   }
-
-   /* setup the error message */
-
-   /* 1) Library name */
-   strcpy(buffer, GTSL_ERRMSG_PREFIX_LIBRARY);
-   strcat(buffer, LIBRARY_NAME);
-   strcat(buffer, "\n");
-
-   /* 2) Bench name, only if a valid ID is given */
-   if (resId != RESMGR_INVALID_ID)
-   {
-      /* read the resource name into a local buffer */
-      RESMGR_Get_Resource_Name(0, resId, resourceName, sizeof(resourceName),
-         &written, &tempOcc, &tempCode, tempMsg);
-      if ((!tempOcc) && (written > 0))
-      {
-         /* append the name */
-         strcat(buffer, GTSL_ERRMSG_PREFIX_BENCH);
-         strcat(buffer, resourceName);
-         strcat(buffer, "\n");
-      }
-   }
-
-   /* 3) Bench device, if given */
-   if (benchDevice != NULL)
-   {
-      strcat(buffer, GTSL_ERRMSG_PREFIX_BENCH_DEVICE);
-      strcat(buffer, benchDevice);
-      strcat(buffer, "\n");
-   }
-
-   /* 4) Error message */
-   strcat(buffer, GTSL_ERRMSG_PREFIX_ERRMSG);
-   strcat(buffer, pMsg);
-}
-
-
-void CVICALLBACK QuitThread(void *callbackData)
-{
-   QuitUserInterface(0);
-}
-
-void FormatValues (char cValue[1024], char *cFormat, double dValue)
-{
-	if(!strcmp(cFormat, "%i"))
-	{
-		//MessagePopup("bla", "Integer");
-		sprintf(cValue, cFormat, (int) dValue);
-		return;
-	} else if(!strcmp(cFormat, "%u"))
-	{
-		//MessagePopup("bla", "unsigend Integer");
-		sprintf(cValue, cFormat, (unsigned int) dValue);
-		return;
-	} else if(!strcmp(cFormat, "%#x"))
-	{
-		//MessagePopup("bla", "klein hex"); 
-		sprintf(cValue, cFormat, (int) dValue);
-		return;
-	}
-	 else if(!strcmp(cFormat, "%#X"))
-	{
-		//MessagePopup("bla", "gro hex"); 
-		sprintf(cValue, cFormat, (int) dValue);
-		return;
-	}  else if(!strcmp(cFormat, "%#o"))
-	{
-		//MessagePopup("bla", "octal"); 
-		sprintf(cValue, cFormat, (int) dValue);
-		return;
-	} else
-	{
-		sprintf(cValue, cFormat, dValue);
-		return;
-	}
-	
-}
+
+/*******************************************************************************/
+/**
+@file tsadjus.c
+ *
+@brief all functions to control teststand control panel @ compactTSVP
+ *
+@version 1.0.0.0
+ *
+@author Robert Renner <A HREF=k"mailto:robert.renner@spectral.de">robert.renner@spectral.de</A>\n
+&copy; Spectral Electronic Forschungs- und Produktions GmbH - Berlin \n \n
+language: ANSI-C ISO/IEC9899:1990
+ *
+<b>History:</b>
+- <b>23.11.2007 R. Renner</b>
+- Initial revision
+
+ ******************************************************************************
+ *****************************************************************************/
+
+/* INCLUDE FILES **************************************************************/
+
+/* EXPORT */
+#include "tsadj.h"
+#include "telemetry.h"
+#include "recorder.h"
+#include "metrics.h"
+#include "panelclient.h"
+#include "filter.h"
+#include "transform.h"
+#include "trend.h"
+#include "panelview.h"
+#include "stepresult.h"
+#include "simulation.h"
+#include "barrier.h"
+#include "tsadjc.h"
+
+/* GLOBAL CONSTANT DEFINITIONS ************************************************/
+
+
+#ifndef COINIT_MULTITHREADED
+   #define COINIT_MULTITHREADED  0x0      // OLE calls objects on any thread.
+#endif
+
+
+
+/* GLOBAL VARIABLES DEFINITION ************************************************/
+CRITICAL_SECTION CriticalSection;  /* serializes the panel thread starts */
+int giMenuBarHandle = 0;
+HINSTANCE ghInstance = NULL;
+volatile LONG glInitState = 0;     /* TSADJ_INIT_xxx, once flag        */
+int giInitialized = FALSE;         /* result of the initialization     */
+int giCVIRTEInitialized = FALSE;
+
+
+
+/* LOCAL DEFINES *************************************************/
+#define TSADJ_KEY_TELEMETRY   "Telemetry"  /* bench key, 1 -> publish values */
+#define TSADJ_KEY_RECORDER    "Recorder"   /* bench key, 1 -> record values  */
+#define TSADJ_KEY_STATISTICS  "Statistics" /* bench key, 1 -> trace at Cleanup */
+#define TSADJ_KEY_PANELSERVER "PanelServer" /* bench key, 1 -> panel server */
+#define TSADJ_KEY_FILTER      "Filter"     /* bench key, EMA, Mean or Median */
+#define TSADJ_KEY_FILTERWINDOW "FilterWindow" /* bench key, 4 .. 64         */
+#define TSADJ_KEY_AUTOZOOM    "AutoZoom"   /* bench key, 1 -> zoom the slider */
+#define TSADJ_KEY_ABORTLATENCY "AbortLatency" /* bench key, ms, see below   */
+#define TSADJ_KEY_PRIORITY    "PanelPriority" /* bench key, see below     */
+#define TSADJ_KEY_CPU         "PanelCpu"   /* bench key, processor number  */
+#define TSADJ_KEY_SIMPLANT    "SimPlant"   /* bench key, simulated DUT      */
+#define TSADJ_KEY_SIMOPERATOR "SimOperator" /* bench key, simulated operator */
+#define TSADJ_ABORT_LATENCY   50           /* ms without AbortLatency       */
+#define TSADJ_STOP_TIMEOUT    10000        /* ms for a panel thread to end  */
+#define TSADJ_FILTER_WINDOW   8            /* window without FilterWindow   */
+#define TSADJ_BUTTON_HIT      "Locals.AdjustmentPanelButtonHit"
+#define TSADJ_UUT_SERIAL      "RunState.Root.Locals.UUT.SerialNumber"
+#define TSADJ_NO_SERIAL       "NoSerial"   /* recorded without a UUT        */
+#define TSADJ_SERIAL_LENGTH   256          /* UUT serial number, recorder   */
+#define TSADJ_POOL_SIZE       64           /* pooled benches per process     */
+#define TSADJ_RESULT_LENGTH   256          /* lookup string of the result   */
+#define TSADJ_FRAME_INTERVAL  0.04         /* s, faster values are not seen */
+#define TSADJ_FEEDBACK_WEIGHT 0.125        /* of a new sample in the means  */
+
+/* States of glInitState */
+#define TSADJ_INIT_NONE       0
+#define TSADJ_INIT_RUNNING    1
+#define TSADJ_INIT_DONE       2
+
+/* Results of WaitForExecution */
+#define TSADJ_WAIT_DONE       0            /* object signaled               */
+#define TSADJ_WAIT_TIMEOUT    1
+#define TSADJ_WAIT_ABORTED    2            /* execution terminates or aborts */
+
+
+/* LOCAL FUNCTION DEFINITIONS *************************************************/
+
+/* LOCAL CONSTANT DEFINITIONS *************************************************/
+static const char LIBRARY_NAME[] = "TSADJ"; /* Library Version String */
+static const char LIB_VERSION[] = "TSADJ 1.1.0.4"; /* Library Version String */
+static char *cDLLPATH;
+
+/* Values of the "Filter" key, in the order FILTER_EMA .. FILTER_MEDIAN */
+static const char *gFilterNames[] =
+{
+   "EMA", "Mean", "Median"
+};
+
+/* Values of the "AbortLatency" key in ms */
+static const int gAbortLatencies[] =
+{
+   10, 20, 50, 100, 200
+};
+
+/* Values of the "PanelPriority" key and the thread priorities */
+static const char *gPriorityNames[] =
+{
+   "BelowNormal", "Normal", "AboveNormal", "Highest"
+};
+static const int gPriorities[] =
+{
+   THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL,
+   THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST
+};
+
+/* Error code to message reference table */
+static GTSL_ERROR_TABLE errorTable =
+{
+   /* library specific error codes and messages */
+   {
+      TSPAN_ERR_NOT_A_BENCH, "The given resource is not a bench"
+   }
+   ,
+   {
+      TSPAN_ERR_THREADWASNOTSTARTET,
+         "Thread was not started. Possible cause: adjustment panel could not be created."
+   }
+   ,                                                                           
+   {
+      TSPAN_ERR_WRONGFORMATYTE,
+         "Format type is not supported."
+   }     
+  ,
+   {
+      TSPAN_ERR_FILTER,
+         "Filter type or window is not supported."
+   }
+   ,
+   {
+      TSPAN_ERR_TRANSFORM,
+         "Transform description is not valid."
+   }
+   ,
+   {
+      TSPAN_ERR_INITIALIZE,
+         "Library could not be initialized. Possible cause: CVI run-time engine not available."
+   }
+   ,
+   {
+      TSPAN_ERR_PANELSERVER,
+         "Adjustment panel server not reachable. Possible cause: tsadjpanelsrv is not running or does not respond."
+   }
+   ,
+   {
+      TSPAN_ERR_ABORTED,
+         "Execution was terminated or aborted while waiting for the adjustment panel."
+   }
+   ,
+   {
+      TSPAN_ERR_GROUP,
+         "Adjustment group not available. Possible cause: no group set for the bench, too many group names or members not 1 .. 32."
+   }
+   ,
+   {
+      TSPAN_ERR_PANELTHREAD,
+         "Panel thread does not end. The bench is kept, call Cleanup again later."
+   }
+   ,
+   {
+      TSPAN_ERR_GROUPROUND,
+         "Panel cannot join its adjustment group. Possible cause: Display before all members have confirmed the last round, wait for the group first."
+   }
+   ,
+   {
+      TSPAN_ERR_PANELTIMEOUT,
+         "Adjustment panel was not shown within the timeout. Possible cause: system busy, wait longer or pass -1 to wait until it is shown."
+   }
+   ,
+   /* include common GTSL error codes and messages */
+   GTSL_ERROR_CODES_AND_MESSAGES,                         
+                                                           
+   /* this must be the last entry ! */
+   {
+      0, NULL
+   }
+};
+
+/* Entries of errorTable sorted by code, built once by BuildErrorIndex */
+static GTSL_ERROR_ENTRY *gpErrorIndex[sizeof(errorTable) / sizeof(errorTable[0])];
+static int giErrorIndexCount = 0;
+                                                             
+
+/* LOCAL TYPE DEFINITIONS *****************************************************/
+
+typedef struct
+{
+   int iOwner; /* memory block owner                          */
+   int iSimulation; /* driver simulation                           */
+   int iDemoMode; /* driver simulation                           */
+   int iActualPanelHandle;
+   DWORD gThreadID;
+   int iTelemetrySlot; /* slot in the telemetry region, -1 if disabled   */
+   RECORDER *pRecorder; /* value recorder, NULL if disabled               */
+   int iStatistics;    /* trace the adjustment statistics at Cleanup     */
+   char cStepName[METRICS_STEPNAME_LENGTH]; /* step of the current panel */
+   double dDisplayStart; /* time stamp of the Display call               */
+   double dDisplayEnd;   /* time stamp the operator got the panel        */
+   int iInLimitSeen;     /* a value within the limits has been shown     */
+   METRICS_COUNTERS counters; /* self instrumentation of the hot paths   */
+   char cResourceName[RESMGR_MAX_NAME_LENGTH + 1]; /* for error messages */
+   int iPooled;        /* Cleanup returns the bench to the pool          */
+   PANEL_CLIENT *pPanelClient; /* panel server connection, NULL -> local */
+   double dButtonHit;    /* panel server: time stamp of the button, 0.0  */
+   PANEL_VIEW view;      /* limits and shown state of the current panel  */
+   FILTER filter;        /* smoothing of the values, reset at Display    */
+   int iSetupFilter;     /* filter type and window of the INI file, for  */
+   int iSetupWindow;     /* the next UUT of a pooled bench               */
+   TRANSFORM transform;  /* reading -> shown quantity, before the filter */
+   ThreadData threadData; /* panel and button of this bench              */
+   HANDLE hThreadHandle; /* panel thread, NULL -> not running            */
+   CAObjHandle hExecution; /* execution of the last Display, for the waits,
+                              0 -> plain C caller, see SetExecution */
+   HANDLE hAbort;        /* set by tsadj_AbortAdjustmentPanel            */
+   DWORD dwAbortLatency; /* ms between two termination checks            */
+   STEP_RESULT result;   /* statistics of the current panel              */
+   int iThreadPriority;  /* THREAD_PRIORITY_xxx of the panel thread      */
+   DWORD dwAffinity;     /* processor mask of the panel thread, 0 -> any */
+   char cResultProperty[TSADJ_RESULT_LENGTH]; /* written at Hide, "" -> no */
+   int iVisiblePending;  /* async Display, VISIBLE phase not recorded    */
+   SIMULATION sim;       /* DUT and operator of the simulation mode      */
+   BARRIER *pGroup;      /* joined by every Display, NULL -> no group    */
+   long lGroupMembers;   /* members of a round, 1 .. BARRIER_MAX_MEMBERS */
+   double dHideStart;    /* time stamp of the last Hide call, result     */
+   
+} BENCH_STRUCT;
+
+/* Backpressure of one SetValue call, see tsadj_SetValueAdjustmentPanelEx */
+typedef struct
+{
+   short sRendered;      /* TSADJ_SAMPLE_xxx                             */
+   double dRefreshRate;  /* shown values per s, 0.0 -> none yet          */
+   double dMinInterval;  /* s, shorter intervals are not shown           */
+} SAMPLE_FEEDBACK;
+
+/* References of a TestStand Display, taken by the tsadj_xxx wrapper and
+   handed to the bench by ShowAdjustmentPanel, see AttachExecution */
+typedef struct
+{
+   CAObjHandle hExecution;  /* for the termination checks                */
+   CAObjHandle hContext;    /* for Locals.AdjustmentPanelButtonHit       */
+   char cSerial[TSADJ_SERIAL_LENGTH]; /* UUT serial number, recorder    */
+} EXECUTION_REFS;
+
+/* Bench kept alive between tsadj_Cleanup and the next tsadj_SetupPooled */
+typedef struct
+{
+   char cBenchName[RESMGR_MAX_NAME_LENGTH + 1];
+   char cIniFile[MAX_PATH];
+   FILETIME ftIniWriteTime;  /* INI time stamp at the time of the setup  */
+   long lResourceId;
+   long lTrace;
+   int iInUse;               /* between SetupPooled and Cleanup          */
+} POOL_ENTRY;
+
+/* Benches set up by tsadj_SetupPooled, protected by PoolCriticalSection */
+CRITICAL_SECTION PoolCriticalSection;
+POOL_ENTRY gPool[TSADJ_POOL_SIZE];
+int giPoolCount = 0;
+
+/* LOCAL MACRO DEFINITIONS ****************************************************/
+
+
+/* LOCAL FUNCTION DECLARATIONS ************************************************/
+WINOLEAPI CoInitializeEx(LPVOID pvReserved, DWORD dwCoInit);
+int StartThreadForAdjustmentPanel(void *data); 
+static DWORD WINAPI PanelThread(LPVOID data);
+static int ExecutePanelCommand(ThreadData *threadData, const PANEL_COMMAND
+   *pCommand);
+static void formatError(char buffer[], int code, long resId,
+   const char *resourceName, char *benchDevice);
+static void BuildErrorIndex(void);
+static int EnsureInitialized(short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[]);
+static int InitializeLibrary(void);
+static int CompareErrorEntries(const void *pLeft, const void *pRight);
+static char *AppendText(char *pDest, const char *pEnd, const char *pText);
+static int GetIniWriteTime(const char *pIniFile, FILETIME *pWriteTime);
+static int ReturnToPool(long lResourceId);
+static void ResetConfiguration(BENCH_STRUCT *pBench);
+static int StopPanelThread(BENCH_STRUCT *pBench, int iAbortable);
+static int QueueCommand(BENCH_STRUCT *pBench, const PANEL_COMMAND *pCommand);
+static int WaitForExecution(BENCH_STRUCT *pBench, HANDLE hObject,
+   DWORD dwTimeout);
+static int ExecutionStopping(BENCH_STRUCT *pBench);
+static void DisplayRemotePanel(long lResourceId, BENCH_STRUCT *pBench,
+   char nameOfStep[], char buttonText[], char unit[], char format[],
+   double lowerLimit, double upperLimit, const char *pSerial,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[]);
+static void ButtonHitRemote(BENCH_STRUCT *pBench, int iButtonHit);
+static void SetupBench(CAObjHandle sequenceContext, char *pBenchName,
+   long *pResourceId, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[]);
+static void CleanupBench(CAObjHandle sequenceContext, long pResourceId,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[]);
+static void ShowAdjustmentPanel(CAObjHandle sequenceContext,
+   long pResourceId, char nameOfStep[], char buttonText[], char unit[],
+   char format[], double lowerLimit, double upperLimit, int iAsync,
+   EXECUTION_REFS *pRefs, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[]);
+static void WaitForPanel(CAObjHandle sequenceContext, long pResourceId,
+   long timeout, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[]);
+static void SetValueEx(CAObjHandle sequenceContext, long pResourceId,
+   double value, short *rendered, double *refreshRate, double *minInterval,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[]);
+static void SetValues(CAObjHandle sequenceContext, long pResourceId,
+   const double values[], long lCount, SAMPLE_FEEDBACK *pFeedback,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[]);
+static void HideAdjustmentPanel(CAObjHandle sequenceContext,
+   long pResourceId, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[]);
+static void SetFilter(CAObjHandle sequenceContext, long pResourceId,
+   long filterType, long window, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[]);
+static void SetTransform(CAObjHandle sequenceContext, long pResourceId,
+   char transform[], short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[]);
+static void SetHysteresis(CAObjHandle sequenceContext, long pResourceId,
+   double hysteresis, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[]);
+static void AbortPanel(CAObjHandle sequenceContext, long pResourceId,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[]);
+static void SetGroup(CAObjHandle sequenceContext, long pResourceId,
+   char groupName[], long members, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[]);
+static void WaitForGroup(CAObjHandle sequenceContext, long pResourceId,
+   long timeout, short *allConfirmed, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[]);
+static void SetExecution(BENCH_STRUCT *pBench, EXECUTION_REFS *pRefs);
+static BENCH_STRUCT *GetBench(CAObjHandle sequenceContext, long lResourceId,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[]);
+static void DisplayFromTestStand(CAObjHandle sequenceContext,
+   long pResourceId, char nameOfStep[], char buttonText[], char unit[],
+   char format[], double lowerLimit, double upperLimit, int iAsync,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[]);
+static void AttachExecution(CAObjHandle sequenceContext,
+   const BENCH_STRUCT *pBench, EXECUTION_REFS *pRefs, short *pErrorOccurred,
+   long *pErrorCode, char errorMessage[]);
+static void ReleaseExecution(EXECUTION_REFS *pRefs);
+static void RecordResult(void *pContext, const PANELVIEW_READING *pReading,
+   double dTime);
+static void AddToMean(volatile double *pMean, double dSample);
+static void ResetFeedback(ThreadData *threadData);
+static int JoinGroup(BENCH_STRUCT *pBench);
+static void LeaveGroup(BENCH_STRUCT *pBench);
+static void ApplyPendingCommands(ThreadData *threadData);
+static void GetUUTSerialNumber(CAObjHandle sequenceContext, char cSerial[],
+   int iSize);
+static HRESULT SetNumberProperty(CAObjHandle sequenceContext,
+   const char *pProperty, const char *pName, double dValue);
+static HRESULT SetLatencyProperties(CAObjHandle sequenceContext,
+   const char *pProperty, const char *pName, const METRICS_LATENCY *pLatency);
+static HRESULT PublishResult(CAObjHandle sequenceContext,
+   const BENCH_STRUCT *pBench, const char *pProperty, double dTime);
+
+/* EXPORTED FUNCTION DEFINITIONS **********************************************/
+
+int __stdcall DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReserved)
+{
+   switch (fdwReason)
+   {
+      case DLL_PROCESS_ATTACH:
+
+         /* everything else is done by EnsureInitialized on first use */
+         ghInstance = hinstDLL;
+         break;
+
+      case DLL_PROCESS_DETACH:
+
+         /* lpvReserved != NULL: the process ends, its other threads are
+            already gone, maybe inside a lock; the system frees the rest */
+         if ((lpvReserved != NULL) || (glInitState != TSADJ_INIT_DONE))
+         {
+            break;
+         }
+         /* FreeLibrary: the panel threads and the recorder writer hold a
+            reference to the DLL until they end, so none of them runs any
+            more; joining them here would deadlock on the loader lock */
+         Telemetry_Close();
+         Recorder_Close();
+         Barrier_Close();
+         Metrics_Close();
+         DeleteCriticalSection(&PoolCriticalSection);
+         DeleteCriticalSection(&CriticalSection);
+
+         if (giCVIRTEInitialized && !CVIRTEHasBeenDetached())
+         /* Do not call CVI functions if cvirte.dll has already been detached.    */
+         {
+            CloseCVIRTE(); /* Needed if linking in external compiler; harmless
+               */
+            //otherwise
+         }
+         break;
+   }
+
+   return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int __stdcall DllEntryPoint(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID
+   lpvReserved)
+{
+   /* Included for compatibility with Borland    */
+
+   return DllMain(hinstDLL, fdwReason, lpvReserved);
+}
+
+
+
+/* FUNCTION *******************************************************************/
+/**
+SetupBench:  allocates the bench and reads its INI keys
+ *
+The work of the library is done by static functions that pass the sequence
+context to the resource manager. The tsadj_xxx functions for TestStand pass
+their sequence context, the tsadjc_xxx functions of tsadjc.h pass 0, see
+the end of the file.
+ *******************************************************************************/
+static void SetupBench(CAObjHandle sequenceContext, char *pBenchName,
+   long *pResourceId, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   char cSectionName[1024];
+   char cTraceBuffer[1024];
+   char cTempBuffer[1024];
+   char cTempBuffer2[1024];
+   char cSystemID[1024];
+   char cTempMsg[GTSL_ERROR_BUFFER_SIZE];
+   SYSTEM_INFO systemInfo;
+   
+   short sLicenseOK;
+   short sTempOcc;
+   
+   int idx;
+   int iWritten;
+   int iSimPlant = 0;
+   int iSimOperator = 0;
+
+   long lBytesWritten;
+   long lTempCode;
+   long lMatched;
+   long lResourceType;
+   long lTrace;
+
+   BENCH_STRUCT *pBench = NULL;
+   int iAllocated = FALSE;
+   
+   ERRORINFO pTSErrorInfo;
+   
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Allocate the resource:
+   /     Check whether "pBenchName" can be found in the INI files and
+   /     return a resource ID for the bench. This resource ID is the
+   /     "ticket" for any subsequent action dealing with this bench.
+   /---------------------------------------------------------------------*/
+   RESMGR_Alloc_Resource(sequenceContext, pBenchName, pResourceId,
+      pErrorOccurred, pErrorCode, errorMessage);
+   iAllocated = ! *pErrorOccurred;
+
+   /*---------------------------------------------------------------------/
+   /  Check for trace flag:
+   /    The "Trace" key in the bench section is searched and its
+   /    value is checked. The result is recorded in the static
+   /    variable trace
+   /---------------------------------------------------------------------*/
+   if (!*pErrorOccurred)
+   {
+      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "", RESMGR_KEY_TRACE,
+         "1", &lTrace, pErrorOccurred, pErrorCode, errorMessage);
+   }
+   if (!*pErrorOccurred)
+   {
+      RESMGR_Set_Trace_Flag(*pResourceId, lTrace);
+
+      if (lTrace)
+      {
+         RESMGR_Trace(">>TSADJ_Setup begin");
+         RESMGR_Trace("Tracing for tsadj.dll enabled");
+         sprintf(cTraceBuffer, "Bench name %s -> Resource ID %ld", pBenchName,
+            *pResourceId);
+         RESMGR_Trace(cTraceBuffer);
+      }
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check the resource type:
+   /     The tspan library requires that pBenchName refers to a bench,
+   /     not to a single device. It is always recommended to use a bench
+   /     instead of a device, because a bench makes it easy to add
+   /     a device in future and to work with alternative devices
+   /     like a ....
+   /---------------------------------------------------------------------*/
+   if (! *pErrorOccurred)
+   {
+      RESMGR_Get_Resource_Type(sequenceContext,  *pResourceId, &lResourceType,
+         pErrorOccurred, pErrorCode, errorMessage);
+      if (!*pErrorOccurred)
+      {
+         if (lResourceType != RESMGR_TYPE_BENCH)
+         {
+            *pErrorOccurred = TRUE;
+            *pErrorCode = TSPAN_ERR_NOT_A_BENCH;
+            formatError(errorMessage,  *pErrorCode,  *pResourceId, NULL, NULL);
+         }
+      }
+   }
+   
+   /*---------------------------------------------------------------------/
+   /   Check the license:
+   /      If correct license file not found, the tspan library runs in 
+   /      demo mode
+   /---------------------------------------------------------------------*/
+   /*if (!*pErrorOccurred)
+   {
+       RESMGR_Read_ROM (0, cSystemID, pErrorOccurred, pErrorCode, errorMessage);
+       sLicenseOK = lc_CheckLicense ("SW-ITS", cSystemID);
+   } */
+   
+   /*---------------------------------------------------------------------/
+   /   Allocate a memory block:
+   /     The tspan library uses a structure to store some private
+   /     information along with the resource ID. This information can
+   /     be retrieved in subsequent calls to the measurement functions.
+   /---------------------------------------------------------------------*/
+   if (!*pErrorOccurred)
+   {
+      RESMGR_Alloc_Memory(sequenceContext,  *pResourceId, sizeof(BENCH_STRUCT),
+         (void **)(&pBench), pErrorOccurred, pErrorCode, errorMessage);
+      if (! *pErrorOccurred)
+      {
+         /* set the memory block owner field to a unique value
+         which identifies the ENOCEAN library as the owner of the memory.
+          */
+         pBench->iOwner = TSPAN_ERR_BASE;
+
+         /* set default values */
+         /*if (sLicenseOK) 
+         {
+            sprintf(cTraceBuffer, "Valid license found! (System ID: %s)", cSystemID);
+            pBench->iDemoMode = FALSE; 
+         }
+         if (!sLicenseOK) 
+         {
+             sprintf(cTraceBuffer, "Demo mode is enabled, not valid license found! (System ID: %s)", cSystemID);
+             pBench->iDemoMode = FALSE;
+         }		*/
+		 pBench->iDemoMode = FALSE;
+         RESMGR_Trace(cTraceBuffer);
+         pBench->iSimulation = FALSE;
+         pBench->iActualPanelHandle = 0;
+         pBench->iPooled = FALSE;
+         pBench->pPanelClient = NULL;
+         pBench->dButtonHit = 0.0;
+         memset(&pBench->view, 0, sizeof(PANEL_VIEW));
+         pBench->view.iShownPassed = -1;
+         Filter_Configure(&pBench->filter, FILTER_NONE, 1);
+         Transform_Compile(&pBench->transform, "");
+         memset(&pBench->threadData, 0, sizeof(ThreadData));
+         pBench->threadData.lResourceId = *pResourceId;
+         pBench->threadData.pQueueDelay = &pBench->counters.queueDelay;
+         pBench->iThreadPriority = THREAD_PRIORITY_NORMAL;
+         pBench->dwAffinity = 0;
+         pBench->hThreadHandle = NULL;
+         pBench->iTelemetrySlot = -1;
+         pBench->pRecorder = NULL;
+         pBench->iStatistics = FALSE;
+         pBench->hExecution = 0;
+         pBench->hAbort = NULL;
+         pBench->dwAbortLatency = TSADJ_ABORT_LATENCY;
+         StepResult_Begin(&pBench->result);
+         /* the resource ID as seed, every socket gets its own noise */
+         Simulation_Configure(&pBench->sim, 0, 0, (unsigned long) *pResourceId);
+         pBench->cResultProperty[0] = '\0';
+         pBench->pGroup = NULL;
+         pBench->lGroupMembers = 0;
+         pBench->cStepName[0] = '\0';
+         memset(&pBench->counters, 0, sizeof(METRICS_COUNTERS));
+
+         /* keep the name, so error messages need no resource manager call */
+         pBench->cResourceName[0] = '\0';
+         RESMGR_Get_Resource_Name(sequenceContext, *pResourceId,
+            pBench->cResourceName, sizeof(pBench->cResourceName), &iWritten,
+            &sTempOcc, &lTempCode, cTempMsg);
+         if (sTempOcc || (iWritten <= 0))
+         {
+            pBench->cResourceName[0] = '\0';
+         }
+      }
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check for simulation flag:
+   /     The "Simulation" key in the bench section is searched and its
+   /     value is checked. The result is recorded in the memory block.
+   /     Any other library-specific information like calibration,
+   /     path for calibration files etc. may be handled the same way
+   /     (not shown in the example).
+   /---------------------------------------------------------------------*/
+   if (!*pErrorOccurred)
+   {
+      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+         RESMGR_KEY_SIMULATION, "1", &lMatched, pErrorOccurred, pErrorCode,
+         errorMessage);
+      if (! *pErrorOccurred)
+      {
+         if (lMatched)
+         {
+            pBench->iSimulation = TRUE;
+            if (lTrace)
+            {
+               RESMGR_Trace("Simulation is enabled!");
+            }
+         }
+      }
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check for the simulated DUT and operator:
+   /     In simulation mode the "SimPlant" and "SimOperator" keys select
+   /     the presets of simulation.c, the first one of each is default.
+   /---------------------------------------------------------------------*/
+   if ((!*pErrorOccurred) && pBench->iSimulation)
+   {
+      for (idx = 0; (idx < SIMULATION_PLANTS) && (!*pErrorOccurred); idx++)
+      {
+         RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+            TSADJ_KEY_SIMPLANT, (char *)Simulation_PlantName(idx), &lMatched,
+            pErrorOccurred, pErrorCode, errorMessage);
+         if ((! *pErrorOccurred) && lMatched)
+         {
+            iSimPlant = idx;
+            break;
+         }
+      }
+      for (idx = 0; (idx < SIMULATION_OPERATORS) && (!*pErrorOccurred);
+         idx++)
+      {
+         RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+            TSADJ_KEY_SIMOPERATOR, (char *)Simulation_OperatorName(idx),
+            &lMatched, pErrorOccurred, pErrorCode, errorMessage);
+         if ((! *pErrorOccurred) && lMatched)
+         {
+            iSimOperator = idx;
+            break;
+         }
+      }
+      Simulation_Configure(&pBench->sim, iSimPlant, iSimOperator,
+         (unsigned long) *pResourceId);
+      if ((! *pErrorOccurred) && lTrace)
+      {
+         sprintf(cTraceBuffer, "Simulated DUT %s, operator %s!",
+            Simulation_PlantName(iSimPlant),
+            Simulation_OperatorName(iSimOperator));
+         RESMGR_Trace(cTraceBuffer);
+      }
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check for telemetry flag:
+   /     If the "Telemetry" key is set, the resource claims a slot in the
+   /     shared memory region read by external monitors. A full region
+   /     is not an error, the resource is just not published.
+   /---------------------------------------------------------------------*/
+   if (!*pErrorOccurred)
+   {
+      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+         TSADJ_KEY_TELEMETRY, "1", &lMatched, pErrorOccurred, pErrorCode,
+         errorMessage);
+      if ((! *pErrorOccurred) && lMatched)
+      {
+         pBench->iTelemetrySlot = Telemetry_ClaimSlot(*pResourceId);
+         if (lTrace)
+         {
+            sprintf(cTraceBuffer, "Telemetry slot %d", pBench->iTelemetrySlot);
+            RESMGR_Trace(cTraceBuffer);
+         }
+      }
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check for recorder flag:
+   /     If the "Recorder" key is set, the record buffers are allocated
+   /     here, so SetValue never allocates. A missing recorder is not an
+   /     error, the values are just not recorded.
+   /---------------------------------------------------------------------*/
+   if (!*pErrorOccurred)
+   {
+      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+         TSADJ_KEY_RECORDER, "1", &lMatched, pErrorOccurred, pErrorCode,
+         errorMessage);
+      if ((! *pErrorOccurred) && lMatched)
+      {
+         pBench->pRecorder = Recorder_Create();
+         if (lTrace)
+         {
+            RESMGR_Trace((pBench->pRecorder != NULL) ? "Recorder is enabled!"
+               : "Recorder could not be created!");
+         }
+      }
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check for statistics flag:
+   /     The phase durations are always collected. If the "Statistics"
+   /     key is set, they are written to the trace at Cleanup.
+   /---------------------------------------------------------------------*/
+   if (!*pErrorOccurred)
+   {
+      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+         TSADJ_KEY_STATISTICS, "1", &lMatched, pErrorOccurred, pErrorCode,
+         errorMessage);
+      if (! *pErrorOccurred)
+      {
+         pBench->iStatistics = lMatched;
+      }
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check for auto zoom:
+   /     If the "AutoZoom" key is set, the slider widens while the value
+   /     is far from the limits and narrows again as it approaches.
+   /---------------------------------------------------------------------*/
+   if (!*pErrorOccurred)
+   {
+      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+         TSADJ_KEY_AUTOZOOM, "1", &lMatched, pErrorOccurred, pErrorCode,
+         errorMessage);
+      if (! *pErrorOccurred)
+      {
+         pBench->view.iAutoZoom = lMatched;
+      }
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check for abort latency:
+   /     The "AbortLatency" key sets how often the waits of Display and
+   /     Hide check whether the execution terminates or aborts.
+   /---------------------------------------------------------------------*/
+   for (idx = 0; (idx < (int)(sizeof(gAbortLatencies)
+      / sizeof(gAbortLatencies[0]))) && (!*pErrorOccurred); idx++)
+   {
+      sprintf(cTempBuffer, "%d", gAbortLatencies[idx]);
+      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+         TSADJ_KEY_ABORTLATENCY, cTempBuffer, &lMatched, pErrorOccurred,
+         pErrorCode, errorMessage);
+      if ((! *pErrorOccurred) && lMatched)
+      {
+         pBench->dwAbortLatency = gAbortLatencies[idx];
+         break;
+      }
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check for panel thread scheduling:
+   /     The "PanelPriority" key raises or lowers the priority of the
+   /     panel thread, the "PanelCpu" key binds it to one processor.
+   /     The priority class of the process is left to TestStand.
+   /---------------------------------------------------------------------*/
+   for (idx = 0; (idx < (int)(sizeof(gPriorities) / sizeof(gPriorities[0])))
+      && (!*pErrorOccurred); idx++)
+   {
+      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+         TSADJ_KEY_PRIORITY, (char *)gPriorityNames[idx], &lMatched,
+         pErrorOccurred, pErrorCode, errorMessage);
+      if ((! *pErrorOccurred) && lMatched)
+      {
+         pBench->iThreadPriority = gPriorities[idx];
+         break;
+      }
+   }
+   if (!*pErrorOccurred)
+   {
+      GetSystemInfo(&systemInfo);
+      for (idx = 0; (idx < (int)systemInfo.dwNumberOfProcessors) && (idx < 32)
+         && (!*pErrorOccurred); idx++)
+      {
+         sprintf(cTempBuffer, "%d", idx);
+         RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+            TSADJ_KEY_CPU, cTempBuffer, &lMatched, pErrorOccurred,
+            pErrorCode, errorMessage);
+         if ((! *pErrorOccurred) && lMatched)
+         {
+            pBench->dwAffinity = (DWORD)1 << idx;
+            break;
+         }
+      }
+   }
+   if ((! *pErrorOccurred) && lTrace && ((pBench->iThreadPriority
+      != THREAD_PRIORITY_NORMAL) || pBench->dwAffinity))
+   {
+      sprintf(cTraceBuffer, "Panel thread priority %d, processor mask 0x%lx",
+         pBench->iThreadPriority, (unsigned long)pBench->dwAffinity);
+      RESMGR_Trace(cTraceBuffer);
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check for filter:
+   /     The "Filter" key selects the smoothing of the values, the
+   /     "FilterWindow" key its window. tsadj_SetFilter overrides both.
+   /---------------------------------------------------------------------*/
+   if (!*pErrorOccurred)
+   {
+      for (idx = 0; (idx < 3) && (!*pErrorOccurred); idx++)
+      {
+         RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+            TSADJ_KEY_FILTER, (char *)gFilterNames[idx], &lMatched,
+            pErrorOccurred, pErrorCode, errorMessage);
+         if ((! *pErrorOccurred) && lMatched)
+         {
+            Filter_Configure(&pBench->filter, FILTER_EMA + idx,
+               TSADJ_FILTER_WINDOW);
+            break;
+         }
+      }
+   }
+   if ((!*pErrorOccurred) && (pBench->filter.iType != FILTER_NONE))
+   {
+      for (idx = 4; (idx <= FILTER_MAX_WINDOW) && (!*pErrorOccurred); idx *= 2)
+      {
+         sprintf(cTempBuffer, "%d", idx);
+         RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+            TSADJ_KEY_FILTERWINDOW, cTempBuffer, &lMatched, pErrorOccurred,
+            pErrorCode, errorMessage);
+         if ((! *pErrorOccurred) && lMatched)
+         {
+            Filter_Configure(&pBench->filter, pBench->filter.iType, idx);
+            break;
+         }
+      }
+      if ((! *pErrorOccurred) && lTrace)
+      {
+         sprintf(cTraceBuffer, "Filter %s, window %d is enabled!",
+            gFilterNames[pBench->filter.iType - FILTER_EMA],
+            pBench->filter.iWindow);
+         RESMGR_Trace(cTraceBuffer);
+      }
+   }
+   if (!*pErrorOccurred)
+   {
+      pBench->iSetupFilter = pBench->filter.iType;
+      pBench->iSetupWindow = pBench->filter.iWindow;
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Check for panel server flag:
+   /     If the "PanelServer" key is set, the panel is shown by the
+   /     tsadjpanelsrv process instead of a thread of this process.
+   /     The server must be running at Setup.
+   /---------------------------------------------------------------------*/
+   if (!*pErrorOccurred)
+   {
+      RESMGR_Compare_Value(sequenceContext,  *pResourceId, "",
+         TSADJ_KEY_PANELSERVER, "1", &lMatched, pErrorOccurred, pErrorCode,
+         errorMessage);
+      if ((! *pErrorOccurred) && lMatched)
+      {
+         pBench->pPanelClient = PanelClient_Connect();
+         if (pBench->pPanelClient == NULL)
+         {
+            *pErrorOccurred = TRUE;
+            *pErrorCode = TSPAN_ERR_PANELSERVER;
+            formatError(errorMessage,  *pErrorCode, *pResourceId,
+               pBench->cResourceName, NULL);
+         }
+         else if (lTrace)
+         {
+            RESMGR_Trace("Panel server is enabled!");
+         }
+      }
+   }
+   
+   
+   /*---------------------------------------------------------------------/
+   /   Cleanup and error handling:
+   /     A failed Setup returns no resource ID to the caller, so nobody
+   /     calls Cleanup for it. What was allocated so far is released
+   /     here, the first error is kept in the error parameters.
+   /---------------------------------------------------------------------*/
+   if (lTrace)
+   {
+      if (*pErrorOccurred)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+      }
+   }
+   if (*pErrorOccurred && (pBench != NULL))
+   {
+      Telemetry_ReleaseSlot(pBench->iTelemetrySlot);
+      Recorder_Destroy(pBench->pRecorder);
+      PanelClient_Disconnect(pBench->pPanelClient);
+      RESMGR_Free_Memory(sequenceContext, *pResourceId, &sTempOcc, &lTempCode,
+         cTempMsg);
+      pBench = NULL;
+   }
+   if (*pErrorOccurred && iAllocated)
+   {
+      RESMGR_Free_Resource(sequenceContext, *pResourceId, &sTempOcc,
+         &lTempCode, cTempMsg);
+      if (lTrace)
+      {
+         sprintf(cTraceBuffer, "Free Resource ID %ld", *pResourceId);
+         RESMGR_Trace(cTraceBuffer);
+      }
+   }
+   if (lTrace)
+   {
+      RESMGR_Trace("<<TSADJ_Setup end");
+   }
+
+}
+
+
+
+
+/* FUNCTION *******************************************************************/
+/**
+WaitForPanel:  waits until the panel of the last Display is shown
+ *
+@param timeout:       ms, an error if the panel is not shown by then;
+                      < 0 -> until it is shown, the execution is terminated
+                      or aborted
+ *
+Returns at once after a Display that has waited, for a panel server bench
+and without a panel.
+ *******************************************************************************/
+static void WaitForPanel(CAObjHandle sequenceContext, long pResourceId,
+   long timeout, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   char cTraceBuffer[1024];
+   long lTrace;
+   int iWait;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
+
+   if (lTrace)
+   {
+      RESMGR_Trace(">>TSADJ_WaitForAdjustmentPanel begin");
+   }
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+
+   if ((! *pErrorOccurred) && (pBench->hThreadHandle != NULL))
+   {
+      iWait = WaitForExecution(pBench, pBench->threadData.hReady,
+         (timeout < 0) ? INFINITE : (DWORD) timeout);
+      if (iWait != TSADJ_WAIT_DONE)
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = (iWait == TSADJ_WAIT_ABORTED) ? TSPAN_ERR_ABORTED
+            : TSPAN_ERR_PANELTIMEOUT;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+      else if (pBench->iVisiblePending)
+      {
+         pBench->iVisiblePending = FALSE;
+         Metrics_Add(pBench->cStepName, METRICS_PHASE_VISIBLE,
+            pBench->threadData.dShownTime - pBench->dDisplayStart);
+      }
+   }
+
+   if (lTrace)
+   {
+      if (*pErrorOccurred)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      RESMGR_Trace("<<TSADJ_WaitForAdjustmentPanel end");
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ShowAdjustmentPanel:  Display and DisplayAsync of both interfaces
+ *
+The async Display starts the panel thread and queues the panel commands, it
+returns without waiting for the panel. Values of SetValue before the panel
+is shown are not queued, only the last one is kept and shown together with
+the panel. WaitForPanel waits for the panel if the caller needs it. A panel
+server bench shows the panel before the return in both cases.
+ *
+@param iAsync:      TRUE -> return without waiting for the panel
+@param pRefs:       references of a TestStand Display, the bench takes them
+                    over and sets them to 0; NULL -> plain C caller
+ *******************************************************************************/
+static void ShowAdjustmentPanel(CAObjHandle sequenceContext,
+   long pResourceId, char nameOfStep[], char buttonText[], char unit[],
+   char format[], double lowerLimit, double upperLimit, int iAsync,
+   EXECUTION_REFS *pRefs, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   char cTraceBuffer[1024];
+   const char *pSerial = (pRefs != NULL) ? pRefs->cSerial : TSADJ_NO_SERIAL;
+   int iTabHandle;
+   
+   PANEL_COMMAND command;
+   PANEL_COMMAND scale;
+   int iScale;
+
+   long lTrace;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   int iWait;
+   HMODULE hModule;
+   double dCallStart;
+   double dLockStart;
+
+
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   dCallStart = Metrics_TimeStamp();
+   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
+
+   if (lTrace)
+   {
+      RESMGR_Trace(">>TSPAN_DisplayAdjustmentPanel begin");
+   }
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+
+   /* the unit follows the transform */
+   if ((! *pErrorOccurred) && (pBench->transform.cUnit[0] != '\0'))
+   {
+      unit = pBench->transform.cUnit;
+   }
+
+   /* a new simulated DUT for every panel */
+   if ((! *pErrorOccurred) && pBench->iSimulation)
+   {
+      Simulation_Begin(&pBench->sim, lowerLimit, upperLimit, dCallStart);
+   }
+
+   if ((! *pErrorOccurred) && (pBench->pPanelClient != NULL))
+   {
+      pBench->dDisplayStart = dCallStart;
+      if (JoinGroup(pBench))
+      {
+         ResetFeedback(&pBench->threadData);
+         SetExecution(pBench, pRefs);
+         DisplayRemotePanel(pResourceId, pBench, nameOfStep, buttonText, unit,
+            format, lowerLimit, upperLimit, pSerial, pErrorOccurred, pErrorCode,
+            errorMessage);
+         if (*pErrorOccurred)
+         {
+            LeaveGroup(pBench);
+         }
+      }
+      else
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_GROUPROUND;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+      if (lTrace)
+      {
+         if (*pErrorOccurred)
+         {
+            sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+            RESMGR_Trace(cTraceBuffer);
+         }
+         RESMGR_Trace("<<TSPAN_DisplayAdjustmentPanel end");
+      }
+      return ;
+   }
+
+   if (! *pErrorOccurred)
+   {
+      pBench->dDisplayStart = dCallStart;
+      pBench->iInLimitSeen = FALSE;
+      pBench->iVisiblePending = FALSE;
+      Filter_Reset(&pBench->filter);
+      StepResult_Begin(&pBench->result);
+      strncpy(pBench->cStepName, nameOfStep, METRICS_STEPNAME_LENGTH - 1);
+      pBench->cStepName[METRICS_STEPNAME_LENGTH - 1] = '\0';
+
+      if (pBench->hAbort == NULL)
+      {
+         pBench->hAbort = CreateEvent(NULL, TRUE, FALSE, NULL);
+      }
+      else
+      {
+         ResetEvent(pBench->hAbort);
+      }
+
+      /* Display without Hide: the old panel goes first */
+      if ((pBench->hThreadHandle != NULL) && !StopPanelThread(pBench, FALSE))
+      {
+         /* the old thread keeps the references of the last Display */
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_PANELTHREAD;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+   }
+
+   if (! *pErrorOccurred)
+   {
+      /* no button of the old panel can confirm the new round */
+      if (!JoinGroup(pBench))
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_GROUPROUND;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+   }
+
+   if (! *pErrorOccurred)
+   {
+      if (pBench->threadData.hReady == NULL)
+      {
+         pBench->threadData.hReady = CreateEvent(NULL, TRUE, FALSE, NULL);
+      }
+      if (pBench->threadData.queue.hWake == NULL)
+      {
+         PanelQueue_Initialize(&pBench->threadData.queue);
+      }
+      if ((pBench->threadData.hReady == NULL)
+         || (pBench->threadData.queue.hWake == NULL))
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_THREADWASNOTSTARTET;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+         LeaveGroup(pBench);
+      }
+   }
+
+   if (! *pErrorOccurred)
+   {
+      /* the old panel thread has ended, the references of the last
+         Display go */
+      SetExecution(pBench, pRefs);
+      pBench->threadData.iPanel = 0;
+      pBench->threadData.dButtonTime = 0.0;
+
+      if (lTrace)
+      {
+         RESMGR_Trace("Create new thread for UIR control");
+      }
+	  
+      /* reset before the start, the thread may set it at once */
+      ResetEvent(pBench->threadData.hReady);
+      PanelQueue_Reset(&pBench->threadData.queue);
+      pBench->threadData.lPending = PENDING_OPEN;
+      pBench->threadData.iPendingCount = 0;
+      pBench->threadData.dShownTime = 0.0;
+      ResetFeedback(&pBench->threadData);
+      if (lTrace)
+      {
+         RESMGR_Trace("EnterCriticalSection");
+      }
+
+      /* every bench runs its own panel thread, the lock only keeps the
+         thread starts of parallel sockets apart; the waits for the old
+         and the new panel are outside, so a hanging socket does not
+         hold up the others */
+      dLockStart = Metrics_TimeStamp();
+      EnterCriticalSection(&CriticalSection);
+      Metrics_Latency(&pBench->counters.lockWait, Metrics_TimeStamp()
+         - dLockStart);
+      //Create new thread for UIR control
+      pBench->hThreadHandle = NULL;
+      /* the thread keeps the DLL loaded until it has ended, see DllMain */
+      if (GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+         (LPCTSTR) PanelThread, &hModule))
+      {
+         pBench->hThreadHandle = CreateThread(NULL, 0, PanelThread,
+            (void*) &pBench->threadData, CREATE_SUSPENDED, &pBench->gThreadID);
+         if (pBench->hThreadHandle == NULL)
+         {
+            FreeLibrary(hModule);
+         }
+      }
+      LeaveCriticalSection(&CriticalSection);
+      if (lTrace)
+      {
+         RESMGR_Trace("LeaveCriticalSection");
+      }
+      if (pBench->hThreadHandle != NULL)
+      {
+         /* scheduled as configured from its first instruction */
+         SetThreadPriority(pBench->hThreadHandle, pBench->iThreadPriority);
+         if (pBench->dwAffinity)
+         {
+            SetThreadAffinityMask(pBench->hThreadHandle, pBench->dwAffinity);
+         }
+         ResumeThread(pBench->hThreadHandle);
+         Metrics_ThreadCreated();
+      }
+
+      /* the panel thread sets up and shows the panel, in this order */
+      iWait = TSADJ_WAIT_TIMEOUT;
+      if (pBench->hThreadHandle != NULL)
+      {
+         iScale = PanelView_Begin(&pBench->view, lowerLimit, upperLimit,
+            format, &scale);
+
+         memset(&command.data.display.command, 0, sizeof(PANELIPC_COMMAND));
+         command.iCommand = PANELQUEUE_CMD_CONFIGURE;
+         command.data.display.command.lFlags = pBench->iDemoMode
+            ? PANELIPC_FLAG_DEMO : 0;
+         command.data.display.command.dLowerLimit = lowerLimit;
+         command.data.display.command.dUpperLimit = upperLimit;
+         command.data.display.command.lFormat = pBench->view.iFormat;
+         command.data.display.command.lPrecision = pBench->view.iPrecision;
+         PanelView_FormatText(&command.data.display.text, nameOfStep,
+            buttonText, unit, format, lowerLimit, upperLimit);
+         iWait = QueueCommand(pBench, &command);
+         if ((iWait == TSADJ_WAIT_DONE) && iScale)
+         {
+            /* a full queue drops the range, the first value sets it again */
+            if (!PanelQueue_Push(&pBench->threadData.queue, &scale))
+            {
+               PanelView_Invalidate(&pBench->view);
+            }
+            InterlockedIncrement(&pBench->counters.lUiCallsIssued);
+         }
+         if (iWait == TSADJ_WAIT_DONE)
+         {
+            command.iCommand = PANELQUEUE_CMD_SHOW;
+            iWait = QueueCommand(pBench, &command);
+         }
+      }
+
+      /* Wait until the panel is shown, the async Display goes on at once */
+      if ((iWait == TSADJ_WAIT_DONE) && iAsync)
+      {
+         pBench->iVisiblePending = TRUE;
+      }
+      else if (iWait == TSADJ_WAIT_DONE)
+      {
+         iWait = WaitForExecution(pBench, pBench->threadData.hReady, WAITTMO);
+      }
+      if (iWait != TSADJ_WAIT_DONE)
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = (iWait == TSADJ_WAIT_ABORTED) ? TSPAN_ERR_ABORTED
+            : TSPAN_ERR_THREADWASNOTSTARTET;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+         if (pBench->hThreadHandle != NULL)
+         {
+            StopPanelThread(pBench, FALSE);
+         }
+         LeaveGroup(pBench);
+      }
+      else if (!iAsync)
+      {
+         Metrics_Add(pBench->cStepName, METRICS_PHASE_VISIBLE,
+            pBench->threadData.dShownTime - pBench->dDisplayStart);
+      }
+
+   }
+
+
+   if (*pErrorOccurred)
+   {
+      if (lTrace)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+         RESMGR_Trace("<<TSPAN_DisplayAdjustmentPanel end");
+      }
+      return ;
+   }
+
+   Telemetry_PublishConfig(pBench->iTelemetrySlot, nameOfStep, lowerLimit,
+      upperLimit, TELEMETRY_STATE_ACTIVE);
+   
+   if (pBench->pRecorder != NULL)
+   {
+      Recorder_Begin(pBench->pRecorder, pSerial, nameOfStep);
+   }
+   
+   /* a terminating execution does not wait for the panel to settle */
+   if (!iAsync)
+   {
+      WaitForExecution(pBench, NULL, 600);
+   }
+   
+   if (! *pErrorOccurred)
+   {
+      /* the operator may start adjusting now */
+      pBench->dDisplayEnd = Metrics_TimeStamp();
+      Metrics_Add(pBench->cStepName, METRICS_PHASE_DISPLAY,
+         pBench->dDisplayEnd - pBench->dDisplayStart);
+      Metrics_Latency(&pBench->counters.display, pBench->dDisplayEnd
+         - dCallStart);
+   }
+   
+   if (lTrace)
+   {
+      if (*pErrorOccurred)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      RESMGR_Trace("<<TSPAN_DisplayAdjustmentPanel end");
+   }
+   
+    
+}
+
+/* FUNCTION *******************************************************************/
+/**
+SetValueEx:  SetValue that tells the caller how the panel keeps up
+ *
+A loop can take its measurement interval from minInterval instead of
+measuring faster than the operator can see.
+ *
+@param rendered:      receives TSADJ_SAMPLE_xxx
+@param refreshRate:   receives the values per s the panel has shown lately,
+                      0.0 -> none yet
+@param minInterval:   receives the s the next value should wait at least:
+                      a frame, the time the panel takes per value or the
+                      time the commands wait in the queue, the longest
+ *******************************************************************************/
+static void SetValueEx(CAObjHandle sequenceContext, long pResourceId,
+   double value, short *rendered, double *refreshRate, double *minInterval,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   SAMPLE_FEEDBACK feedback;
+
+   feedback.sRendered = TSADJ_SAMPLE_DROPPED;
+   feedback.dRefreshRate = 0.0;
+   feedback.dMinInterval = TSADJ_FRAME_INTERVAL;
+   SetValues(sequenceContext, pResourceId, &value, 1, &feedback,
+      pErrorOccurred, pErrorCode, errorMessage);
+   *rendered = feedback.sRendered;
+   *refreshRate = feedback.dRefreshRate;
+   *minInterval = feedback.dMinInterval;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+SetValues:  shows the filtered value of one or more new readings
+ *
+@param values:      readings, the oldest first
+@param lCount:      number of readings, < 1 -> nothing to do
+@param pFeedback:   receives the backpressure without an error, may be NULL
+ *******************************************************************************/
+static void SetValues(CAObjHandle sequenceContext, long pResourceId,
+   const double values[], long lCount, SAMPLE_FEEDBACK *pFeedback,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+
+   char cTraceBuffer[1024];
+   long lTrace;
+   double dCallStart;
+   double dSimulated;
+   const TRANSFORM *pTransform;
+   PANELVIEW_READING reading;
+   PANEL_COMMAND press;
+   int iButtonHit;
+   int iRendered = TSADJ_SAMPLE_DROPPED;
+   double dInterval;
+   ThreadData *pThreadData;
+   int idx;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   if (lCount < 1)
+   {
+      *pErrorOccurred = FALSE;
+      *pErrorCode = 0;
+      return ;
+   }
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   dCallStart = Metrics_TimeStamp();
+   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
+
+   if (lTrace)
+   {
+      RESMGR_Trace(">>TSPAN_SetValueAdjustmentPanel begin");
+   }
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+
+   if (! *pErrorOccurred)
+   {
+      pTransform = &pBench->transform;
+      if (pBench->iSimulation)
+      {
+         /* the simulated DUT gives the shown quantity, no transform */
+         dSimulated = Simulation_Measure(&pBench->sim, dCallStart);
+         values = &dSimulated;
+         lCount = 1;
+         pTransform = NULL;
+      }
+      /* the way of tools/tsadjreplay.c; a panel server bench shows the
+         panel in Display, nothing is kept for it */
+      PanelView_SetValue(&pBench->view, &pBench->filter, pTransform, values,
+         lCount, dCallStart, (pBench->pPanelClient != NULL) ? NULL
+         : &pBench->threadData.lPending, pBench->threadData.pending,
+         &pBench->threadData.iPendingCount, RecordResult, pBench, &reading);
+   }
+
+   if ((! *pErrorOccurred) && (pBench->pPanelClient != NULL))
+   {
+      if (PanelClient_SetValue(pBench->pPanelClient, reading.dValue,
+         reading.commands, reading.iCommands, &iButtonHit))
+      {
+         /* the server draws before it answers */
+         iRendered = (reading.iCommands > 0) ? TSADJ_SAMPLE_SHOWN
+            : TSADJ_SAMPLE_UNCHANGED;
+         InterlockedExchangeAdd(&pBench->counters.lUiCallsIssued,
+            reading.iCommands);
+         InterlockedExchangeAdd(&pBench->counters.lUiCallsSkipped,
+            reading.iSkipped);
+         pThreadData = &pBench->threadData;
+         if (reading.iCommands > 0)
+         {
+            AddToMean(&pThreadData->dRedrawCost, Metrics_TimeStamp()
+               - dCallStart);
+            if (pThreadData->dLastRedraw > 0.0)
+            {
+               AddToMean(&pThreadData->dRedrawInterval, dCallStart
+                  - pThreadData->dLastRedraw);
+            }
+            pThreadData->dLastRedraw = dCallStart;
+         }
+         if (pBench->iDemoMode)
+         {
+            /* the server has overwritten indicator and colour */
+            PanelView_Invalidate(&pBench->view);
+         }
+         ButtonHitRemote(pBench, iButtonHit);
+         if (pBench->iSimulation && Simulation_Operate(&pBench->sim,
+            pBench->view.dShownValue, pBench->view.iShownPassed, dCallStart))
+         {
+            ButtonHitRemote(pBench, TRUE);
+         }
+      }
+      else
+      {
+         PanelView_Invalidate(&pBench->view);
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_PANELSERVER;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+      Metrics_SetValueCall(&pBench->counters, dCallStart, Metrics_TimeStamp());
+   }
+   else if (! *pErrorOccurred)
+   {
+      if (reading.iKept)
+      {
+         iRendered = TSADJ_SAMPLE_PENDING;
+      }
+      else
+      {
+         iRendered = (reading.iCommands > 0) ? TSADJ_SAMPLE_SHOWN
+            : TSADJ_SAMPLE_UNCHANGED;
+         /* a full queue drops the rest, the next value redraws */
+         for (idx = 0; idx < reading.iCommands; idx++)
+         {
+            if (!PanelQueue_Push(&pBench->threadData.queue,
+               &reading.commands[idx]))
+            {
+               PanelView_Invalidate(&pBench->view);
+               iRendered = TSADJ_SAMPLE_DROPPED;
+               break;
+            }
+         }
+         InterlockedExchangeAdd(&pBench->counters.lUiCallsIssued,
+            reading.iCommands);
+         InterlockedExchangeAdd(&pBench->counters.lUiCallsSkipped,
+            reading.iSkipped);
+      }
+
+      /* the simulated operator only knows what the panel shows */
+      if (pBench->iSimulation && Simulation_Operate(&pBench->sim,
+         pBench->view.dShownValue, pBench->view.iShownPassed, dCallStart))
+      {
+         press.iCommand = PANELQUEUE_CMD_PRESS;
+         QueueCommand(pBench, &press);
+      }
+
+      if (pBench->iDemoMode)
+      {
+         WaitForExecution(pBench, NULL, 500);
+         PanelQueue_SetText(&pBench->threadData.queue, ADJUSTMENT_TEXT,
+            "Adjustment panel in demo mode");
+         PanelQueue_SetAttribute(&pBench->threadData.queue,
+            ADJUSTMENT_BACKGROUND, ATTR_TEXT_BGCOLOR, VAL_MAGENTA);
+         PanelQueue_SetValue(&pBench->threadData.queue, ADJUSTMENT_INDICATOR,
+            -1.0);
+         /* indicator and colour have been overwritten */
+         PanelView_Invalidate(&pBench->view);
+      }
+
+      Metrics_SetValueCall(&pBench->counters, dCallStart, Metrics_TimeStamp());
+   }
+
+   /* measured by the panel thread, or above for the panel server */
+   if ((! *pErrorOccurred) && (pFeedback != NULL))
+   {
+      pThreadData = &pBench->threadData;
+      pFeedback->sRendered = (short) iRendered;
+      /* a panel that has stopped changing is as slow as its last change */
+      dInterval = pThreadData->dRedrawInterval;
+      if ((pThreadData->dLastRedraw > 0.0)
+         && (dCallStart - pThreadData->dLastRedraw > dInterval))
+      {
+         dInterval = dCallStart - pThreadData->dLastRedraw;
+      }
+      pFeedback->dRefreshRate = (dInterval > 0.0) ? 1.0 / dInterval : 0.0;
+      pFeedback->dMinInterval = TSADJ_FRAME_INTERVAL;
+      if (pThreadData->dRedrawCost > pFeedback->dMinInterval)
+      {
+         pFeedback->dMinInterval = pThreadData->dRedrawCost;
+      }
+      if (pThreadData->dQueueLag > pFeedback->dMinInterval)
+      {
+         pFeedback->dMinInterval = pThreadData->dQueueLag;
+      }
+   }
+   
+   if (lTrace)
+   {
+      if (*pErrorOccurred)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      RESMGR_Trace("<<TSPAN_SetValueAdjustmentPanel end");
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+HideAdjustmentPanel:  waits for the button and hides the panel; the time
+                      stamp of the call is kept in dHideStart for the
+                      result property
+ *******************************************************************************/
+static void HideAdjustmentPanel(CAObjHandle sequenceContext,
+   long pResourceId, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+
+   char cTraceBuffer[1024];
+
+   long lTrace;
+   long lDropped;
+   double dHideStart;
+   int iButtonHit;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   dHideStart = Metrics_TimeStamp();
+   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
+
+   if (lTrace)
+   {
+      RESMGR_Trace(">>TSPAN_HideAdjustmentPanel begin");
+   }
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+
+   if ((! *pErrorOccurred) && (pBench->pPanelClient != NULL))
+   {
+      Telemetry_PublishState(pBench->iTelemetrySlot, TELEMETRY_STATE_IDLE);
+      lDropped = Recorder_End(pBench->pRecorder);
+      if ((lDropped > 0) && lTrace)
+      {
+         sprintf(cTraceBuffer, "Recorder dropped %ld values", lDropped);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      if (PanelClient_Hide(pBench->pPanelClient, &iButtonHit))
+      {
+         ButtonHitRemote(pBench, iButtonHit);
+      }
+      else
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_PANELSERVER;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+      if (pBench->dButtonHit > pBench->dDisplayEnd)
+      {
+         Metrics_Add(pBench->cStepName, METRICS_PHASE_CONFIRM,
+            pBench->dButtonHit - pBench->dDisplayEnd);
+      }
+      Metrics_Add(pBench->cStepName, METRICS_PHASE_HIDE,
+         Metrics_TimeStamp() - dHideStart);
+      Metrics_Latency(&pBench->counters.hide, Metrics_TimeStamp()
+         - dHideStart);
+   }
+   else if (! *pErrorOccurred)
+   {
+      Telemetry_PublishState(pBench->iTelemetrySlot, TELEMETRY_STATE_IDLE);
+      lDropped = Recorder_End(pBench->pRecorder);
+      if ((lDropped > 0) && lTrace)
+      {
+         sprintf(cTraceBuffer, "Recorder dropped %ld values", lDropped);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      if (pBench->threadData.dButtonTime > pBench->dDisplayEnd)
+      {
+         Metrics_Add(pBench->cStepName, METRICS_PHASE_CONFIRM,
+            pBench->threadData.dButtonTime - pBench->dDisplayEnd);
+      }
+
+      if (pBench->hThreadHandle != NULL)
+      {
+         /* the thread discards its panel, tsadj_Cleanup joins a thread
+            left behind by a terminating execution */
+         if (!StopPanelThread(pBench, TRUE) && lTrace)
+         {
+            RESMGR_Trace("Execution terminates, panel thread left to Cleanup");
+         }
+      }
+	  
+      Metrics_Add(pBench->cStepName, METRICS_PHASE_HIDE,
+         Metrics_TimeStamp() - dHideStart);
+      Metrics_Latency(&pBench->counters.hide, Metrics_TimeStamp()
+         - dHideStart);
+
+   }
+
+   if (! *pErrorOccurred)
+   {
+      /* the end of the result, see tsadj_HideAdjustmentPanel */
+      pBench->dHideStart = dHideStart;
+   }
+   
+   if (lTrace)
+   {
+      if (*pErrorOccurred)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      RESMGR_Trace("<<TSPAN_HideAdjustmentPanel end");
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+CleanupBench:  ends the panel thread and frees the bench, a pooled bench
+               goes back to the pool
+ *******************************************************************************/
+static void CleanupBench(CAObjHandle sequenceContext, long pResourceId,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   char cTraceBuffer[1024];
+
+   long lTrace;
+   int iPooled = FALSE;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
+
+   if (lTrace)
+   {
+      RESMGR_Trace(">>TSADJ_Cleanup begin");
+   }
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+   /*---------------------------------------------------------------------/
+   /   Return to the pool:
+   /     A bench set up by tsadj_SetupPooled keeps its memory block and
+   /     resource ID for the next UUT.
+   /---------------------------------------------------------------------*/
+   if ((! *pErrorOccurred) && pBench->iPooled)
+   {
+      /* a thread left by the Hide of a terminating execution must not
+         run into the next UUT, a thread that does not end keeps the
+         bench out of the pool */
+      if ((pBench->hThreadHandle != NULL) && !StopPanelThread(pBench, FALSE))
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_PANELTHREAD;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+   }
+   if ((! *pErrorOccurred) && pBench->iPooled)
+   {
+      ResetConfiguration(pBench);
+      iPooled = ReturnToPool(pResourceId);
+      if (lTrace && iPooled)
+      {
+         sprintf(cTraceBuffer, "Resource ID %ld returned to pool",
+            pResourceId);
+         RESMGR_Trace(cTraceBuffer);
+      }
+   }
+   /*---------------------------------------------------------------------/
+   /   Dispose memory:
+   /     Free the memory block associated with the resource ID.
+   /     Note that pBench is no longer valid now because it points
+   /     to dynamic memory that has been released!
+   /---------------------------------------------------------------------*/
+   if ((! *pErrorOccurred) && (! iPooled))
+   {
+      if (pBench->iStatistics)
+      {
+         Metrics_Trace();
+      }
+      /* Cleanup without Hide, or Hide of a terminating execution; a
+         thread that does not end still uses the bench, it is kept */
+      if ((pBench->hThreadHandle != NULL) && !StopPanelThread(pBench, FALSE))
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_PANELTHREAD;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+   }
+   if ((! *pErrorOccurred) && (! iPooled))
+   {
+      SetExecution(pBench, NULL);
+      if (pBench->hAbort != NULL)
+      {
+         CloseHandle(pBench->hAbort);
+         pBench->hAbort = NULL;
+      }
+      if (pBench->threadData.hReady != NULL)
+      {
+         CloseHandle(pBench->threadData.hReady);
+         pBench->threadData.hReady = NULL;
+      }
+      PanelQueue_Close(&pBench->threadData.queue);
+      Telemetry_ReleaseSlot(pBench->iTelemetrySlot);
+      Recorder_Destroy(pBench->pRecorder);
+      PanelClient_Disconnect(pBench->pPanelClient);
+      RESMGR_Free_Memory(sequenceContext, pResourceId, pErrorOccurred,
+         pErrorCode, errorMessage);
+   }
+   pBench = NULL;
+
+   /*---------------------------------------------------------------------/
+   /   Free resource:
+   /     The resource ID (our "ticket") is given back to the resource
+   /     manager and may be reused in a subsequent RESMGR_Alloc_Resource
+   /     call.
+   /---------------------------------------------------------------------*/
+   if ((! *pErrorOccurred) && (! iPooled))
+   {
+      RESMGR_Free_Resource(sequenceContext, pResourceId, pErrorOccurred,
+         pErrorCode, errorMessage);
+   }
+   if ((! *pErrorOccurred) && (! iPooled))
+   {
+      if (lTrace)
+      {
+         sprintf(cTraceBuffer, "Free Resource ID %ld", pResourceId);
+         RESMGR_Trace(cTraceBuffer);
+      }
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Cleanup and error handling
+   /---------------------------------------------------------------------*/
+   if (lTrace)
+   {
+      if (*pErrorOccurred)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      RESMGR_Trace("<<TSADJ_Cleanup end");
+   }
+
+}
+
+void __stdcall tsadj_SetupPooled(CAObjHandle sequenceContext, char *pBenchName,
+   char *pIniFile, long *pResourceId, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   char cTraceBuffer[1024];
+   FILETIME ftWriteTime;
+   POOL_ENTRY *pEntry = NULL;
+   POOL_ENTRY stale;
+   int iHaveTime;
+   int idx;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   *pErrorOccurred = FALSE;
+   *pErrorCode = 0;
+   stale.lResourceId = RESMGR_INVALID_ID;
+   iHaveTime = GetIniWriteTime(pIniFile, &ftWriteTime);
+
+   /*---------------------------------------------------------------------/
+   /   Look for an idle bench:
+   /     An idle bench with the same name is reused if the INI file has
+   /     not been changed since its setup. Otherwise it is removed from
+   /     the pool and freed, and the bench is set up again.
+   /---------------------------------------------------------------------*/
+   EnterCriticalSection(&PoolCriticalSection);
+   for (idx = 0; idx < giPoolCount; idx++)
+   {
+      if ((!gPool[idx].iInUse) && (strcmp(gPool[idx].cBenchName, pBenchName)
+         == 0) && (strcmp(gPool[idx].cIniFile, pIniFile) == 0))
+      {
+         if (iHaveTime && (CompareFileTime(&gPool[idx].ftIniWriteTime,
+            &ftWriteTime) == 0))
+         {
+            gPool[idx].iInUse = TRUE;
+            pEntry = &gPool[idx];
+         }
+         else
+         {
+            stale = gPool[idx];
+            gPool[idx] = gPool[--giPoolCount];
+         }
+         break;
+      }
+   }
+   LeaveCriticalSection(&PoolCriticalSection);
+
+   if (pEntry != NULL)
+   {
+      *pResourceId = pEntry->lResourceId;
+      RESMGR_Set_Trace_Flag(*pResourceId, pEntry->lTrace);
+      if (pEntry->lTrace)
+      {
+         sprintf(cTraceBuffer, "TSADJ_SetupPooled: bench %s reused -> "
+            "Resource ID %ld", pBenchName, *pResourceId);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      return;
+   }
+
+   if (stale.lResourceId != RESMGR_INVALID_ID)
+   {
+      pBench = GetBench(sequenceContext, stale.lResourceId, pErrorOccurred,
+         pErrorCode, errorMessage);
+      if (! *pErrorOccurred)
+      {
+         pBench->iPooled = FALSE;
+         CleanupBench(sequenceContext, stale.lResourceId, pErrorOccurred,
+            pErrorCode, errorMessage);
+      }
+      /* the stale bench is gone either way, start over */
+      *pErrorOccurred = FALSE;
+      *pErrorCode = 0;
+      pBench = NULL;
+   }
+
+   /*---------------------------------------------------------------------/
+   /   Full setup:
+   /     The new bench is added to the pool. If the pool is full or the
+   /     INI file cannot be found, it is used like an unpooled bench.
+   /---------------------------------------------------------------------*/
+   SetupBench(sequenceContext, pBenchName, pResourceId, pErrorOccurred,
+      pErrorCode, errorMessage);
+   if (! *pErrorOccurred)
+   {
+      pBench = GetBench(sequenceContext, *pResourceId, pErrorOccurred,
+         pErrorCode, errorMessage);
+   }
+   if ((! *pErrorOccurred) && iHaveTime)
+   {
+      EnterCriticalSection(&PoolCriticalSection);
+      if (giPoolCount < TSADJ_POOL_SIZE)
+      {
+         pEntry = &gPool[giPoolCount++];
+         strncpy(pEntry->cBenchName, pBenchName, RESMGR_MAX_NAME_LENGTH);
+         pEntry->cBenchName[RESMGR_MAX_NAME_LENGTH] = '\0';
+         strncpy(pEntry->cIniFile, pIniFile, MAX_PATH - 1);
+         pEntry->cIniFile[MAX_PATH - 1] = '\0';
+         pEntry->ftIniWriteTime = ftWriteTime;
+         pEntry->lResourceId = *pResourceId;
+         pEntry->lTrace = RESMGR_Get_Trace_Flag(*pResourceId);
+         pEntry->iInUse = TRUE;
+         pBench->iPooled = TRUE;
+      }
+      LeaveCriticalSection(&PoolCriticalSection);
+   }
+
+}
+
+void __stdcall tsadj_FlushPool(CAObjHandle sequenceContext,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   POOL_ENTRY idle[TSADJ_POOL_SIZE];
+   int iIdleCount = 0;
+   int idx;
+   short sOccurred;
+   long lCode;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   *pErrorOccurred = FALSE;
+   *pErrorCode = 0;
+
+   /* take the idle benches out of the pool, benches in use stay */
+   EnterCriticalSection(&PoolCriticalSection);
+   idx = 0;
+   while (idx < giPoolCount)
+   {
+      if (!gPool[idx].iInUse)
+      {
+         idle[iIdleCount++] = gPool[idx];
+         gPool[idx] = gPool[--giPoolCount];
+      }
+      else
+      {
+         idx++;
+      }
+   }
+   LeaveCriticalSection(&PoolCriticalSection);
+
+   /* free them, the first error is reported */
+   for (idx = 0; idx < iIdleCount; idx++)
+   {
+      sOccurred = FALSE;
+      pBench = GetBench(sequenceContext, idle[idx].lResourceId, &sOccurred,
+         &lCode, errorMessage);
+      if (!sOccurred)
+      {
+         pBench->iPooled = FALSE;
+         CleanupBench(sequenceContext, idle[idx].lResourceId, &sOccurred,
+            &lCode, errorMessage);
+      }
+      if (sOccurred && !*pErrorOccurred)
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = lCode;
+      }
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+SetFilter:  filter of the values of the following panels, see filter.h
+ *******************************************************************************/
+static void SetFilter(CAObjHandle sequenceContext, long pResourceId,
+   long filterType, long window, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   BENCH_STRUCT *pBench = NULL;
+
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+   if (! *pErrorOccurred)
+   {
+      if (Filter_Configure(&pBench->filter, (int)filterType, (int)window) != 0)
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_FILTER;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+SetTransform:  transform of the values of the following panels, see
+               transform.h
+ *******************************************************************************/
+static void SetTransform(CAObjHandle sequenceContext, long pResourceId,
+   char transform[], short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   BENCH_STRUCT *pBench = NULL;
+
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+   if (! *pErrorOccurred)
+   {
+      if (Transform_Compile(&pBench->transform, transform) != 0)
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_TRANSFORM;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+SetHysteresis:  hysteresis of the pass/fail colour, value unit
+ *******************************************************************************/
+static void SetHysteresis(CAObjHandle sequenceContext, long pResourceId,
+   double hysteresis, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   BENCH_STRUCT *pBench = NULL;
+
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+   if (! *pErrorOccurred)
+   {
+      pBench->view.dHysteresis = (hysteresis > 0.0) ? hysteresis : 0.0;
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+AbortPanel:  ends the waits of Display and Hide of a bench at once, e.g.
+from a termination callback or another thread
+ *******************************************************************************/
+static void AbortPanel(CAObjHandle sequenceContext, long pResourceId,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   BENCH_STRUCT *pBench = NULL;
+
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+   if ((! *pErrorOccurred) && (pBench->hAbort != NULL))
+   {
+      SetEvent(pBench->hAbort);
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+SetGroup:  group the panels of the following Display calls join, see
+           barrier.h
+ *
+@param groupName:     name shared by the sockets, "" -> no group
+@param members:       panels of one round, the number of test sockets,
+                      1 .. BARRIER_MAX_MEMBERS; each bench is one member
+ *******************************************************************************/
+static void SetGroup(CAObjHandle sequenceContext, long pResourceId,
+   char groupName[], long members, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   BENCH_STRUCT *pBench = NULL;
+
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+   if (! *pErrorOccurred)
+   {
+      if ((groupName[0] != '\0') && ((members < 1)
+         || (members > BARRIER_MAX_MEMBERS)))
+      {
+         pBench->pGroup = NULL;
+      }
+      else
+      {
+         pBench->pGroup = (groupName[0] != '\0') ? Barrier_Find(groupName)
+            : NULL;
+      }
+      pBench->lGroupMembers = members;
+      if ((groupName[0] != '\0') && (pBench->pGroup == NULL))
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = TSPAN_ERR_GROUP;
+         formatError(errorMessage,  *pErrorCode, pResourceId,
+            pBench->cResourceName, NULL);
+      }
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+WaitForGroup:  waits until all panels of the round of the current panel
+               are confirmed
+ *
+Returns as soon as the last member presses its button, the buttons are
+counted by the panel threads. A terminating execution or AbortPanel ends
+the wait with TSPAN_ERR_ABORTED.
+ *
+@param timeout:       ms
+@param allConfirmed:  receives 0 if the timeout has elapsed before
+ *******************************************************************************/
+static void WaitForGroup(CAObjHandle sequenceContext, long pResourceId,
+   long timeout, short *allConfirmed, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   char cTraceBuffer[1024];
+   long lTrace;
+   long lConfirmed;
+   long lMembers;
+   DWORD dwStart;
+   DWORD dwElapsed;
+   DWORD dwSlice;
+   int iDone = FALSE;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   *allConfirmed = FALSE;
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
+
+   if (lTrace)
+   {
+      RESMGR_Trace(">>TSADJ_WaitForAdjustmentGroup begin");
+   }
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+   if ((! *pErrorOccurred) && (pBench->threadData.pBarrier == NULL))
+   {
+      *pErrorOccurred = TRUE;
+      *pErrorCode = TSPAN_ERR_GROUP;
+      formatError(errorMessage,  *pErrorCode, pResourceId,
+         pBench->cResourceName, NULL);
+   }
+
+   if (! *pErrorOccurred)
+   {
+      /* the event may already belong to a later round, the round decides */
+      dwStart = GetTickCount();
+      while (!(iDone = Barrier_Done(pBench->threadData.pBarrier,
+         pBench->threadData.lBarrierRound, &lConfirmed, &lMembers)))
+      {
+         dwElapsed = GetTickCount() - dwStart;
+         if ((timeout <= 0) || (dwElapsed >= (DWORD) timeout))
+         {
+            break;
+         }
+         dwSlice = (DWORD) timeout - dwElapsed;
+         if (dwSlice > pBench->dwAbortLatency)
+         {
+            dwSlice = pBench->dwAbortLatency;
+         }
+         if (WaitForExecution(pBench, pBench->threadData.pBarrier->hDone,
+            dwSlice) == TSADJ_WAIT_ABORTED)
+         {
+            *pErrorOccurred = TRUE;
+            *pErrorCode = TSPAN_ERR_ABORTED;
+            formatError(errorMessage,  *pErrorCode, pResourceId,
+               pBench->cResourceName, NULL);
+            break;
+         }
+      }
+      *allConfirmed = (short) iDone;
+      if (lTrace)
+      {
+         sprintf(cTraceBuffer, "Group %s: %ld of %ld panels confirmed",
+            pBench->threadData.pBarrier->cName, lConfirmed, lMembers);
+         RESMGR_Trace(cTraceBuffer);
+      }
+   }
+
+   if (lTrace)
+   {
+      if (*pErrorOccurred)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      RESMGR_Trace("<<TSADJ_WaitForAdjustmentGroup end");
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+tsadj_PublishAdjustmentResult:  writes final value, minimum, maximum, time
+in the limits, limit crossings, time to confirm and number of values of the
+current panel as one number array, see stepresult.h
+ *
+@param propertyName:  lookup string of the array, e.g.
+                      "Step.Result.AdjustmentResult"
+@param atHide:        0 -> write now, 1 -> every following Hide writes the
+                      result of its panel, "" -> no longer
+ *******************************************************************************/
+void __stdcall tsadj_PublishAdjustmentResult(CAObjHandle sequenceContext,
+   long pResourceId, char propertyName[], short atHide,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   char cTraceBuffer[1024];
+   long lTrace;
+   HRESULT hResult;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
+
+   if (lTrace)
+   {
+      RESMGR_Trace(">>TSADJ_PublishAdjustmentResult begin");
+   }
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+
+   if ((! *pErrorOccurred) && atHide)
+   {
+      strncpy(pBench->cResultProperty, propertyName, TSADJ_RESULT_LENGTH - 1);
+      pBench->cResultProperty[TSADJ_RESULT_LENGTH - 1] = '\0';
+   }
+   else if (! *pErrorOccurred)
+   {
+      hResult = PublishResult(sequenceContext, pBench, propertyName,
+         Metrics_TimeStamp());
+      if (hResult < 0)
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = hResult;
+         CA_GetAutomationErrorString(hResult, errorMessage, 1024);
+      }
+   }
+
+   if (lTrace)
+   {
+      if (*pErrorOccurred)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      RESMGR_Trace("<<TSADJ_PublishAdjustmentResult end");
+   }
+
+}
+
+void __stdcall tsadj_GetAdjustmentStatistics (CAObjHandle sequenceContext,
+                                             long pResourceId, char nameOfStep[],
+                                             char propertyName[],
+                                             short *pErrorOccurred,
+                                             long *pErrorCode,
+                                             char errorMessage[])
+{
+   char cTraceBuffer[1024];
+   char cLookup[1024];
+   char cHistogram[METRICS_BUCKETS * 12];
+   long lTrace;
+   int iPhase;
+   int idx;
+   HRESULT hResult = 0;
+   ERRORINFO errorInfo;
+   METRICS_PHASE phases[METRICS_PHASES];
+   METRICS_PHASE *pPhase;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
+
+   if (lTrace)
+   {
+      RESMGR_Trace(">>TSADJ_GetAdjustmentStatistics begin");
+   }
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+
+   /*---------------------------------------------------------------------/
+   /   Write the phases:
+   /     <propertyName>.<Phase>.Count/Mean/Min/Max in seconds and
+   /     <propertyName>.<Phase>.Histogram as comma separated bucket
+   /     counts, bucket n holds the durations below 2^n ms.
+   /---------------------------------------------------------------------*/
+   if (! *pErrorOccurred)
+   {
+      Metrics_Get(nameOfStep, phases);
+
+      for (iPhase = 0; (iPhase < METRICS_PHASES) && (hResult >= 0); iPhase++)
+      {
+         pPhase = &phases[iPhase];
+
+         sprintf(cLookup, "%.900s.%s.Count", propertyName,
+            Metrics_PhaseName(iPhase));
+         hResult = TS_PropertySetValNumber(sequenceContext, &errorInfo, cLookup,
+            TS_PropOption_InsertIfMissing, pPhase->lCount);
+         if (hResult >= 0)
+         {
+            sprintf(cLookup, "%.900s.%s.Mean", propertyName,
+               Metrics_PhaseName(iPhase));
+            hResult = TS_PropertySetValNumber(sequenceContext, &errorInfo,
+               cLookup, TS_PropOption_InsertIfMissing, (pPhase->lCount > 0) ?
+               pPhase->dSum / pPhase->lCount : 0.0);
+         }
+         if (hResult >= 0)
+         {
+            sprintf(cLookup, "%.900s.%s.Min", propertyName,
+               Metrics_PhaseName(iPhase));
+            hResult = TS_PropertySetValNumber(sequenceContext, &errorInfo,
+               cLookup, TS_PropOption_InsertIfMissing, pPhase->dMin);
+         }
+         if (hResult >= 0)
+         {
+            sprintf(cLookup, "%.900s.%s.Max", propertyName,
+               Metrics_PhaseName(iPhase));
+            hResult = TS_PropertySetValNumber(sequenceContext, &errorInfo,
+               cLookup, TS_PropOption_InsertIfMissing, pPhase->dMax);
+         }
+         if (hResult >= 0)
+         {
+            cHistogram[0] = '\0';
+            for (idx = 0; idx < METRICS_BUCKETS; idx++)
+            {
+               sprintf(cHistogram + strlen(cHistogram), (idx > 0) ? ",%ld" :
+                  "%ld", pPhase->lBuckets[idx]);
+            }
+            sprintf(cLookup, "%.900s.%s.Histogram", propertyName,
+               Metrics_PhaseName(iPhase));
+            hResult = TS_PropertySetValString(sequenceContext, &errorInfo,
+               cLookup, TS_PropOption_InsertIfMissing, cHistogram);
+         }
+      }
+      if (hResult < 0)
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = hResult;
+         CA_GetAutomationErrorString(hResult, errorMessage, 1024);
+      }
+   }
+
+   if (lTrace)
+   {
+      if (*pErrorOccurred)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      RESMGR_Trace("<<TSADJ_GetAdjustmentStatistics end");
+   }
+
+}
+
+void __stdcall tsadj_GetInstrumentationCounters (CAObjHandle sequenceContext,
+                                                long pResourceId,
+                                                char propertyName[],
+                                                short resetCounters,
+                                                short *pErrorOccurred,
+                                                long *pErrorCode,
+                                                char errorMessage[])
+{
+   char cTraceBuffer[1024];
+   long lTrace;
+   HRESULT hResult = 0;
+   METRICS_COUNTERS counters;
+   METRICS_GLOBAL_COUNTERS global;
+
+   BENCH_STRUCT *pBench = NULL;
+
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return ;
+   }
+   lTrace = RESMGR_Get_Trace_Flag(pResourceId);
+
+   if (lTrace)
+   {
+      RESMGR_Trace(">>TSADJ_GetInstrumentationCounters begin");
+   }
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+
+   /*---------------------------------------------------------------------/
+   /   Take the snapshot:
+   /     The queue delay of the panel thread and the process counters are
+   /     copied under the metrics lock, so the TestStand calls below work
+   /     on a consistent copy.
+   /---------------------------------------------------------------------*/
+   if (! *pErrorOccurred)
+   {
+      Metrics_GetCounters(&pBench->counters, &counters, resetCounters);
+      Metrics_GetGlobalCounters(&global, resetCounters);
+
+      hResult = SetLatencyProperties(sequenceContext, propertyName, "Display",
+         &counters.display);
+      if (hResult >= 0)
+      {
+         hResult = SetLatencyProperties(sequenceContext, propertyName,
+            "SetValue", &counters.setValue);
+      }
+      if (hResult >= 0)
+      {
+         hResult = SetLatencyProperties(sequenceContext, propertyName, "Hide",
+            &counters.hide);
+      }
+      if (hResult >= 0)
+      {
+         hResult = SetLatencyProperties(sequenceContext, propertyName,
+            "LockWait", &counters.lockWait);
+      }
+      if (hResult >= 0)
+      {
+         hResult = SetLatencyProperties(sequenceContext, propertyName,
+            "QueueDelay", &counters.queueDelay);
+      }
+      if (hResult >= 0)
+      {
+         hResult = SetLatencyProperties(sequenceContext, propertyName,
+            "Callback", &global.callback);
+      }
+      if (hResult >= 0)
+      {
+         hResult = SetLatencyProperties(sequenceContext, propertyName,
+            "ClickDelay", &global.click);
+      }
+      if (hResult >= 0)
+      {
+         hResult = SetNumberProperty(sequenceContext, propertyName,
+            "SetValueRate", Metrics_CallRate(&counters));
+      }
+      if (hResult >= 0)
+      {
+         hResult = SetNumberProperty(sequenceContext, propertyName,
+            "UICallsIssued", counters.lUiCallsIssued);
+      }
+      if (hResult >= 0)
+      {
+         hResult = SetNumberProperty(sequenceContext, propertyName,
+            "UICallsSkipped", counters.lUiCallsSkipped);
+      }
+      if (hResult >= 0)
+      {
+         hResult = SetNumberProperty(sequenceContext, propertyName,
+            "ThreadsCreated", global.lThreadsCreated);
+      }
+      if (hResult >= 0)
+      {
+         hResult = SetNumberProperty(sequenceContext, propertyName,
+            "ThreadsJoined", global.lThreadsJoined);
+      }
+      if (hResult < 0)
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = hResult;
+         CA_GetAutomationErrorString(hResult, errorMessage, 1024);
+      }
+   }
+
+   if (lTrace)
+   {
+      if (*pErrorOccurred)
+      {
+         sprintf(cTraceBuffer, "Error %ld : %s",  *pErrorCode, errorMessage);
+         RESMGR_Trace(cTraceBuffer);
+      }
+      RESMGR_Trace("<<TSADJ_GetInstrumentationCounters end");
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+tsadj_xxx:  TestStand entry points, see tsadj.h
+ *
+The resource manager gets the sequence context of the step. What only
+TestStand has is done here: Display takes the references to the execution
+and the sequence context, see DisplayFromTestStand, and Hide writes the
+result property.
+ *******************************************************************************/
+void __stdcall tsadj_Setup(CAObjHandle sequenceContext, char *pBenchName, long
+   *pResourceId, short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   SetupBench(sequenceContext, pBenchName, pResourceId, pErrorOccurred,
+      pErrorCode, errorMessage);
+}
+
+void __stdcall tsadj_Cleanup(CAObjHandle sequenceContext, long pResourceId,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   CleanupBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadj_DisplayAdjustmentPanel (CAObjHandle sequenceContext,
+                                            long pResourceId, char nameOfStep[], char buttonText[],
+                                            char unit[], char compType[],
+                                            char format[], double lowerLimit,
+                                            double upperLimit, short AlwaysOnTop,
+                                            short *pErrorOccurred,
+                                            long *pErrorCode, char errorMessage[])
+{
+   DisplayFromTestStand(sequenceContext, pResourceId, nameOfStep, buttonText,
+      unit, format, lowerLimit, upperLimit, FALSE, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadj_DisplayAdjustmentPanelAsync (CAObjHandle sequenceContext,
+   long pResourceId, char nameOfStep[], char buttonText[], char unit[],
+   char compType[], char format[], double lowerLimit, double upperLimit,
+   short AlwaysOnTop, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   DisplayFromTestStand(sequenceContext, pResourceId, nameOfStep, buttonText,
+      unit, format, lowerLimit, upperLimit, TRUE, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadj_WaitForAdjustmentPanel (CAObjHandle sequenceContext,
+   long pResourceId, long timeout, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   WaitForPanel(sequenceContext, pResourceId, timeout, pErrorOccurred,
+      pErrorCode, errorMessage);
+}
+
+void __stdcall tsadj_SetValueAdjustmentPanel (CAObjHandle sequenceContext,
+                                             long pResourceId, double value,
+                                             short *pErrorOccurred,
+                                             long *pErrorCode,
+                                             char errorMessage[])
+{
+   SetValues(sequenceContext, pResourceId, &value, 1, NULL, pErrorOccurred,
+      pErrorCode, errorMessage);
+}
+
+void __stdcall tsadj_SetValueAdjustmentPanelEx (CAObjHandle sequenceContext,
+   long pResourceId, double value, short *rendered, double *refreshRate,
+   double *minInterval, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   SetValueEx(sequenceContext, pResourceId, value, rendered, refreshRate,
+      minInterval, pErrorOccurred, pErrorCode, errorMessage);
+}
+
+void __stdcall tsadj_SetValuesAdjustmentPanel (CAObjHandle sequenceContext,
+                                              long pResourceId,
+                                              double values[], long count,
+                                              short *pErrorOccurred,
+                                              long *pErrorCode,
+                                              char errorMessage[])
+{
+   SetValues(sequenceContext, pResourceId, values, count, NULL,
+      pErrorOccurred, pErrorCode, errorMessage);
+}
+
+void __stdcall tsadj_HideAdjustmentPanel (CAObjHandle sequenceContext,
+                                         long pResourceId, short *pErrorOccurred,
+                                         long *pErrorCode, char errorMessage[])
+{
+   BENCH_STRUCT *pBench = NULL;
+   HRESULT hResult;
+
+   HideAdjustmentPanel(sequenceContext, pResourceId, pErrorOccurred,
+      pErrorCode, errorMessage);
+   if (! *pErrorOccurred)
+   {
+      pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred,
+         pErrorCode, errorMessage);
+   }
+
+   /* the whole result in one TestStand call, see PublishResult */
+   if ((! *pErrorOccurred) && (pBench->cResultProperty[0] != '\0'))
+   {
+      hResult = PublishResult(sequenceContext, pBench,
+         pBench->cResultProperty, pBench->dHideStart);
+      if (hResult < 0)
+      {
+         *pErrorOccurred = TRUE;
+         *pErrorCode = hResult;
+         CA_GetAutomationErrorString(hResult, errorMessage, 1024);
+      }
+   }
+
+}
+
+void __stdcall tsadj_SetFilter(CAObjHandle sequenceContext, long pResourceId,
+   long filterType, long window, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   SetFilter(sequenceContext, pResourceId, filterType, window, pErrorOccurred,
+      pErrorCode, errorMessage);
+}
+
+void __stdcall tsadj_SetTransform(CAObjHandle sequenceContext,
+   long pResourceId, char transform[], short *pErrorOccurred,
+   long *pErrorCode, char errorMessage[])
+{
+   SetTransform(sequenceContext, pResourceId, transform, pErrorOccurred,
+      pErrorCode, errorMessage);
+}
+
+void __stdcall tsadj_SetHysteresis(CAObjHandle sequenceContext,
+   long pResourceId, double hysteresis, short *pErrorOccurred,
+   long *pErrorCode, char errorMessage[])
+{
+   SetHysteresis(sequenceContext, pResourceId, hysteresis, pErrorOccurred,
+      pErrorCode, errorMessage);
+}
+
+void __stdcall tsadj_AbortAdjustmentPanel(CAObjHandle sequenceContext,
+   long pResourceId, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   AbortPanel(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadj_SetAdjustmentGroup(CAObjHandle sequenceContext,
+   long pResourceId, char groupName[], long members, short *pErrorOccurred,
+   long *pErrorCode, char errorMessage[])
+{
+   SetGroup(sequenceContext, pResourceId, groupName, members, pErrorOccurred,
+      pErrorCode, errorMessage);
+}
+
+void __stdcall tsadj_WaitForAdjustmentGroup(CAObjHandle sequenceContext,
+   long pResourceId, long timeout, short *allConfirmed, short *pErrorOccurred,
+   long *pErrorCode, char errorMessage[])
+{
+   WaitForGroup(sequenceContext, pResourceId, timeout, allConfirmed,
+      pErrorOccurred, pErrorCode, errorMessage);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+tsadjc_xxx:  entry points for test executors without TestStand, see tsadjc.h
+ *
+The same functions as for TestStand with a sequence context of 0 and no
+execution references.
+ *******************************************************************************/
+void __stdcall tsadjc_Setup(char benchName[], long *pResourceId,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   SetupBench(0, benchName, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_Cleanup(long pResourceId, short *pErrorOccurred,
+   long *pErrorCode, char errorMessage[])
+{
+   CleanupBench(0, pResourceId, pErrorOccurred, pErrorCode, errorMessage);
+}
+
+void __stdcall tsadjc_Display(long pResourceId, char nameOfStep[],
+   char buttonText[], char unit[], char format[], double lowerLimit,
+   double upperLimit, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   ShowAdjustmentPanel(0, pResourceId, nameOfStep, buttonText, unit, format,
+      lowerLimit, upperLimit, FALSE, NULL, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_DisplayAsync(long pResourceId, char nameOfStep[],
+   char buttonText[], char unit[], char format[], double lowerLimit,
+   double upperLimit, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   ShowAdjustmentPanel(0, pResourceId, nameOfStep, buttonText, unit, format,
+      lowerLimit, upperLimit, TRUE, NULL, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_WaitForPanel(long pResourceId, long timeout,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   WaitForPanel(0, pResourceId, timeout, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_SetValue(long pResourceId, double value,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   SetValues(0, pResourceId, &value, 1, NULL, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_SetValueEx(long pResourceId, double value,
+   short *rendered, double *refreshRate, double *minInterval,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   SetValueEx(0, pResourceId, value, rendered, refreshRate, minInterval,
+      pErrorOccurred, pErrorCode, errorMessage);
+}
+
+void __stdcall tsadjc_SetValues(long pResourceId, double values[], long count,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   SetValues(0, pResourceId, values, count, NULL, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_Hide(long pResourceId, short *pErrorOccurred,
+   long *pErrorCode, char errorMessage[])
+{
+   HideAdjustmentPanel(0, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_SetFilter(long pResourceId, long filterType,
+   long window, short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   SetFilter(0, pResourceId, filterType, window, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_SetTransform(long pResourceId, char transform[],
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   SetTransform(0, pResourceId, transform, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_SetHysteresis(long pResourceId, double hysteresis,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   SetHysteresis(0, pResourceId, hysteresis, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_Abort(long pResourceId, short *pErrorOccurred,
+   long *pErrorCode, char errorMessage[])
+{
+   AbortPanel(0, pResourceId, pErrorOccurred, pErrorCode, errorMessage);
+}
+
+void __stdcall tsadjc_SetGroup(long pResourceId, char groupName[],
+   long members, short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   SetGroup(0, pResourceId, groupName, members, pErrorOccurred, pErrorCode,
+      errorMessage);
+}
+
+void __stdcall tsadjc_WaitForGroup(long pResourceId, long timeout,
+   short *allConfirmed, short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   WaitForGroup(0, pResourceId, timeout, allConfirmed, pErrorOccurred,
+      pErrorCode, errorMessage);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+tsadjc_SetButtonCallback:  callback for the button of the following panels
+ *
+@param callback:    NULL -> no callback
+@param userData:    passed to the callback
+ *
+@precondition       no panel of the bench is displayed
+ *******************************************************************************/
+void __stdcall tsadjc_SetButtonCallback(long pResourceId,
+   TSADJC_BUTTON_CALLBACK callback, void *userData, short *pErrorOccurred,
+   long *pErrorCode, char errorMessage[])
+{
+   BENCH_STRUCT *pBench = NULL;
+
+   pBench = GetBench(0, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+   if (! *pErrorOccurred)
+   {
+      pBench->threadData.pUserData = userData;
+      pBench->threadData.pButtonCallback = callback;
+   }
+
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PanelThread:  runs the panel and releases the reference to the DLL taken
+by its creator as the last action of the thread
+ *******************************************************************************/
+static DWORD WINAPI PanelThread(LPVOID data)
+{
+   StartThreadForAdjustmentPanel(data);
+   FreeLibraryAndExitThread(ghInstance, 0);
+   return 0;
+}
+
+int StartThreadForAdjustmentPanel(void *data)
+{
+
+   ThreadData *threadData = (ThreadData*) data;
+   PANEL_COMMAND command;
+   double dLoopStart;
+   double dNow;
+   int iRunning = TRUE;
+   int iShown;
+   int idx;
+   
+   CoInitializeEx(NULL, COINIT_MULTITHREADED);
+
+   //  CoInitializeEx() is not declared in objbase.h which ships with CVI 5.0.
+   //  You will need to declare this function yourself using the following declaration:
+   //  WINOLEAPI  CoInitializeEx(LPVOID pvReserved, DWORD dwCoInit);
+
+   //  You must also use objbase.lib which ships with VC++ 5.0.
+
+
+   // Build the panel from the layout compiled into the DLL, no UIR file
+   if ((threadData->iPanel = CreateAdjustmentPanel()) < 0)
+   {
+      threadData->iPanel = 0;
+      return  - 1;
+   }
+
+   /* shown by PANELQUEUE_CMD_SHOW once it is set up */
+   
+   //SetPanelAttribute(giActualPanelHandle, ATTR_TITLE, cLastNameOfStep);
+   //SetCtrlAttribute(panelHandle, PANEL_INFO, ATTR_CTRL_VAL, cTextMessageIntern);
+   //GetCtrlAttribute (giActualPanelHandle, OP_SINGLE_TESTCASEPATHWAY, ATTR_VISIBLE_LINES, &giVisibleLines);
+   
+   /*SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_REPORT, ATTR_OFF_COLOR, VAL_PANEL_GRAY);
+   SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_TICKET, ATTR_OFF_COLOR, VAL_PANEL_GRAY);
+   SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_YIELD, ATTR_OFF_COLOR, VAL_PANEL_GRAY);
+   SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_REPORT, ATTR_ON_COLOR, VAL_DK_GREEN);
+   SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_TICKET, ATTR_ON_COLOR, VAL_DK_GREEN);
+   SetCtrlAttribute (giActualPanelHandle, OP_SINGLE_YIELD, ATTR_ON_COLOR, VAL_DK_GREEN);   */
+
+   // Use thread data in callbacks
+   SetCtrlAttribute(threadData->iPanel, ADJUSTMENT_OK, ATTR_CALLBACK_DATA, data);
+   
+   /* hReady is set by PANELQUEUE_CMD_SHOW */
+
+   /* user interface events and the commands of the library */
+   while (iRunning)
+   {
+      MsgWaitForMultipleObjects(1, &threadData->queue.hWake, FALSE, INFINITE,
+         QS_ALLINPUT);
+      /* the events draw the values of the last pass */
+      dLoopStart = Metrics_TimeStamp();
+      ProcessSystemEvents();
+      iShown = 0;
+      for (idx = 0; iRunning && (idx < PANELQUEUE_SIZE)
+         && PanelQueue_Pop(&threadData->queue, &command); idx++)
+      {
+         /* how late the loop gets to the command */
+         dNow = Metrics_TimeStamp();
+         Metrics_SharedLatency(threadData->pQueueDelay,
+            dNow - command.dQueued);
+         AddToMean(&threadData->dQueueLag, dNow - command.dQueued);
+         if (command.iCommand == PANELQUEUE_CMD_VALUE)
+         {
+            /* a new value on the indicator */
+            if (threadData->dLastRedraw > 0.0)
+            {
+               AddToMean(&threadData->dRedrawInterval, dNow
+                  - threadData->dLastRedraw);
+            }
+            threadData->dLastRedraw = dNow;
+            iShown++;
+         }
+         iRunning = ExecutePanelCommand(threadData, &command);
+      }
+      if (iShown > 0)
+      {
+         AddToMean(&threadData->dRedrawCost, (Metrics_TimeStamp()
+            - dLoopStart) / iShown);
+      }
+      if (idx == PANELQUEUE_SIZE)
+      {
+         /* more to come, let the events in first */
+         SetEvent(threadData->queue.hWake);
+      }
+   }
+
+   /* the references of the Display belong to the bench, see SetExecution */
+   DiscardPanel(threadData->iPanel);
+   threadData->iPanel = 0;
+   Error: return 0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ExecutePanelCommand:  runs one command of the queue in the panel thread
+ *
+@return             FALSE for PANELQUEUE_CMD_QUIT
+ *******************************************************************************/
+static int ExecutePanelCommand(ThreadData *threadData, const PANEL_COMMAND
+   *pCommand)
+{
+   int iPanel = threadData->iPanel;
+
+   switch (pCommand->iCommand)
+   {
+      case PANELQUEUE_CMD_CONFIGURE:
+         ConfigureAdjustmentPanel(iPanel, &pCommand->data.display);
+         break;
+
+      case PANELQUEUE_CMD_SHOW:
+         /* the first paint has the latest value, not the first one */
+         ApplyPendingCommands(threadData);
+         DisplayPanel(iPanel);
+         threadData->dShownTime = Metrics_TimeStamp();
+         // Signal main thread that the panel is shown
+         SetEvent(threadData->hReady);
+         break;
+
+      case PANELQUEUE_CMD_HIDE:
+         HidePanel(iPanel);
+         break;
+
+      case PANELQUEUE_CMD_VALUE:
+         SetCtrlVal(iPanel, pCommand->iCtrl, pCommand->dValue);
+         break;
+
+      case PANELQUEUE_CMD_TEXT:
+         SetCtrlVal(iPanel, pCommand->iCtrl, pCommand->data.cText);
+         break;
+
+      case PANELQUEUE_CMD_ATTRIBUTE:
+         SetCtrlAttribute(iPanel, pCommand->iCtrl, pCommand->iAttribute,
+            pCommand->iValue);
+         break;
+
+      case PANELQUEUE_CMD_SCALE:
+         /* old and new range share the centre, so both orders are valid */
+         SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_MIN_VALUE,
+            pCommand->dValue);
+         SetCtrlAttribute(iPanel, ADJUSTMENT_INDICATOR, ATTR_MAX_VALUE,
+            pCommand->dMaximum);
+         break;
+
+      case PANELQUEUE_CMD_PRESS:
+         /* the same way as a click, without its message time */
+         CallCtrlCallback(iPanel, ADJUSTMENT_OK, EVENT_COMMIT,
+            ADJUSTMENT_SIMULATED_PRESS, 0, NULL);
+         break;
+
+      case PANELQUEUE_CMD_QUIT:
+         return FALSE;
+
+      default:
+         break;
+   }
+   return TRUE;
+}
+
+
+
+/* FUNCTION *******************************************************************/
+/**
+ApplyPendingCommands:  runs the commands SetValue kept before the panel was
+                       shown, later values are queued
+ *******************************************************************************/
+static void ApplyPendingCommands(ThreadData *threadData)
+{
+   int idx;
+
+   PanelView_ClosePending(&threadData->lPending);
+   for (idx = 0; idx < threadData->iPendingCount; idx++)
+   {
+      ExecutePanelCommand(threadData, &threadData->pending[idx]);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+JoinGroup:  makes the next panel a member of the group of the bench
+ *
+@return             FALSE if the bench is a member of the open round already
+                    or the round is full, the panel is in no group then
+@precondition       no panel thread of the bench is running
+ *******************************************************************************/
+static int JoinGroup(BENCH_STRUCT *pBench)
+{
+   pBench->threadData.pBarrier = NULL;
+   pBench->threadData.lBarrierConfirmed = FALSE;
+   if (pBench->pGroup == NULL)
+   {
+      return TRUE;
+   }
+   if (!Barrier_Join(pBench->pGroup, pBench, pBench->lGroupMembers,
+      &pBench->threadData.lBarrierRound))
+   {
+      return FALSE;
+   }
+   pBench->threadData.pBarrier = pBench->pGroup;
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+LeaveGroup:  takes the panel of a failed Display out of its round, so the
+             next Display of the bench can join it
+ *******************************************************************************/
+static void LeaveGroup(BENCH_STRUCT *pBench)
+{
+   Barrier_Leave(pBench->threadData.pBarrier, pBench->threadData.lBarrierRound,
+      pBench, &pBench->threadData.lBarrierConfirmed);
+   pBench->threadData.pBarrier = NULL;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+AddToMean:  exponential mean of the backpressure times, the first sample
+            starts it
+ *******************************************************************************/
+static void AddToMean(volatile double *pMean, double dSample)
+{
+   if (*pMean == 0.0)
+   {
+      *pMean = dSample;
+   }
+   else
+   {
+      *pMean += TSADJ_FEEDBACK_WEIGHT * (dSample - *pMean);
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ResetFeedback:  forgets the backpressure of the last panel
+ *******************************************************************************/
+static void ResetFeedback(ThreadData *threadData)
+{
+   threadData->dRedrawCost = 0.0;
+   threadData->dRedrawInterval = 0.0;
+   threadData->dQueueLag = 0.0;
+   threadData->dLastRedraw = 0.0;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+formatError:    formats the error string.
+formats the error string.
+ *
+@precondition       --
+@postcondition      --
+@side_effects       --
+ *
+@param buffer:       points to a buffer where the error message is stored
+(size must be >= GTSL_ERROR_BUFFER_SIZE)
+@param code:         Error code
+@param resId:        Resource ID
+@param resourceName: Name of the resource cached in tsadj_Setup, may be NULL;
+                     if NULL the name is read from the resource manager
+@param benchDevice:  Name of the bench device, may be NULL
+ *
+@return             void
+ *******************************************************************************/
+static void formatError(char buffer[], int code, long resId,
+   const char *resourceName, char *benchDevice)
+{
+   char *pMsg = NULL;
+   char cName[RESMGR_MAX_NAME_LENGTH + 1] = "";
+   char tempMsg[GTSL_ERROR_BUFFER_SIZE] = "";
+   short tempOcc = FALSE;
+   long tempCode = 0;
+   int written = 0;
+   int iLow = 0;
+   int iHigh = giErrorIndexCount - 1;
+   int iMid;
+   char *pDest = buffer;
+   const char *pEnd = buffer + GTSL_ERROR_BUFFER_SIZE - 1;
+
+
+   /* find the error message for a given error code (binary search) */
+   while (iLow <= iHigh)
+   {
+      iMid = (iLow + iHigh) / 2;
+      if (gpErrorIndex[iMid]->value < code)
+      {
+         iLow = iMid + 1;
+      }
+      else
+      {
+         /* keep searching left, the first entry of a code wins */
+         if (gpErrorIndex[iMid]->value == code)
+         {
+            pMsg = gpErrorIndex[iMid]->string;
+         }
+         iHigh = iMid - 1;
+      }
+   }
+   if (pMsg == NULL)
+   {
+      /* should never happen */
+      pMsg = "(no message available for this code)";
+   }
+
+   /* setup the error message in one pass, truncated to the buffer size */
+
+   /* 1) Library name */
+   pDest = AppendText(pDest, pEnd, GTSL_ERRMSG_PREFIX_LIBRARY);
+   pDest = AppendText(pDest, pEnd, LIBRARY_NAME);
+   pDest = AppendText(pDest, pEnd, "\n");
+
+   /* 2) Bench name, only if a valid ID is given */
+   if ((resourceName == NULL) && (resId != RESMGR_INVALID_ID))
+   {
+      /* read the resource name into a local buffer */
+      RESMGR_Get_Resource_Name(0, resId, cName, sizeof(cName),
+         &written, &tempOcc, &tempCode, tempMsg);
+      if ((!tempOcc) && (written > 0))
+      {
+         resourceName = cName;
+      }
+   }
+   if ((resourceName != NULL) && (resourceName[0] != '\0'))
+   {
+      /* append the name */
+      pDest = AppendText(pDest, pEnd, GTSL_ERRMSG_PREFIX_BENCH);
+      pDest = AppendText(pDest, pEnd, resourceName);
+      pDest = AppendText(pDest, pEnd, "\n");
+   }
+
+   /* 3) Bench device, if given */
+   if (benchDevice != NULL)
+   {
+      pDest = AppendText(pDest, pEnd, GTSL_ERRMSG_PREFIX_BENCH_DEVICE);
+      pDest = AppendText(pDest, pEnd, benchDevice);
+      pDest = AppendText(pDest, pEnd, "\n");
+   }
+
+   /* 4) Error message */
+   pDest = AppendText(pDest, pEnd, GTSL_ERRMSG_PREFIX_ERRMSG);
+   pDest = AppendText(pDest, pEnd, pMsg);
+   *pDest = '\0';
+}
+
+/* FUNCTION *******************************************************************/
+/**
+AppendText:  copies a string without the terminating zero
+ *
+@param pDest:  write position
+@param pEnd:   first position which must not be written
+@param pText:  string to copy
+ *
+@return        new write position
+ *******************************************************************************/
+static char *AppendText(char *pDest, const char *pEnd, const char *pText)
+{
+   while ((pDest < pEnd) && (*pText != '\0'))
+   {
+      *pDest++ = *pText++;
+   }
+   return pDest;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+EnsureInitialized:  initializes the library on the first call of any
+exported function
+ *
+The first caller runs InitializeLibrary, concurrent callers wait until it
+has finished. Nothing of this runs under the loader lock of DllMain.
+ *
+@return             TRUE if the library can be used, otherwise the error
+                    triple is set
+ *******************************************************************************/
+static int EnsureInitialized(short *pErrorOccurred, long *pErrorCode,
+   char errorMessage[])
+{
+   if (glInitState != TSADJ_INIT_DONE)
+   {
+      if (InterlockedCompareExchange(&glInitState, TSADJ_INIT_RUNNING,
+         TSADJ_INIT_NONE) == TSADJ_INIT_NONE)
+      {
+         giInitialized = InitializeLibrary();
+         InterlockedExchange(&glInitState, TSADJ_INIT_DONE);
+      }
+      else
+      {
+         while (glInitState != TSADJ_INIT_DONE)
+         {
+            Sleep(0);
+         }
+      }
+   }
+   if (!giInitialized)
+   {
+      *pErrorOccurred = TRUE;
+      *pErrorCode = TSPAN_ERR_INITIALIZE;
+      formatError(errorMessage,  *pErrorCode, RESMGR_INVALID_ID, "", NULL);
+   }
+   return giInitialized;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+InitializeLibrary:  work formerly done on DLL_PROCESS_ATTACH, runs once
+ *
+@return             TRUE on success
+ *******************************************************************************/
+static int InitializeLibrary(void)
+{
+   /* first, so errors can be formatted in any case */
+   BuildErrorIndex();
+   InitializeCriticalSection(&CriticalSection);
+   InitializeCriticalSection(&PoolCriticalSection);
+   Telemetry_Initialize();
+   Recorder_Initialize();
+   Barrier_Initialize();
+   Metrics_Initialize();
+
+   /* Needed if linking in external compiler; harmless otherwise */
+   if (InitCVIRTE(ghInstance, 0, 0) == 0)
+   {
+      return FALSE;
+   }
+   giCVIRTEInitialized = TRUE;
+
+   //GetModuleDir(__CVIUserHInst, cDLLPATH);
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+BuildErrorIndex:  sorts pointers to the errorTable entries by error code,
+called once by InitializeLibrary
+ *******************************************************************************/
+static void BuildErrorIndex(void)
+{
+   GTSL_ERROR_ENTRY *pErr = errorTable;
+
+   giErrorIndexCount = 0;
+   while (pErr->string != NULL)
+   {
+      gpErrorIndex[giErrorIndexCount++] = pErr;
+      pErr++;
+   }
+   qsort(gpErrorIndex, giErrorIndexCount, sizeof(gpErrorIndex[0]),
+      CompareErrorEntries);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+CompareErrorEntries:  qsort callback, orders by code and for equal codes by
+the position in errorTable
+ *******************************************************************************/
+static int CompareErrorEntries(const void *pLeft, const void *pRight)
+{
+   const GTSL_ERROR_ENTRY *pL = *(const GTSL_ERROR_ENTRY * const *)pLeft;
+   const GTSL_ERROR_ENTRY *pR = *(const GTSL_ERROR_ENTRY * const *)pRight;
+
+   if (pL->value != pR->value)
+   {
+      return (pL->value < pR->value) ? -1 : 1;
+   }
+   return (pL < pR) ? -1 : ((pL > pR) ? 1 : 0);
+}
+
+
+/* FUNCTION *******************************************************************/
+/**
+GetUUTSerialNumber:  reads the serial number of the UUT under test
+ *
+@param sequenceContext: TestStand sequence context
+@param cSerial:         buffer for the serial number
+@param iSize:           size of the buffer
+ *
+@return                 void, TSADJ_NO_SERIAL if the sequence has no UUT
+ *******************************************************************************/
+static void GetUUTSerialNumber(CAObjHandle sequenceContext, char cSerial[],
+   int iSize)
+{
+   ERRORINFO errorInfo;
+   char *pSerial = NULL;
+
+   strcpy(cSerial, TSADJ_NO_SERIAL);
+   if (sequenceContext && (TS_PropertyGetValString(sequenceContext,
+      &errorInfo, TSADJ_UUT_SERIAL, TS_PropOption_NoOptions, &pSerial) >= 0))
+   {
+      if ((pSerial != NULL) && (pSerial[0] != '\0'))
+      {
+         strncpy(cSerial, pSerial, iSize - 1);
+         cSerial[iSize - 1] = '\0';
+      }
+   }
+   if (pSerial != NULL)
+   {
+      CA_FreeMemory(pSerial);
+   }
+}
+
+
+/* FUNCTION *******************************************************************/
+/**
+SetNumberProperty:  writes <pProperty>.<pName>, inserted if missing
+ *
+@return             HRESULT of the TestStand call
+ *******************************************************************************/
+static HRESULT SetNumberProperty(CAObjHandle sequenceContext,
+   const char *pProperty, const char *pName, double dValue)
+{
+   char cLookup[1024];
+   ERRORINFO errorInfo;
+
+   sprintf(cLookup, "%.900s.%.100s", pProperty, pName);
+   return TS_PropertySetValNumber(sequenceContext, &errorInfo, cLookup,
+      TS_PropOption_InsertIfMissing, dValue);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+SetLatencyProperties:  writes Count, MeanMs, MinMs and MaxMs of a call
+latency accumulator below <pProperty>.<pName>
+ *
+@return                HRESULT of the first failing TestStand call
+ *******************************************************************************/
+static HRESULT SetLatencyProperties(CAObjHandle sequenceContext,
+   const char *pProperty, const char *pName, const METRICS_LATENCY *pLatency)
+{
+   char cName[128];
+   HRESULT hResult;
+
+   sprintf(cName, "%.100s.Count", pName);
+   hResult = SetNumberProperty(sequenceContext, pProperty, cName,
+      pLatency->lCount);
+   if (hResult >= 0)
+   {
+      sprintf(cName, "%.100s.MeanMs", pName);
+      hResult = SetNumberProperty(sequenceContext, pProperty, cName,
+         (pLatency->lCount > 0) ? 1000.0 * pLatency->dSum / pLatency->lCount
+         : 0.0);
+   }
+   if (hResult >= 0)
+   {
+      sprintf(cName, "%.100s.MinMs", pName);
+      hResult = SetNumberProperty(sequenceContext, pProperty, cName,
+         1000.0 * pLatency->dMin);
+   }
+   if (hResult >= 0)
+   {
+      sprintf(cName, "%.100s.MaxMs", pName);
+      hResult = SetNumberProperty(sequenceContext, pProperty, cName,
+         1000.0 * pLatency->dMax);
+   }
+   return hResult;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+PublishResult:  writes the result of the current panel as a number array
+ *
+Every TestStand call is a round trip to the sequence, the array takes one
+call for all elements. The order of the elements is given by STEPRESULT_xxx.
+ *
+@param pProperty:   lookup string of the array, inserted if missing
+@param dTime:       time stamp the time in the limits counts up to
+ *
+@return             HRESULT of the TestStand call
+ *******************************************************************************/
+static HRESULT PublishResult(CAObjHandle sequenceContext,
+   const BENCH_STRUCT *pBench, const char *pProperty, double dTime)
+{
+   double dFields[STEPRESULT_FIELDS];
+   ERRORINFO errorInfo;
+   VARIANT variant;
+   HRESULT hResult;
+
+   StepResult_Get(&pBench->result, dTime, pBench->dDisplayEnd,
+      (pBench->pPanelClient != NULL) ? pBench->dButtonHit
+      : pBench->threadData.dButtonTime, dFields);
+   hResult = CA_VariantSet1DArray(&variant, CAVT_DOUBLE, STEPRESULT_FIELDS,
+      dFields);
+   if (hResult >= 0)
+   {
+      hResult = TS_PropertySetValVariant(sequenceContext, &errorInfo,
+         pProperty, TS_PropOption_InsertIfMissing, variant);
+      CA_VariantClear(&variant);
+   }
+   return hResult;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+GetIniWriteTime:  last write time of the INI file a pooled bench depends on
+ *
+@return           TRUE if the time could be read
+ *******************************************************************************/
+static int GetIniWriteTime(const char *pIniFile, FILETIME *pWriteTime)
+{
+   WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+   if ((pIniFile == NULL) || (pIniFile[0] == '\0')
+      || !GetFileAttributesEx(pIniFile, GetFileExInfoStandard, &attributes))
+   {
+      return FALSE;
+   }
+   *pWriteTime = attributes.ftLastWriteTime;
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ReturnToPool:  marks a pooled bench as idle
+ *
+@return        TRUE if the resource was found in the pool
+ *******************************************************************************/
+static int ReturnToPool(long lResourceId)
+{
+   int iFound = FALSE;
+   int idx;
+
+   EnterCriticalSection(&PoolCriticalSection);
+   for (idx = 0; idx < giPoolCount; idx++)
+   {
+      if (gPool[idx].lResourceId == lResourceId)
+      {
+         gPool[idx].iInUse = FALSE;
+         iFound = TRUE;
+         break;
+      }
+   }
+   LeaveCriticalSection(&PoolCriticalSection);
+
+   return iFound;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ResetConfiguration:  undoes what the UUT before has configured on a pooled
+bench, the next one starts like after tsadj_Setup with the same INI keys
+ *******************************************************************************/
+static void ResetConfiguration(BENCH_STRUCT *pBench)
+{
+   Filter_Configure(&pBench->filter, pBench->iSetupFilter,
+      pBench->iSetupWindow);
+   Transform_Compile(&pBench->transform, "");
+   pBench->view.dHysteresis = 0.0;
+   pBench->cResultProperty[0] = '\0';
+   pBench->pGroup = NULL;
+   pBench->lGroupMembers = 0;
+   pBench->threadData.pButtonCallback = NULL;
+   pBench->threadData.pUserData = NULL;
+   /* no reference to the execution of the UUT before */
+   SetExecution(pBench, NULL);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+StopPanelThread:  quits the panel thread of a bench and waits for it
+ *
+The thread discards the panel, so the bench may start the next thread at
+once. A thread that does not end is left running, the
+next Display or tsadj_Cleanup tries again.
+ *
+@param iAbortable:  TRUE -> stop waiting when the execution terminates,
+                    FALSE -> wait up to TSADJ_STOP_TIMEOUT, also for a
+                    terminated execution, e.g. in tsadj_Cleanup
+ *
+@return             TRUE if the thread has ended
+ *******************************************************************************/
+static int StopPanelThread(BENCH_STRUCT *pBench, int iAbortable)
+{
+   PANEL_COMMAND command;
+   int iWait;
+
+   // wait for the thread to complete.
+   if (iAbortable)
+   {
+      command.iCommand = PANELQUEUE_CMD_HIDE;
+      iWait = QueueCommand(pBench, &command);
+      if (iWait == TSADJ_WAIT_DONE)
+      {
+         command.iCommand = PANELQUEUE_CMD_QUIT;
+         iWait = QueueCommand(pBench, &command);
+      }
+      if (iWait == TSADJ_WAIT_DONE)
+      {
+         iWait = WaitForExecution(pBench, pBench->hThreadHandle, INFINITE);
+      }
+   }
+   else
+   {
+      /* a set abort event must not keep the thread from quitting */
+      PanelQueue_Command(&pBench->threadData.queue, PANELQUEUE_CMD_HIDE, NULL);
+      PanelQueue_Command(&pBench->threadData.queue, PANELQUEUE_CMD_QUIT, NULL);
+      iWait = (WaitForSingleObject(pBench->hThreadHandle, TSADJ_STOP_TIMEOUT)
+         == WAIT_OBJECT_0) ? TSADJ_WAIT_DONE : TSADJ_WAIT_TIMEOUT;
+   }
+   if (iWait != TSADJ_WAIT_DONE)
+   {
+      return FALSE;
+   }
+   CloseHandle(pBench->hThreadHandle);
+   pBench->hThreadHandle = NULL;
+   Metrics_ThreadJoined();
+   return TRUE;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+QueueCommand:  PanelQueue_PushWait which ends when the execution of the
+bench terminates or aborts
+ *
+Waits up to PANELQUEUE_WAIT for a free cell in slices of the abort latency,
+with the checks of WaitForExecution in between.
+ *
+@return             TSADJ_WAIT_xxx
+ *******************************************************************************/
+static int QueueCommand(BENCH_STRUCT *pBench, const PANEL_COMMAND *pCommand)
+{
+   DWORD dwWaited;
+
+   for (dwWaited = 0; dwWaited < PANELQUEUE_WAIT;
+      dwWaited += pBench->dwAbortLatency)
+   {
+      if (PanelQueue_PushWait(&pBench->threadData.queue, pCommand,
+         pBench->dwAbortLatency, pBench->hAbort))
+      {
+         return TSADJ_WAIT_DONE;
+      }
+      if (((pBench->hAbort != NULL) && (WaitForSingleObject(pBench->hAbort, 0)
+         == WAIT_OBJECT_0)) || ExecutionStopping(pBench))
+      {
+         return TSADJ_WAIT_ABORTED;
+      }
+   }
+   return TSADJ_WAIT_TIMEOUT;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+WaitForExecution:  waits for an object, or a time if it is NULL, and returns
+early when the execution of the bench terminates or aborts
+ *
+The state of the execution is checked every pBench->dwAbortLatency ms,
+tsadj_AbortAdjustmentPanel ends the wait at once.
+ *
+@return             TSADJ_WAIT_xxx
+ *******************************************************************************/
+static int WaitForExecution(BENCH_STRUCT *pBench, HANDLE hObject,
+   DWORD dwTimeout)
+{
+   HANDLE hHandles[2];
+   DWORD dwCount = 0;
+   DWORD dwStart = GetTickCount();
+   DWORD dwElapsed;
+   DWORD dwSlice;
+   DWORD dwResult;
+
+   if (hObject != NULL)
+   {
+      hHandles[dwCount++] = hObject;
+   }
+   if (pBench->hAbort != NULL)
+   {
+      hHandles[dwCount++] = pBench->hAbort;
+   }
+
+   for (;;)
+   {
+      dwSlice = pBench->dwAbortLatency;
+      if (dwTimeout != INFINITE)
+      {
+         dwElapsed = GetTickCount() - dwStart;
+         if (dwElapsed >= dwTimeout)
+         {
+            return (hObject == NULL) ? TSADJ_WAIT_DONE : TSADJ_WAIT_TIMEOUT;
+         }
+         if (dwTimeout - dwElapsed < dwSlice)
+         {
+            dwSlice = dwTimeout - dwElapsed;
+         }
+      }
+
+      if (dwCount > 0)
+      {
+         dwResult = WaitForMultipleObjects(dwCount, hHandles, FALSE, dwSlice);
+      }
+      else
+      {
+         Sleep(dwSlice);
+         dwResult = WAIT_TIMEOUT;
+      }
+      if ((hObject != NULL) && (dwResult == WAIT_OBJECT_0))
+      {
+         return TSADJ_WAIT_DONE;
+      }
+      if ((dwResult != WAIT_TIMEOUT) || ExecutionStopping(pBench))
+      {
+         /* abort event, or the handles are not valid any more */
+         return TSADJ_WAIT_ABORTED;
+      }
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ExecutionStopping:  TRUE if the execution of the last Display terminates or
+aborts
+ *******************************************************************************/
+static int ExecutionStopping(BENCH_STRUCT *pBench)
+{
+   enum TSEnum_ExecutionRunStates runState;
+   enum TSEnum_ExecutionTerminationStates termState;
+   ERRORINFO errorInfo;
+
+   if (!pBench->hExecution)
+   {
+      return FALSE;
+   }
+   if (TS_ExecutionGetStates(pBench->hExecution, &errorInfo, &runState,
+      &termState) < 0)
+   {
+      return FALSE;
+   }
+   return termState != TS_ExecTermState_Normal;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+DisplayRemotePanel:  ShowAdjustmentPanel for a bench with the "PanelServer"
+key, the panel is shown by the server process
+ *
+@param pSerial:     UUT serial number for the recorder
+ *
+@precondition       pBench->pPanelClient is connected,
+                    pBench->dDisplayStart is set
+ *******************************************************************************/
+static void DisplayRemotePanel(long lResourceId, BENCH_STRUCT *pBench,
+   char nameOfStep[], char buttonText[], char unit[], char format[],
+   double lowerLimit, double upperLimit, const char *pSerial,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   PANELIPC_DISPLAY_TEXT text;
+
+   pBench->iInLimitSeen = FALSE;
+   pBench->dButtonHit = 0.0;
+   Filter_Reset(&pBench->filter);
+   StepResult_Begin(&pBench->result);
+   PanelView_Begin(&pBench->view, lowerLimit, upperLimit, format, NULL);
+   /* the fine scale of auto zoom goes with the first value */
+   PanelView_Invalidate(&pBench->view);
+   strncpy(pBench->cStepName, nameOfStep, METRICS_STEPNAME_LENGTH - 1);
+   pBench->cStepName[METRICS_STEPNAME_LENGTH - 1] = '\0';
+
+   /* the texts are formatted here, the server only shows them */
+   PanelView_FormatText(&text, nameOfStep, buttonText, unit, format,
+      lowerLimit, upperLimit);
+
+   if (!PanelClient_Display(pBench->pPanelClient, &text, lowerLimit,
+      upperLimit, pBench->view.iFormat, pBench->view.iPrecision,
+      pBench->iDemoMode))
+   {
+      *pErrorOccurred = TRUE;
+      *pErrorCode = TSPAN_ERR_PANELSERVER;
+      formatError(errorMessage,  *pErrorCode, lResourceId,
+         pBench->cResourceName, NULL);
+      return;
+   }
+   Metrics_Add(pBench->cStepName, METRICS_PHASE_VISIBLE, Metrics_TimeStamp()
+      - pBench->dDisplayStart);
+
+   Telemetry_PublishConfig(pBench->iTelemetrySlot, nameOfStep, lowerLimit,
+      upperLimit, TELEMETRY_STATE_ACTIVE);
+   if (pBench->pRecorder != NULL)
+   {
+      Recorder_Begin(pBench->pRecorder, pSerial, nameOfStep);
+   }
+
+   pBench->dDisplayEnd = Metrics_TimeStamp();
+   Metrics_Add(pBench->cStepName, METRICS_PHASE_DISPLAY, pBench->dDisplayEnd
+      - pBench->dDisplayStart);
+   Metrics_Latency(&pBench->counters.display, pBench->dDisplayEnd
+      - pBench->dDisplayStart);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ButtonHitRemote:  sets Locals.AdjustmentPanelButtonHit and calls the button
+callback when the panel server reports the button, the same way
+AdjustmentCallback does for a local panel
+ *******************************************************************************/
+static void ButtonHitRemote(BENCH_STRUCT *pBench, int iButtonHit)
+{
+   ERRORINFO errorInfo;
+
+   if (iButtonHit && (pBench->dButtonHit == 0.0))
+   {
+      pBench->dButtonHit = Metrics_TimeStamp();
+      Barrier_Confirm(pBench->threadData.pBarrier,
+         pBench->threadData.lBarrierRound,
+         &pBench->threadData.lBarrierConfirmed);
+      /* the context of a TestStand Display, see SetExecution */
+      if (pBench->threadData.ThisContext)
+      {
+         TS_PropertySetValBoolean(pBench->threadData.ThisContext, &errorInfo,
+            TSADJ_BUTTON_HIT, TS_PropOption_InsertIfMissing, VTRUE);
+      }
+      if (pBench->threadData.pButtonCallback != NULL)
+      {
+         pBench->threadData.pButtonCallback(pBench->threadData.lResourceId,
+            pBench->threadData.pUserData);
+      }
+   }
+}
+
+
+/* FUNCTION *******************************************************************/
+/**
+SetExecution:  replaces the references of the last Display of a bench
+ *
+The bench keeps the execution for the termination checks and the sequence
+context for Locals.AdjustmentPanelButtonHit until the next Display or
+Cleanup. The panel thread uses the context, it must have ended.
+ *
+@param pRefs:       references the bench takes over, set to 0 in *pRefs;
+                    NULL -> none, e.g. for a plain C caller
+ *******************************************************************************/
+static void SetExecution(BENCH_STRUCT *pBench, EXECUTION_REFS *pRefs)
+{
+   if (pBench->hExecution)
+   {
+      CA_DiscardObjHandle(pBench->hExecution);
+      pBench->hExecution = 0;
+   }
+   if (pBench->threadData.ThisContext)
+   {
+      CA_DiscardObjHandle(pBench->threadData.ThisContext);
+      pBench->threadData.ThisContext = 0;
+   }
+   if (pRefs != NULL)
+   {
+      pBench->hExecution = pRefs->hExecution;
+      pBench->threadData.ThisContext = pRefs->hContext;
+      pRefs->hExecution = 0;
+      pRefs->hContext = 0;
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+GetBench:  memory block of a resource ID of this library
+ *
+@return             NULL with the error triple set
+ *******************************************************************************/
+static BENCH_STRUCT *GetBench(CAObjHandle sequenceContext, long lResourceId,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   BENCH_STRUCT *pBench = NULL;
+
+   if (!EnsureInitialized(pErrorOccurred, pErrorCode, errorMessage))
+   {
+      return NULL;
+   }
+   RESMGR_Get_Mem_Ptr(sequenceContext, lResourceId, (void **)(&pBench),
+      pErrorOccurred, pErrorCode, errorMessage);
+   if ((! *pErrorOccurred) && (pBench->iOwner != TSPAN_ERR_BASE))
+   {
+      *pErrorOccurred = TRUE;
+      *pErrorCode = GTSL_ERR_WRONG_RESOURCE_ID;
+      formatError(errorMessage,  *pErrorCode, lResourceId, NULL, NULL);
+   }
+   return *pErrorOccurred ? NULL : pBench;
+}
+
+/* FUNCTION *******************************************************************/
+/**
+DisplayFromTestStand:  tsadj_DisplayAdjustmentPanel and
+                       tsadj_DisplayAdjustmentPanelAsync
+ *
+ShowAdjustmentPanel with the references of the execution; those the bench
+has not taken over, e.g. after an error, are discarded.
+ *******************************************************************************/
+static void DisplayFromTestStand(CAObjHandle sequenceContext,
+   long pResourceId, char nameOfStep[], char buttonText[], char unit[],
+   char format[], double lowerLimit, double upperLimit, int iAsync,
+   short *pErrorOccurred, long *pErrorCode, char errorMessage[])
+{
+   EXECUTION_REFS refs;
+   BENCH_STRUCT *pBench;
+
+   memset(&refs, 0, sizeof(refs));
+   strcpy(refs.cSerial, TSADJ_NO_SERIAL);
+   pBench = GetBench(sequenceContext, pResourceId, pErrorOccurred, pErrorCode,
+      errorMessage);
+   if (! *pErrorOccurred)
+   {
+      AttachExecution(sequenceContext, pBench, &refs, pErrorOccurred,
+         pErrorCode, errorMessage);
+   }
+   if (! *pErrorOccurred)
+   {
+      ShowAdjustmentPanel(sequenceContext, pResourceId, nameOfStep,
+         buttonText, unit, format, lowerLimit, upperLimit, iAsync, &refs,
+         pErrorOccurred, pErrorCode, errorMessage);
+   }
+   ReleaseExecution(&refs);
+}
+
+/* FUNCTION *******************************************************************/
+/**
+AttachExecution:  takes the references a TestStand Display hands to the
+bench, see SetExecution
+ *
+The execution is checked for termination by the waits, the context gets
+Locals.AdjustmentPanelButtonHit from the panel thread, so both need
+references of their own. The UUT serial number is only read for the
+recorder.
+ *******************************************************************************/
+static void AttachExecution(CAObjHandle sequenceContext,
+   const BENCH_STRUCT *pBench, EXECUTION_REFS *pRefs, short *pErrorOccurred,
+   long *pErrorCode, char errorMessage[])
+{
+   ERRORINFO errorInfo;
+   LPDISPATCH pContextDispatch = NULL;
+   HRESULT hResult;
+
+   //Get teststand executon reference
+   hResult = TS_SeqContextGetProperty(sequenceContext, &errorInfo,
+      TS_SeqContextExecution, CAVT_OBJHANDLE, &pRefs->hExecution);
+   // add a reference to the ThisContext activeX automation object
+   if (hResult >= 0)
+   {
+      hResult = CA_GetDispatchFromObjHandle(sequenceContext,
+         &pContextDispatch);
+   }
+   if (hResult >= 0)
+   {
+      hResult = CA_CreateObjHandleFromIDispatch(pContextDispatch, 1,
+         &pRefs->hContext);
+   }
+   if (hResult < 0)
+   {
+      *pErrorOccurred = TRUE;
+      *pErrorCode = hResult;
+      CA_GetAutomationErrorString(hResult, errorMessage, 1024);
+   }
+   else if (pBench->pRecorder != NULL)
+   {
+      GetUUTSerialNumber(sequenceContext, pRefs->cSerial,
+         sizeof(pRefs->cSerial));
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+ReleaseExecution:  discards the references of AttachExecution the bench has
+not taken over
+ *******************************************************************************/
+static void ReleaseExecution(EXECUTION_REFS *pRefs)
+{
+   if (pRefs->hExecution)
+   {
+      CA_DiscardObjHandle(pRefs->hExecution);
+      pRefs->hExecution = 0;
+   }
+   if (pRefs->hContext)
+   {
+      CA_DiscardObjHandle(pRefs->hContext);
+      pRefs->hContext = 0;
+   }
+}
+
+/* FUNCTION *******************************************************************/
+/**
+RecordResult:  limit decision of a SetValue call for telemetry, recorder,
+               step result and the time to the limits, called by
+               PanelView_SetValue
+ *
+@param pContext:    the BENCH_STRUCT
+@param dTime:       time stamp of the call
+ *******************************************************************************/
+static void RecordResult(void *pContext, const PANELVIEW_READING *pReading,
+   double dTime)
+{
+   BENCH_STRUCT *pBench = (BENCH_STRUCT *) pContext;
+
+   Telemetry_PublishValue(pBench->iTelemetrySlot, pReading->dValue,
+      pReading->iPassed);
+   Recorder_Append(pBench->pRecorder, pReading->dValue, pReading->dRawValue,
+      pReading->iPassed);
+   StepResult_Add(&pBench->result, dTime, pReading->dValue,
+      pReading->iPassed);
+   if (pReading->iPassed && !pBench->iInLimitSeen)
+   {
+      pBench->iInLimitSeen = TRUE;
+      Metrics_Add(pBench->cStepName, METRICS_PHASE_IN_LIMIT,
+         Metrics_TimeStamp() - pBench->dDisplayEnd);
+   }
+}
+
@@ -1,99 +1,213 @@
-
-/*******************************************************************************/
-/**
-@file tspan.h
-*
-@brief Exported function declaration
-*
-@version 1.0.0.0
-*
-@author Robert Renner <A HREF="mailto:robert.renner@spectral.de">robert.renner@spectral.de</A>\n
-&copy; Spectral Electronic Forschungs- und Produktions GmbH - Berlin \n \n
-language: ANSI-C ISO/IEC9899:1990
-*
-<b>History:</b>
-- <b>23.11.2007 R. Renner</b>
-- Initial revision
-
-******************************************************************************
-*****************************************************************************/
-#ifndef TSADJ_H
-#define TSADJ_H
-
-/* INCLUDE FILES ***************************************************************/
-#include <cvidef.h>
-#include "gtslerr.h"   /* GTSL error handling */
-#include "testadjustmentpanel.h"
-#include <cvirte.h>
-
-#include <windows.h>
-#include <objbase.h>
-
-#include <utility.h>
-#include <userint.h>
-
-
-#include <ansi_c.h>
-#include <tsapicvi.h>
-//#include "lc.h"
-#include "toolbox.h"
-#include <formatio.h>
-#include <analysis.h>
-#include <resmgr.h>
-
-#include "definitions.h"
-#include "testadjustmentpanel.h"
-#include "hrestim.h" 
-
-/* EXPORT */
-
-
-
-/* GLOBAL TYPE DECLARATIONS ***************************************************/
-
-/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
-
-/* Error codes */
-/* User-specific error code region */
-#define TSPAN_ERR_BASE                          -1004000
-#define TSPAN_ERR_NOT_A_BENCH                   (TSPAN_ERR_BASE - 1)    /* -1004001 */
-#define TSPAN_ERR_THREADWASNOTSTARTET           (TSPAN_ERR_BASE - 2)    /* -1004002 */
-#define TSPAN_ERR_WRONGFORMATYTE                (TSPAN_ERR_BASE - 3)    /* -1004003 */
-
-/* GLOBAL VARIABLE DECLARATIONS ***********************************************/
-
-/* GLOBAL MACRO DEFINITIONS ***************************************************/
-
-/* EXPORTED FUNCTIONS *********************************************************/
-
-void __stdcall tsadj_Setup (CAObjHandle sequenceContext, char *benchName,
-                           long *resourceID, short *errorOccurred,
-                           long *errorCode, char errorMessage[]);
-
-
-void __stdcall tsadj_DisplayAdjustmentPanel (CAObjHandle sequenceContext,
-                                            long resourceID, char nameOfStep[], char buttonText[],
-                                            char unit[], char compType[],
-                                            char format[], double lowerLimit,
-                                            double upperLimit, short AlwaysOnTop,
-                                            short *errorOccurred,
-                                            long *errorCode, char errorMessage[]);
-
-void __stdcall tsadj_SetValueAdjustmentPanel (CAObjHandle sequenceContext,
-                                             long resourceID, double value,
-                                             short *errorOccurred,
-                                             long *errorCode,
-                                             char errorMessage[]);
-
-void __stdcall tsadj_HideAdjustmentPanel (CAObjHandle sequenceContext,
-                                         long resourceID, short *errorOccurred,
-                                         long *errorCode, char errorMessage[]);
-
-void __stdcall  tsadj_Cleanup (CAObjHandle sequenceContext, long resourceID,
-                             short *errorOccurred, long *errorCode,
-                             char errorMessage[]);
-
-#endif   /* do not add code after this line */
-/******************************************************************************/
-/* END OF FILE                                                                */
-/******************************************************************************/
+
+/*******************************************************************************/
+/**
+@file tspan.h
+*
+@brief Exported function declaration
+*
+@version 1.0.0.0
+*
+@author Robert Renner <A HREF="mailto:robert.renner@spectral.de">robert.renner@spectral.de</A>\n
+&copy; Spectral Electronic Forschungs- und Produktions GmbH - Berlin \n \n
+language: ANSI-C ISO/IEC9899:1990
+*
+<b>History:</b>
+- <b>23.11.2007 R. Renner</b>
+- Initial revision
+
+******************************************************************************
+*****************************************************************************/
+#ifndef TSADJ_H
+#define TSADJ_H
+
+/* INCLUDE FILES ***************************************************************/
+#include <cvidef.h>
+#include "gtslerr.h"   /* GTSL error handling */
+#include "testadjustmentpanel.h"
+#include <cvirte.h>
+
+#include <windows.h>
+#include <objbase.h>
+
+#include <utility.h>
+#include <userint.h>
+
+
+#include <ansi_c.h>
+#include <tsapicvi.h>
+//#include "lc.h"
+#include "toolbox.h"
+#include <formatio.h>
+#include <analysis.h>
+#include <resmgr.h>
+
+#include "definitions.h"
+#include "testadjustmentpanel.h"
+#include "hrestim.h" 
+
+/* EXPORT */
+
+
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+/* Error codes */
+/* User-specific error code region */
+#define TSPAN_ERR_BASE                          -1004000
+#define TSPAN_ERR_NOT_A_BENCH                   (TSPAN_ERR_BASE - 1)    /* -1004001 */
+#define TSPAN_ERR_THREADWASNOTSTARTET           (TSPAN_ERR_BASE - 2)    /* -1004002 */
+#define TSPAN_ERR_WRONGFORMATYTE                (TSPAN_ERR_BASE - 3)    /* -1004003 */
+#define TSPAN_ERR_PANELSERVER                   (TSPAN_ERR_BASE - 4)    /* -1004004 */
+#define TSPAN_ERR_FILTER                        (TSPAN_ERR_BASE - 5)    /* -1004005 */
+#define TSPAN_ERR_TRANSFORM                     (TSPAN_ERR_BASE - 6)    /* -1004006 */
+#define TSPAN_ERR_INITIALIZE                    (TSPAN_ERR_BASE - 7)    /* -1004007 */
+#define TSPAN_ERR_ABORTED                       (TSPAN_ERR_BASE - 8)    /* -1004008 */
+#define TSPAN_ERR_GROUP                         (TSPAN_ERR_BASE - 9)    /* -1004009 */
+#define TSPAN_ERR_PANELTHREAD                   (TSPAN_ERR_BASE - 10)   /* -1004010 */
+#define TSPAN_ERR_GROUPROUND                    (TSPAN_ERR_BASE - 11)   /* -1004011 */
+#define TSPAN_ERR_PANELTIMEOUT                  (TSPAN_ERR_BASE - 12)   /* -1004012 */
+
+/* Filter types of tsadj_SetFilter */
+#define TSADJ_FILTER_NONE                       0
+#define TSADJ_FILTER_EMA                        1
+#define TSADJ_FILTER_MEAN                       2
+#define TSADJ_FILTER_MEDIAN                     3
+
+/* GLOBAL VARIABLE DECLARATIONS ***********************************************/
+
+/* GLOBAL MACRO DEFINITIONS ***************************************************/
+
+/* EXPORTED FUNCTIONS *********************************************************/
+
+void __stdcall tsadj_Setup (CAObjHandle sequenceContext, char *benchName,
+                           long *resourceID, short *errorOccurred,
+                           long *errorCode, char errorMessage[]);
+
+
+void __stdcall tsadj_DisplayAdjustmentPanel (CAObjHandle sequenceContext,
+                                            long resourceID, char nameOfStep[], char buttonText[],
+                                            char unit[], char compType[],
+                                            char format[], double lowerLimit,
+                                            double upperLimit, short AlwaysOnTop,
+                                            short *errorOccurred,
+                                            long *errorCode, char errorMessage[]);
+
+void __stdcall tsadj_DisplayAdjustmentPanelAsync (CAObjHandle sequenceContext,
+                                                 long resourceID,
+                                                 char nameOfStep[],
+                                                 char buttonText[],
+                                                 char unit[], char compType[],
+                                                 char format[],
+                                                 double lowerLimit,
+                                                 double upperLimit,
+                                                 short AlwaysOnTop,
+                                                 short *errorOccurred,
+                                                 long *errorCode,
+                                                 char errorMessage[]);
+
+void __stdcall tsadj_WaitForAdjustmentPanel (CAObjHandle sequenceContext,
+                                            long resourceID, long timeout,
+                                            short *errorOccurred,
+                                            long *errorCode,
+                                            char errorMessage[]);
+
+void __stdcall tsadj_SetValueAdjustmentPanel (CAObjHandle sequenceContext,
+                                             long resourceID, double value,
+                                             short *errorOccurred,
+                                             long *errorCode,
+                                             char errorMessage[]);
+
+void __stdcall tsadj_SetValueAdjustmentPanelEx (CAObjHandle sequenceContext,
+                                               long resourceID, double value,
+                                               short *rendered,
+                                               double *refreshRate,
+                                               double *minInterval,
+                                               short *errorOccurred,
+                                               long *errorCode,
+                                               char errorMessage[]);
+
+void __stdcall tsadj_SetValuesAdjustmentPanel (CAObjHandle sequenceContext,
+                                              long resourceID, double values[],
+                                              long count, short *errorOccurred,
+                                              long *errorCode,
+                                              char errorMessage[]);
+
+void __stdcall tsadj_HideAdjustmentPanel (CAObjHandle sequenceContext,
+                                         long resourceID, short *errorOccurred,
+                                         long *errorCode, char errorMessage[]);
+
+void __stdcall  tsadj_Cleanup (CAObjHandle sequenceContext, long resourceID,
+                             short *errorOccurred, long *errorCode,
+                             char errorMessage[]);
+
+void __stdcall tsadj_SetupPooled (CAObjHandle sequenceContext, char *benchName,
+                                 char *iniFile, long *resourceID,
+                                 short *errorOccurred, long *errorCode,
+                                 char errorMessage[]);
+
+void __stdcall tsadj_FlushPool (CAObjHandle sequenceContext,
+                               short *errorOccurred, long *errorCode,
+                               char errorMessage[]);
+
+void __stdcall tsadj_SetFilter (CAObjHandle sequenceContext, long resourceID,
+                               long filterType, long window,
+                               short *errorOccurred, long *errorCode,
+                               char errorMessage[]);
+
+void __stdcall tsadj_SetTransform (CAObjHandle sequenceContext,
+                                  long resourceID, char transform[],
+                                  short *errorOccurred, long *errorCode,
+                                  char errorMessage[]);
+
+void __stdcall tsadj_SetHysteresis (CAObjHandle sequenceContext,
+                                   long resourceID, double hysteresis,
+                                   short *errorOccurred, long *errorCode,
+                                   char errorMessage[]);
+
+void __stdcall tsadj_AbortAdjustmentPanel (CAObjHandle sequenceContext,
+                                          long resourceID, short *errorOccurred,
+                                          long *errorCode,
+                                          char errorMessage[]);
+
+void __stdcall tsadj_SetAdjustmentGroup (CAObjHandle sequenceContext,
+                                        long resourceID, char groupName[],
+                                        long members, short *errorOccurred,
+                                        long *errorCode,
+                                        char errorMessage[]);
+
+void __stdcall tsadj_WaitForAdjustmentGroup (CAObjHandle sequenceContext,
+                                            long resourceID, long timeout,
+                                            short *allConfirmed,
+                                            short *errorOccurred,
+                                            long *errorCode,
+                                            char errorMessage[]);
+
+void __stdcall tsadj_PublishAdjustmentResult (CAObjHandle sequenceContext,
+                                             long resourceID,
+                                             char propertyName[],
+                                             short atHide,
+                                             short *errorOccurred,
+                                             long *errorCode,
+                                             char errorMessage[]);
+
+void __stdcall tsadj_GetAdjustmentStatistics (CAObjHandle sequenceContext,
+                                             long resourceID, char nameOfStep[],
+                                             char propertyName[],
+                                             short *errorOccurred,
+                                             long *errorCode,
+                                             char errorMessage[]);
+
+void __stdcall tsadj_GetInstrumentationCounters (CAObjHandle sequenceContext,
+                                                long resourceID,
+                                                char propertyName[],
+                                                short resetCounters,
+                                                short *errorOccurred,
+                                                long *errorCode,
+                                                char errorMessage[]);
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/
@@ -0,0 +1,123 @@
+/*******************************************************************************/
+/**
+@file tsadjc.h
+*
+@brief Exported functions for test executors without TestStand
+*
+The tsadjc_xxx functions take the resource ID of tsadjc_Setup and plain
+arguments, no TestStand sequence context. They run the same code as the
+tsadj_xxx functions of tsadj.h with a sequence context of 0 for the resource
+manager and use the same benches and INI files. No ActiveX call is made, the button is
+reported by the callback of tsadjc_SetButtonCallback instead of
+Locals.AdjustmentPanelButtonHit. Termination checks of the execution are
+not done; tsadjc_Abort ends the waits of Display and Hide.
+This header needs no CVI or TestStand header. The function panels are in
+tsadjc.fp, except for tsadjc_SetButtonCallback.
+*
+language: ANSI-C ISO/IEC9899:1990
+*
+******************************************************************************
+*****************************************************************************/
+#ifndef TSADJC_H
+#define TSADJC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* GLOBAL CONSTANT DECLARATIONS ***********************************************/
+
+/* What became of a value, tsadjc_SetValueEx and
+   tsadj_SetValueAdjustmentPanelEx */
+#define TSADJ_SAMPLE_UNCHANGED  0   /* the panel already shows it            */
+#define TSADJ_SAMPLE_SHOWN      1   /* queued for the panel                  */
+#define TSADJ_SAMPLE_PENDING    2   /* shown with the panel if still the last */
+#define TSADJ_SAMPLE_DROPPED    3   /* not shown, the queue is full          */
+
+/* GLOBAL TYPE DECLARATIONS ***************************************************/
+
+/* Called once per panel when the button is pressed: for a local panel in
+   the panel thread, for a panel server bench in the thread of the SetValue
+   or Hide call that gets the button. It must return at once. */
+typedef void (__stdcall *TSADJC_BUTTON_CALLBACK)(long resourceID,
+   void *userData);
+
+/* EXPORTED FUNCTIONS *********************************************************/
+
+void __stdcall tsadjc_Setup (char benchName[], long *resourceID,
+                            short *errorOccurred, long *errorCode,
+                            char errorMessage[]);
+
+void __stdcall tsadjc_Cleanup (long resourceID, short *errorOccurred,
+                              long *errorCode, char errorMessage[]);
+
+void __stdcall tsadjc_Display (long resourceID, char nameOfStep[],
+                              char buttonText[], char unit[], char format[],
+                              double lowerLimit, double upperLimit,
+                              short *errorOccurred, long *errorCode,
+                              char errorMessage[]);
+
+void __stdcall tsadjc_DisplayAsync (long resourceID, char nameOfStep[],
+                                   char buttonText[], char unit[],
+                                   char format[], double lowerLimit,
+                                   double upperLimit, short *errorOccurred,
+                                   long *errorCode, char errorMessage[]);
+
+void __stdcall tsadjc_WaitForPanel (long resourceID, long timeout,
+                                   short *errorOccurred, long *errorCode,
+                                   char errorMessage[]);
+
+void __stdcall tsadjc_SetValue (long resourceID, double value,
+                               short *errorOccurred, long *errorCode,
+                               char errorMessage[]);
+
+void __stdcall tsadjc_SetValueEx (long resourceID, double value,
+                                 short *rendered, double *refreshRate,
+                                 double *minInterval, short *errorOccurred,
+                                 long *errorCode, char errorMessage[]);
+
+void __stdcall tsadjc_SetValues (long resourceID, double values[],
+                                long count, short *errorOccurred,
+                                long *errorCode, char errorMessage[]);
+
+void __stdcall tsadjc_Hide (long resourceID, short *errorOccurred,
+                           long *errorCode, char errorMessage[]);
+
+void __stdcall tsadjc_SetFilter (long resourceID, long filterType,
+                                long window, short *errorOccurred,
+                                long *errorCode, char errorMessage[]);
+
+void __stdcall tsadjc_SetTransform (long resourceID, char transform[],
+                                   short *errorOccurred, long *errorCode,
+                                   char errorMessage[]);
+
+void __stdcall tsadjc_SetHysteresis (long resourceID, double hysteresis,
+                                    short *errorOccurred, long *errorCode,
+                                    char errorMessage[]);
+
+void __stdcall tsadjc_SetButtonCallback (long resourceID,
+                                        TSADJC_BUTTON_CALLBACK callback,
+                                        void *userData,
+                                        short *errorOccurred,
+                                        long *errorCode,
+                                        char errorMessage[]);
+
+void __stdcall tsadjc_Abort (long resourceID, short *errorOccurred,
+                            long *errorCode, char errorMessage[]);
+
+void __stdcall tsadjc_SetGroup (long resourceID, char groupName[],
+                               long members, short *errorOccurred,
+                               long *errorCode, char errorMessage[]);
+
+void __stdcall tsadjc_WaitForGroup (long resourceID, long timeout,
+                                   short *allConfirmed, short *errorOccurred,
+                                   long *errorCode, char errorMessage[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   /* do not add code after this line */
+/******************************************************************************/
+/* END OF FILE                                                                */
+/******************************************************************************/